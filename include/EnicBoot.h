@@ -0,0 +1,83 @@
+/**
+ * @file EnicBoot.h
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Staged boot phase timestamps: time-to-first-frame / time-to-control-ready over serial
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ *
+ * Açılış sırası (main.cpp + EnicTasks):
+ *   core 1 setup : motorlar güvende -> UART -> io task'ı başlar -> sense / FSM / params -> diğer task'lar
+ *   core 0 io    : I2C + SSD1306 init ve tek tam kare flush (setup ile paralel)
+ *   core 0 log   : LittleFS bağlama + log kurtarma (kayıtlar bu arada halkada bekler)
+ *   core 1 sense : sonar ısınması, medyan penceresi dolana kadar en kısa aralıkla ping
+ * Her faz bir kez, kendi task'ından damgalanır (µs, micros() = esp_timer: reset'ten beri, ROM +
+ * bootloader sonrası). Hepsi gelince io task'ı tek JSON satırı basar; "boot" komutu tekrar basar.
+ */
+#ifndef ENIC_BOOT_H
+#define ENIC_BOOT_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "EnicTime.h"
+#include "EnicMem.h"
+
+enum BootPhase : uint8_t {
+  BOOT_SETUP,           // setup() girişi
+  BOOT_MOTORS_SAFE,     // LEDC kanalları 0 duty'de
+  BOOT_SERIAL,          // UART açık
+  BOOT_CORE_READY,      // setup sonu: FSM + params uygulandı, kalan task'lar başlıyor
+  BOOT_FIRST_FRAME,     // ilk kare panelde (io task, core 0)
+  BOOT_CONTROL_READY,   // kontrol task'ının ilk tick'i: komut kabul eder, motor sürer
+  BOOT_RANGE_READY,     // sonar ısındı: medyan dolu, takipçi oturdu (ya da echo yok)
+  BOOT_LOG_READY,       // uçuş kaydı flash'a yazabiliyor (log task)
+  BOOT_PHASE_COUNT
+};
+
+static const char* const BOOT_PHASE_NAMES[BOOT_PHASE_COUNT] = {
+  "setup", "motors_safe", "serial", "core_ready", "first_frame", "control_ready", "range_ready", "log_ready",
+};
+
+class EnicBoot {
+private:
+  std::atomic<uint32_t> at[BOOT_PHASE_COUNT];   // 0: henüz değil
+  std::atomic<uint8_t> done{0};
+  std::atomic<bool> reported{false};
+
+public:
+  EnicBoot() {
+    for (int i = 0; i < BOOT_PHASE_COUNT; i++) at[i].store(0);
+  }
+
+  // İlk çağrı damgalar; sonrakiler sadece bir atomik okuma (her task turunda çağrılabilir)
+  void mark(BootPhase p) {
+    if (at[p].load(std::memory_order_relaxed)) return;
+    uint32_t t = nowUs32();
+    uint32_t expected = 0;
+    if (at[p].compare_exchange_strong(expected, t ? t : 1)) done.fetch_add(1);
+  }
+
+  uint32_t get(BootPhase p) const { return at[p].load(); }
+  bool complete() const { return done.load() == BOOT_PHASE_COUNT; }
+
+  // Tüm fazlar geldiyse bir kez true (io task'ı raporu basar)
+  bool takeReport() {
+    if (!complete() || reported.load(std::memory_order_relaxed)) return false;
+    return !reported.exchange(true);
+  }
+
+  void printReport(Print& out) const {
+    out.print("{\"boot\":{");
+    for (int i = 0; i < BOOT_PHASE_COUNT; i++) {
+      uint32_t t = at[i].load();
+      if (t) enicPrintf(out, "%s\"%s_us\":%lu", i ? "," : "", BOOT_PHASE_NAMES[i], (unsigned long)t);
+      else enicPrintf(out, "%s\"%s_us\":null", i ? "," : "", BOOT_PHASE_NAMES[i]);
+    }
+    uint32_t s = at[BOOT_SETUP].load();
+    uint32_t frame = at[BOOT_FIRST_FRAME].load(), control = at[BOOT_CONTROL_READY].load();
+    enicPrintf(out, "},\"first_frame_ms\":%.1f,\"control_ready_ms\":%.1f,\"setup_to_control_ms\":%.1f}\n",
+                    frame / 1000.0, control / 1000.0, control && s ? (control - s) / 1000.0 : 0.0);
+  }
+};
+
+#endif
@@ -0,0 +1,209 @@
+/**
+ * @file EnicCommand.h
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Heap-free serial line reader, tokenizer and perfect-hash command lookup
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ */
+#ifndef ENIC_COMMAND_H
+#define ENIC_COMMAND_H
+
+#include <Arduino.h>
+
+static const int CMD_LINE_MAX = 96;    // set {"ad":değer,...} için
+static const int CMD_MAX_ARGS = 3;
+static const uint8_t CMD_ARGS_TEXT = 0xFF;   // maxArgs: satırın kalanı tek metin (get / set)
+
+enum CommandId : uint8_t {
+  CMD_DUR, CMD_OTONOM, CMD_GEZ, CMD_DANS, CMD_BOMB,
+  CMD_KONUS, CMD_DINLE, CMD_SASIR, CMD_KORK, CMD_AGLA, CMD_DIL,
+  CMD_ILERI, CMD_GERI, CMD_SOL, CMD_SAG,
+  CMD_PING, CMD_GOV, CMD_OLED, CMD_STATS, CMD_QUEUES, CMD_LOG, CMD_SCHED, CMD_PWR,
+  CMD_GET, CMD_SET, CMD_DUMP, CMD_BOOT, CMD_MEM,
+  CMD_COUNT
+};
+
+struct CommandDef {
+  const char* name;
+  CommandId id;
+  uint8_t minArgs;
+  uint8_t maxArgs;
+};
+
+// Sıra CommandId ile aynı olmalı (static_assert ile kontrol)
+inline constexpr CommandDef COMMANDS[CMD_COUNT] = {
+  {"dur",    CMD_DUR,    0, 0},
+  {"otonom", CMD_OTONOM, 0, 0},
+  {"gez",    CMD_GEZ,    0, 0},
+  {"dans",   CMD_DANS,   0, 0},
+  {"bomb",   CMD_BOMB,   0, 0},
+  {"konus",  CMD_KONUS,  0, 0},
+  {"dinle",  CMD_DINLE,  0, 0},
+  {"sasir",  CMD_SASIR,  0, 0},
+  {"kork",   CMD_KORK,   0, 0},
+  {"agla",   CMD_AGLA,   0, 0},
+  {"dil",    CMD_DIL,    0, 0},
+  {"ileri",  CMD_ILERI,  0, 2},  // [hız] [süre ms]
+  {"geri",   CMD_GERI,   0, 2},
+  {"sol",    CMD_SOL,    0, 2},
+  {"sag",    CMD_SAG,    0, 2},
+  {"ping",   CMD_PING,   1, 1},  // <aralık ms>
+  {"gov",    CMD_GOV,    0, 2},  // [parametre no] [değer]
+  {"oled",   CMD_OLED,   0, 0},
+  {"stats",  CMD_STATS,  0, 0},
+  {"queues", CMD_QUEUES, 0, 0},
+  {"log",    CMD_LOG,    0, 1},  // [1: döküm, 2: sil]
+  {"sched",  CMD_SCHED,  0, 0},
+  {"pwr",    CMD_PWR,    0, 1},  // [0: kapalı, 1: açık]
+  {"get",    CMD_GET,    0, CMD_ARGS_TEXT},  // [ad | önek]
+  {"set",    CMD_SET,    0, CMD_ARGS_TEXT},  // <ad> <değer> | {json} | defaults
+  {"dump",   CMD_DUMP,   0, 0},
+  {"boot",   CMD_BOOT,   0, 0},
+  {"mem",    CMD_MEM,    0, 0},
+};
+
+// ---------------- Perfect hash ----------------
+// FNV-1a(seed) & (SLOTS-1); seed derleme zamanında çakışmasız olacak şekilde aranır.
+static const int CMD_HASH_SLOTS = 128;
+
+constexpr uint32_t cmdHash(const char* s, uint32_t seed) {
+  uint32_t h = 2166136261UL ^ seed;
+  while (*s) { h ^= (uint8_t)*s++; h *= 16777619UL; }
+  return h;
+}
+
+constexpr bool cmdSeedIsPerfect(uint32_t seed) {
+  bool used[CMD_HASH_SLOTS] = {};
+  for (int i = 0; i < CMD_COUNT; i++) {
+    uint32_t slot = cmdHash(COMMANDS[i].name, seed) & (CMD_HASH_SLOTS - 1);
+    if (used[slot]) return false;
+    used[slot] = true;
+  }
+  return true;
+}
+
+constexpr uint32_t cmdFindSeed() {
+  for (uint32_t seed = 1; seed < 4096; seed++) {
+    if (cmdSeedIsPerfect(seed)) return seed;
+  }
+  return 0;
+}
+
+struct CommandSlots {
+  int8_t at[CMD_HASH_SLOTS];
+};
+
+constexpr CommandSlots cmdBuildSlots(uint32_t seed) {
+  CommandSlots t = {};
+  for (int i = 0; i < CMD_HASH_SLOTS; i++) t.at[i] = -1;
+  for (int i = 0; i < CMD_COUNT; i++) {
+    t.at[cmdHash(COMMANDS[i].name, seed) & (CMD_HASH_SLOTS - 1)] = (int8_t)i;
+  }
+  return t;
+}
+
+constexpr bool cmdTableInOrder() {
+  for (int i = 0; i < CMD_COUNT; i++) if (COMMANDS[i].id != i) return false;
+  return true;
+}
+
+inline constexpr uint32_t CMD_HASH_SEED = cmdFindSeed();
+inline constexpr CommandSlots CMD_SLOTS = cmdBuildSlots(CMD_HASH_SEED);
+
+static_assert(cmdTableInOrder(), "COMMANDS must follow CommandId order");
+static_assert(CMD_HASH_SEED != 0, "no collision-free seed for the command table");
+
+// ---------------- Parsed command ----------------
+struct ParsedCommand {
+  CommandId id;
+  uint8_t argc;
+  long argv[CMD_MAX_ARGS];
+  char* text;          // CMD_ARGS_TEXT komutlarında satırın kalanı (boş olabilir), diğerlerinde nullptr
+};
+
+// Tek kelime -> CommandId (bilinmiyorsa false). Bir hash + bir strcmp.
+inline bool lookupCommand(const char* word, CommandId& out) {
+  int8_t i = CMD_SLOTS.at[cmdHash(word, CMD_HASH_SEED) & (CMD_HASH_SLOTS - 1)];
+  if (i < 0 || strcmp(COMMANDS[i].name, word) != 0) return false;
+  out = (CommandId)i;
+  return true;
+}
+
+inline bool cmdIsSpace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+// Satırı yerinde böler: ilk kelime küçük harfe çevrilir, kalanlar tam sayı argüman
+// (CMD_ARGS_TEXT komutlarında kalan metin olduğu gibi, baş/son boşluk kırpılmış).
+// Boş satır, bilinmeyen komut veya hatalı/eksik argümanda false.
+inline bool parseCommand(char* line, ParsedCommand& cmd) {
+  char* p = line;
+  while (cmdIsSpace(*p)) p++;
+  if (!*p) return false;
+
+  char* word = p;
+  while (*p && !cmdIsSpace(*p)) p++;
+  if (*p) *p++ = '\0';
+  for (char* c = word; *c; c++) *c = (char)tolower((unsigned char)*c);
+  if (!lookupCommand(word, cmd.id)) return false;
+
+  const CommandDef& def = COMMANDS[cmd.id];
+  cmd.text = nullptr;
+  if (def.maxArgs == CMD_ARGS_TEXT) {
+    while (cmdIsSpace(*p)) p++;
+    char* end = p + strlen(p);
+    while (end > p && cmdIsSpace(end[-1])) *--end = '\0';
+    cmd.argc = 0;
+    cmd.text = p;
+    return true;
+  }
+
+  char* tok[CMD_MAX_ARGS];
+  int argc = 0;
+  for (;;) {
+    while (cmdIsSpace(*p)) *p++ = '\0';
+    if (!*p) break;
+    if (argc == CMD_MAX_ARGS) return false;   // fazla argüman
+    tok[argc++] = p;
+    while (*p && !cmdIsSpace(*p)) p++;
+  }
+  if (argc < def.minArgs || argc > def.maxArgs) return false;
+
+  cmd.argc = (uint8_t)argc;
+  for (int i = 0; i < argc; i++) {
+    char* end = nullptr;
+    cmd.argv[i] = strtol(tok[i], &end, 10);
+    if (end == tok[i] || *end != '\0') return false;
+  }
+  return true;
+}
+
+// ---------------- Line reader ----------------
+// Sabit tamponlu satır okuyucu; taşan satır sonuna kadar atılır.
+class EnicLineReader {
+private:
+  char buf[CMD_LINE_MAX + 1];
+  uint8_t len = 0;
+  bool overflow = false;
+
+public:
+  // Satır tamamlandıysa true; satır line() ile alınır (bir sonraki feed'e kadar geçerli)
+  bool feed(char c) {
+    if (c == '\r') return false;
+
+    if (c == '\n') {
+      bool ok = !overflow && len > 0;
+      buf[len] = '\0';
+      len = 0;
+      overflow = false;
+      return ok;
+    }
+
+    if (len < CMD_LINE_MAX) buf[len++] = c;
+    else overflow = true;
+    return false;
+  }
+
+  char* line() { return buf; }
+};
+
+#endif
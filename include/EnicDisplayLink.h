@@ -0,0 +1,289 @@
+/**
+ * @file EnicDisplayLink.h
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Asynchronous SSD1306 frame transport (core 0 flush task, dirty windows)
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ */
+#ifndef ENIC_DISPLAY_LINK_H
+#define ENIC_DISPLAY_LINK_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#include "EnicFaceAtlas.h"
+#include "EnicMem.h"
+#include "EnicTime.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include "driver/i2c.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#endif
+
+#define OLED_ADDR 0x3C
+#define OLED_SDA_PIN 21
+#define OLED_SCL_PIN 22
+
+// Fast-mode plus; zayıf pull-up'lı modüllerde 400000 ile derleyin
+#ifndef ENIC_OLED_I2C_HZ
+#define ENIC_OLED_I2C_HZ 1000000UL
+#endif
+
+static const uint8_t  OLED_FLUSH_CORE = 0;
+static const uint8_t  OLED_FLUSH_PRIO = 2;
+static const uint32_t OLED_FLUSH_STACK = 3072;
+
+class EnicDisplayLink {
+public:
+  static const int FRAME_BYTES = SCREEN_WIDTH * OLED_PAGES;
+
+  struct FlushStats {
+    uint32_t submitted = 0;     // loop'tan gelen frame
+    uint32_t replaced = 0;      // gönderilmeden yenisiyle ezilen frame
+    uint32_t flushes = 0;       // panele giden frame
+    uint32_t windows = 0;
+    uint32_t bytesSent = 0;     // toplam I2C byte (adres + kontrol + komut + data)
+    uint32_t lastBytes = 0;
+    uint32_t lastFlushUs = 0;
+    uint32_t maxFlushUs = 0;
+    uint64_t totalFlushUs = 0;
+    uint32_t errors = 0;
+  };
+
+private:
+  // Üçlü tampon: back (loop yazar), pending (en yeni tam frame), front (task gönderir)
+  uint8_t frames[3][FRAME_BYTES];
+  uint8_t backIdx = 0, pendingIdx = 1, frontIdx = 2;
+  volatile bool pendingReady = false;
+
+  // Panelde şu an olan içerik; sadece değişen page/kolon pencereleri gider
+  uint8_t shadow[FRAME_BYTES];
+  bool shadowValid = false;
+
+  // Yeni pencere ~14 byte ek maliyet; daha kısa boşluklar birleştirilir
+  static const int WINDOW_MERGE_GAP = 12;
+
+  // submit() (kontrol / io task'ı), flush task'ı (core 0) ve stats / resetStats (diğer task'lar)
+  // hepsi mux altında; flush task'ı frame sayaçlarını yerelde toplar, sonda tek seferde yazar
+  FlushStats stats;
+  uint32_t frameBytes = 0;   // flush task'ı: gönderilmekte olan frame'in I2C byte'ları
+
+  // Pencere başlığı: Co=1 komut çiftleri (her komut byte'ı önünde 0x80), ardından 0x40 + GDDRAM data
+  static const int WINDOW_HEAD_BYTES = 13;
+  static void windowHead(uint8_t* h, uint8_t page, int c0, int c1) {
+    const uint8_t head[WINDOW_HEAD_BYTES] = {
+      0x80, 0x21, 0x80, (uint8_t)c0, 0x80, (uint8_t)c1,   // COLUMNADDR
+      0x80, 0x22, 0x80, page,        0x80, page,          // PAGEADDR
+      0x40                                                // data akışı
+    };
+    memcpy(h, head, sizeof(head));
+  }
+
+#if defined(ARDUINO_ARCH_ESP32)
+  static const i2c_port_t OLED_I2C_PORT = I2C_NUM_0;
+
+  mutable portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+  void lock() const   { portENTER_CRITICAL(&mux); }
+  void unlock() const { portEXIT_CRITICAL(&mux); }
+
+  TaskHandle_t task = nullptr;
+  bool started = false;
+  StaticTask_t tcb;
+  StackType_t stack[OLED_FLUSH_STACK];
+
+  // Tek transaction: başlık + pencerenin tüm data'sı (IDF sürücüsünde tampon sınırı yok)
+  uint8_t txBuf[WINDOW_HEAD_BYTES + SCREEN_WIDTH];
+
+  bool sendWindow(uint8_t page, int c0, int c1, const uint8_t* row) {
+    int n = c1 - c0 + 1;
+    windowHead(txBuf, page, c0, c1);
+    memcpy(txBuf + WINDOW_HEAD_BYTES, row + c0, (size_t)n);
+
+    esp_err_t err = i2c_master_write_to_device(OLED_I2C_PORT, OLED_ADDR, txBuf,
+                                               WINDOW_HEAD_BYTES + (size_t)n, pdMS_TO_TICKS(20));
+    frameBytes += 1 + WINDOW_HEAD_BYTES + (uint32_t)n;
+    return err == ESP_OK;
+  }
+
+  static void flushTaskEntry(void* arg) {
+    EnicDisplayLink* self = (EnicDisplayLink*)arg;
+    for (;;) {
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+      bool have = false;
+      self->lock();
+      if (self->pendingReady) {
+        uint8_t t = self->frontIdx; self->frontIdx = self->pendingIdx; self->pendingIdx = t;
+        self->pendingReady = false;
+        have = true;
+      }
+      self->unlock();
+
+      if (have) self->flushFrame(self->frames[self->frontIdx]);
+    }
+  }
+#else
+  // Host / RTOS'suz derleme: Wire üzerinden senkron gönderim, tek iş parçacığı
+  void lock() const {}
+  void unlock() const {}
+
+  // Wire tamponu (I2C_BUFFER_LENGTH) sınırlı: ilk transaction başlık + data, devamı 0x40 + data
+  // (GDDRAM adresi pencere içinde kendiliğinden ilerler). Byte sayımı ESP yoluyla aynı: 1 + başlık + n
+  bool sendWindow(uint8_t page, int c0, int c1, const uint8_t* row) {
+    uint8_t head[WINDOW_HEAD_BYTES];
+    windowHead(head, page, c0, c1);
+    const uint8_t* hdr = head;
+    size_t hdrLen = WINDOW_HEAD_BYTES;
+    bool ok = true;
+
+    for (int c = c0; c <= c1; ) {
+      int n = c1 - c + 1;
+      int room = I2C_BUFFER_LENGTH - (int)hdrLen;
+      if (n > room) n = room;
+      Wire.beginTransmission(OLED_ADDR);
+      Wire.write(hdr, hdrLen);
+      Wire.write(row + c, (size_t)n);
+      if (Wire.endTransmission() != 0) ok = false;
+      frameBytes += 1 + (uint32_t)hdrLen + (uint32_t)n;
+      c += n;
+      hdr = head + WINDOW_HEAD_BYTES - 1;   // sadece 0x40
+      hdrLen = 1;
+    }
+    return ok;
+  }
+#endif
+
+  // shadow ile page page karşılaştır, değişen kolon aralıklarını
+  // SSD1306 column/page adreslemesiyle gönder
+  void flushFrame(const uint8_t* buf) {
+    uint32_t t0 = nowUs32();
+    frameBytes = 0;
+    uint32_t windows = 0;
+    bool ok = true;
+
+    for (uint8_t page = 0; page < OLED_PAGES; page++) {
+      const uint8_t* row = buf + page * SCREEN_WIDTH;
+      uint8_t* srow = shadow + page * SCREEN_WIDTH;
+
+      int col = 0;
+      while (col < SCREEN_WIDTH) {
+        if (shadowValid && row[col] == srow[col]) { col++; continue; }
+
+        int start = col, end = col, gap = 0;
+        for (col = col + 1; col < SCREEN_WIDTH; col++) {
+          if (!shadowValid || row[col] != srow[col]) { end = col; gap = 0; }
+          else if (++gap > WINDOW_MERGE_GAP) break;
+        }
+
+        if (!sendWindow(page, start, end, row)) ok = false;
+        windows++;
+        memcpy(srow + start, row + start, (size_t)(end - start + 1));
+        col = end + 1;
+      }
+    }
+
+    // Hata olduysa panel içeriği belirsiz -> sonraki frame tam gönderilsin
+    shadowValid = ok;
+
+    uint32_t dt = nowUs32() - t0;
+    lock();
+    if (!ok) stats.errors++;
+    stats.flushes++;
+    stats.windows += windows;
+    stats.bytesSent += frameBytes;
+    stats.lastBytes = frameBytes;
+    stats.lastFlushUs = dt;
+    stats.totalFlushUs += dt;
+    if (dt > stats.maxFlushUs) stats.maxFlushUs = dt;
+    unlock();
+  }
+
+public:
+  // display.begin() (Wire ile init dizisi) sonrasında çağrılır
+  void begin() {
+    shadowValid = false;
+#if defined(ARDUINO_ARCH_ESP32)
+    // Bus'ı Arduino Wire'dan alıp IDF master sürücüsüne veriyoruz
+    Wire.end();
+
+    i2c_config_t conf = {};
+    conf.mode = I2C_MODE_MASTER;
+    conf.sda_io_num = OLED_SDA_PIN;
+    conf.scl_io_num = OLED_SCL_PIN;
+    conf.sda_pullup_en = GPIO_PULLUP_ENABLE;
+    conf.scl_pullup_en = GPIO_PULLUP_ENABLE;
+    conf.master.clk_speed = ENIC_OLED_I2C_HZ;
+    if (i2c_param_config(OLED_I2C_PORT, &conf) != ESP_OK ||
+        i2c_driver_install(OLED_I2C_PORT, I2C_MODE_MASTER, 0, 0, 0) != ESP_OK) {
+      Serial.println("OLED I2C driver init failed!");
+      return;
+    }
+
+    task = xTaskCreateStaticPinnedToCore(flushTaskEntry, "oled", OLED_FLUSH_STACK, this,
+                                         OLED_FLUSH_PRIO, stack, &tcb, OLED_FLUSH_CORE);
+    if (!task) {
+      Serial.println("OLED flush task failed!");
+      return;
+    }
+    EnicMem::addStack("oled", task, OLED_FLUSH_STACK);
+    started = true;
+#endif
+  }
+
+  // Panel içeriği bilinmiyor -> sonraki frame tam gönderilir
+  void invalidate() { shadowValid = false; }
+
+  // Loop tarafı: asla bloklamaz. Bekleyen frame varsa yenisiyle değiştirilir.
+  void submit(const uint8_t* fb) {
+#if defined(ARDUINO_ARCH_ESP32)
+    if (!started) { lock(); stats.submitted++; unlock(); return; }
+
+    memcpy(frames[backIdx], fb, FRAME_BYTES);
+
+    lock();
+    stats.submitted++;
+    uint8_t t = pendingIdx; pendingIdx = backIdx; backIdx = t;
+    if (pendingReady) stats.replaced++;
+    pendingReady = true;
+    unlock();
+
+    xTaskNotifyGive(task);
+#else
+    stats.submitted++;
+    flushFrame(fb);
+#endif
+  }
+
+  // Tutarlı kopya (flush task'ı 64 bit toplamı yazarken yarım okunmaz)
+  FlushStats getStats() const {
+    lock();
+    FlushStats s = stats;
+    unlock();
+    return s;
+  }
+
+  void resetStats() {
+    lock();
+    stats = FlushStats();
+    unlock();
+  }
+
+  void printStats(Print& out) const {
+    const FlushStats st = getStats();
+    out.print("oled submitted="); out.print(st.submitted);
+    out.print(" replaced=");      out.print(st.replaced);
+    out.print(" flushes=");       out.print(st.flushes);
+    out.print(" windows=");       out.print(st.windows);
+    out.print(" bytes=");         out.print(st.bytesSent);
+    out.print(" last_bytes=");    out.print(st.lastBytes);
+    out.print(" last_us=");       out.print(st.lastFlushUs);
+    out.print(" max_us=");        out.print(st.maxFlushUs);
+    out.print(" avg_us=");
+    out.print(st.flushes ? (unsigned long)(st.totalFlushUs / st.flushes) : 0UL);
+    out.print(" errors=");        out.println(st.errors);
+  }
+};
+
+#endif
@@ -0,0 +1,114 @@
+/**
+ * @file EnicEncoder.h
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Quadrature wheel encoder on the ESP32 PCNT peripheral + windowed velocity estimate
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ */
+#ifndef ENIC_ENCODER_H
+#define ENIC_ENCODER_H
+
+#include <Arduino.h>
+#if defined(ARDUINO_ARCH_ESP32)
+#include "driver/pcnt.h"
+#endif
+
+// Enkoder donanımı takılı mı (platformio.ini: -D ENIC_ENCODERS=1)
+#ifndef ENIC_ENCODERS
+#define ENIC_ENCODERS 0
+#endif
+
+#define ENC_L_A 34
+#define ENC_L_B 35
+#define ENC_R_A 32
+#define ENC_R_B 33
+
+// duty 255 <-> bu hız (count/s); kapalı çevrimde drive() hedefi hız olarak yorumlanır
+#ifndef ENC_CPS_AT_FULL
+#define ENC_CPS_AT_FULL 2000.0f
+#endif
+
+static const uint8_t ENC_WINDOW = 20;   // hız penceresi (tick) -> 1 kHz'de 20 ms
+
+class EnicEncoder {
+private:
+  uint8_t unit = 0;
+  int32_t total = 0;
+
+  int32_t window[ENC_WINDOW] = {};
+  uint8_t head = 0;
+  uint8_t filled = 0;
+  float cps = 0.0f;
+
+#if defined(ARDUINO_ARCH_ESP32)
+  int16_t lastRaw = 0;
+
+  int32_t readTotal() {
+    int16_t raw = 0;
+    pcnt_get_counter_value((pcnt_unit_t)unit, &raw);
+    total += (int16_t)(raw - lastRaw);
+    lastRaw = raw;
+    // Donanım sayacı ±32767'de sıfırlanır; yarıya gelmeden temizle (okuma ile temizleme arası <1 sayım)
+    if (raw > 16384 || raw < -16384) {
+      pcnt_counter_clear((pcnt_unit_t)unit);
+      lastRaw = 0;
+    }
+    return total;
+  }
+#else
+  // Host: tekerlek modeli (lib/EnicHost MotorPlant)
+  int32_t readTotal() {
+    total = (int32_t)hostBoard().wheel[unit].counts;
+    return total;
+  }
+#endif
+
+public:
+  void begin(uint8_t pcntUnit, uint8_t pinA, uint8_t pinB) {
+    unit = pcntUnit;
+#if defined(ARDUINO_ARCH_ESP32)
+    pcnt_config_t cfg = {};
+    cfg.pulse_gpio_num = pinA;
+    cfg.ctrl_gpio_num = pinB;
+    cfg.channel = PCNT_CHANNEL_0;
+    cfg.unit = (pcnt_unit_t)unit;
+    cfg.pos_mode = PCNT_COUNT_INC;       // A yükselen: +1
+    cfg.neg_mode = PCNT_COUNT_DEC;       // A düşen: -1  (x2 çözünürlük)
+    cfg.lctrl_mode = PCNT_MODE_REVERSE;  // B düşükken yön ters
+    cfg.hctrl_mode = PCNT_MODE_KEEP;
+    cfg.counter_h_lim = 32767;
+    cfg.counter_l_lim = -32768;
+    pcnt_unit_config(&cfg);
+
+    pcnt_set_filter_value((pcnt_unit_t)unit, 100);   // APB tick (~1.25 µs) altı glitch'leri at
+    pcnt_filter_enable((pcnt_unit_t)unit);
+
+    pcnt_counter_pause((pcnt_unit_t)unit);
+    pcnt_counter_clear((pcnt_unit_t)unit);
+    pcnt_counter_resume((pcnt_unit_t)unit);
+#else
+    (void)pinA; (void)pinB;
+#endif
+    int32_t c = readTotal();
+    for (uint8_t i = 0; i < ENC_WINDOW; i++) window[i] = c;
+    head = 0;
+    filled = 0;
+    cps = 0.0f;
+  }
+
+  // Sabit periyotlu tick'ten çağrılır: sayımı oku, pencere hızını güncelle
+  void sample(uint32_t tickUs) {
+    int32_t c = readTotal();
+    int32_t oldest = window[head];
+    window[head] = c;
+    head = (uint8_t)((head + 1) % ENC_WINDOW);
+    if (filled < ENC_WINDOW) filled++;
+    cps = (float)(c - oldest) * 1e6f / ((float)filled * (float)tickUs);
+  }
+
+  float getCps() const { return cps; }
+  int32_t getCount() const { return total; }
+};
+
+#endif
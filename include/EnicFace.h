@@ -14,36 +14,99 @@
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
 
-#define SCREEN_WIDTH 128
-#define SCREEN_HEIGHT 64
-
-// Yüz tipleri
-enum FaceType {
-  NORMAL,
-  BLINK,
-  DEAD,
-  TONGUE,
-  LISTEN,
-  SPEAK,
-  SHOCK,
-  SNEAKY,
-  CRY,
-  FEAR
+#include "EnicFaceAtlas.h"
+#include "EnicDisplayLink.h"
+#include "EnicProfile.h"
+#include "EnicQueue.h"
+#include "EnicTime.h"
+
+// Compositor hedef kare hızı; flush (I2C) + çizim bir slotu aşarsa slot uzar
+#ifndef ENIC_FACE_FPS
+#define ENIC_FACE_FPS 30
+#endif
+
+static const uint32_t FACE_SLOT_MAX_US = 200000;   // aşırı yükte en fazla 5 FPS'e iner
+
+// Adafruit_SSD1306::begin() tamponu yoksa malloc eder; burada nesnenin içinde statik durur.
+// Taban sınıfın yıkıcısı free etmesin diye tampon yıkımda geri alınır.
+class EnicPanel : public Adafruit_SSD1306 {
+private:
+  uint8_t fb[SCREEN_WIDTH * ((SCREEN_HEIGHT + 7) / 8)];
+
+public:
+  EnicPanel(uint8_t w, uint8_t h, TwoWire* twi, int8_t rst, uint32_t clkDuring, uint32_t clkAfter)
+    : Adafruit_SSD1306(w, h, twi, rst, clkDuring, clkAfter) {
+    memset(fb, 0, sizeof(fb));
+    buffer = fb;
+  }
+  ~EnicPanel() { buffer = nullptr; }
+
+  EnicPanel(const EnicPanel&) = delete;
+  EnicPanel& operator=(const EnicPanel&) = delete;
+};
+
+// Kontrol -> render task: çizim isteği (sahne + parametreleri)
+struct DrawRequest {
+  enum Kind : uint8_t { FACE, DANCE, BOMB } kind;
+  uint8_t a;            // FACE: FaceType, DANCE: frame, BOMB: phase
+  uint8_t b;            // BOMB: progress
+  uint32_t t;           // BOMB: elapsedMs
 };
 
+// draw*/updateIdle() kontrol tarafında sadece istek kuyruğa atar (µs mertebesi);
+// GFX çizimi render() içinde, render task'ında yapılır.
+// render() compositor'dır: slot içindeki istekler birleşir, son istek kazanır, slot başına en fazla bir kare.
 class EnicFace {
+public:
+  struct FrameStats {
+    uint32_t requested = 0;   // kuyruktan gelen çizim isteği
+    uint32_t merged = 0;      // gösterilmeden yenisiyle ezilen istek
+    uint32_t presented = 0;   // çizilip panele verilen kare
+    uint32_t slotUs = 0;      // güncel slot (adaptif)
+    uint32_t maxSlotUs = 0;
+    uint32_t lastRenderUs = 0;
+  };
+
 private:
-  Adafruit_SSD1306 display;
+  EnicPanel display;
 
   // ---------------- IDLE: Base expression timing ----------------
   FaceType baseFace = NORMAL;
-  unsigned long nextBaseChangeMs = 0; // 5-7 sn sonra "büyük ifade" seç
-  unsigned long baseFaceUntilMs  = 0; // seçilen büyük ifade 2 sn kalsın
+  uint32_t nextBaseChangeMs = 0;      // 5-7 sn sonra "büyük ifade" seç
+  uint32_t baseFaceUntilMs  = 0;      // seçilen büyük ifade 2 sn kalsın
+  bool baseChangeArmed = false;       // NORMAL'e dönünce yeniden planlanır
 
   // ---------------- IDLE: Blink overlay timing ----------------
   bool blinkActive = false;
-  unsigned long nextBlinkMs  = 0; // sık ve rastgele
-  unsigned long blinkUntilMs = 0; // blink 90-180ms
+  uint32_t nextBlinkMs  = 0;      // sık ve rastgele
+  uint32_t blinkUntilMs = 0;      // blink 90-180ms
+
+  // ---------------- Display pipeline ----------------
+  // Sahneler display'in tamponuna (back buffer) çizilir; flush() frame'i
+  // core 0'daki gönderim task'ına devreder, loop hiç beklemez.
+  EnicDisplayLink link;
+
+  EnicQueue<DrawRequest, 16> drawQ{"face.draw"};
+
+  // ---------------- Compositor (render task) ----------------
+  DrawRequest pending;
+  bool havePending = false;
+  uint32_t baseSlotUs = 1000000UL / ENIC_FACE_FPS;   // 0: sınırsız (bench)
+  uint32_t slotUs = baseSlotUs;
+  uint32_t nextSlotUs = 0;
+
+  // render() (io task'ı) yazar; oled komutu (kontrol task'ı) kopyalar / sıfırlar -> hepsi kilit altında
+  FrameStats frameStats;
+#if defined(ARDUINO_ARCH_ESP32)
+  mutable portMUX_TYPE statsMux = portMUX_INITIALIZER_UNLOCKED;
+  void lockStats() const   { portENTER_CRITICAL(&statsMux); }
+  void unlockStats() const { portEXIT_CRITICAL(&statsMux); }
+#else
+  void lockStats() const {}
+  void unlockStats() const {}
+#endif
+
+  void flush() { link.submit(display.getBuffer()); }
 
   FaceType pickRandomBaseFace() {
     // BLINK burada yok; blink ayrı scheduler
@@ -58,162 +121,205 @@ private:
   }
 
 public:
-  EnicFace() : display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1) {}
+  // Init dizisi 400 kHz ile gitsin; sonrasında bus IDF sürücüsüne geçiyor
+  EnicFace() : display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1, 400000UL, 400000UL) {}
 
   void begin() {
-    Wire.begin(21, 22);
-    if (!display.begin(SSD1306_SWITCHCAPVCC, 0x3C)) {
+    Wire.begin(OLED_SDA_PIN, OLED_SCL_PIN);
+    if (!display.begin(SSD1306_SWITCHCAPVCC, OLED_ADDR)) {
       Serial.println("OLED init failed!");
     }
-    display.clearDisplay();
-    display.display();
+    link.begin();
+    link.invalidate(); // panel içeriği bilinmiyor -> ilk flush tam frame
+
+    // Tek ilk kare (tampon temizliği dahil): io task'ında init sürerken kontrol tarafı çizim
+    // istediyse o, slot beklemeden; yoksa NORMAL. Kuyrukta istek kalmaz, ikinci flush gelmez.
+    nextSlotUs = nowUs32();
+    if (!render()) renderFace(NORMAL);
+    nextSlotUs = nowUs32() + slotUs;
+  }
 
-    unsigned long now = millis();
+  // Kontrol tarafı: updateIdle() zamanlayıcıları. setup'ta kontrol task'ı başlamadan (begin() io task'ında)
+  void beginIdle() {
+    uint32_t now = nowMs32();
     baseFace = NORMAL;
-    nextBaseChangeMs = now + (unsigned long)random(5000, 7000);
+    nextBaseChangeMs = now + (uint32_t)random(5000, 7000);
+    baseChangeArmed  = true;
     baseFaceUntilMs  = 0;
 
     blinkActive = false;
-    nextBlinkMs  = now + (unsigned long)random(400, 1400);
+    nextBlinkMs  = now + (uint32_t)random(400, 1400);
     blinkUntilMs = 0;
+  }
+
+  // Hedef kare hızı; 0 = slot yok (her render() çağrısı bekleyen son isteği çizer)
+  void setFrameRate(uint16_t fps) {
+    baseSlotUs = fps ? 1000000UL / fps : 0;
+    slotUs = baseSlotUs;
+  }
+
+  EnicDisplayLink::FlushStats getFlushStats() const { return link.getStats(); }
+  FrameStats getFrameStats() const {
+    lockStats();
+    FrameStats s = frameStats;
+    unlockStats();
+    return s;
+  }
+
+  // Sayaçlar sıfırlanır; slotUs render()'ın son yayınladığı değer olarak kalır
+  void resetFlushStats() {
+    link.resetStats();
+    lockStats();
+    uint32_t slot = frameStats.slotUs;
+    frameStats = FrameStats();
+    frameStats.slotUs = slot;
+    unlockStats();
+  }
+
+  void printFlushStats(Print& out) const {
+    link.printStats(out);
+    const FrameStats fs = getFrameStats();
+    out.print("frames requested="); out.print(fs.requested);
+    out.print(" merged=");          out.print(fs.merged);
+    out.print(" presented=");       out.print(fs.presented);
+    out.print(" slot_us=");         out.print(fs.slotUs);
+    out.print(" max_slot_us=");     out.print(fs.maxSlotUs);
+    out.print(" render_us=");       out.println(fs.lastRenderUs);
+  }
 
-    draw(NORMAL);
+  // updateIdle()'ın bir şey değiştireceği ana kalan süre (IDLE güç modunda kontrol uykusu)
+  uint32_t msUntilIdleEvent() const {
+    uint32_t now = nowMs32();
+    int32_t t = blinkActive ? timeUntil(now, blinkUntilMs) : timeUntil(now, nextBlinkMs);
+    if (baseFace != NORMAL) t = min(t, timeUntil(now, baseFaceUntilMs));
+    else if (baseChangeArmed) t = min(t, timeUntil(now, nextBaseChangeMs));
+    return t > 0 ? (uint32_t)t : 0;
   }
 
+  // Render task: bekleyen kareye kalan süre (ms, yukarı yuvarlı); bekleyen yoksa UINT32_MAX
+  uint32_t msUntilRender() const {
+    if (!havePending && drawQ.empty()) return UINT32_MAX;
+    if (!slotUs) return 0;
+    int32_t us = timeUntil(nowUs32(), nextSlotUs);
+    return us > 0 ? ((uint32_t)us + 999) / 1000 : 0;
+  }
+
+  bool drawPending() const { return !drawQ.empty(); }
+
   // IDLE davranışı:
   // - 5-7 saniyede bir "büyük ifade" (2 saniye kalır)
   // - aralarda blink sık ve rastgele (ifadelerin üstüne de gelebilir)
   void updateIdle() {
-    unsigned long now = millis();
+    uint32_t now = nowMs32();
 
     // 1) Blink bitti -> base yüzü geri çiz
-    if (blinkActive && now >= blinkUntilMs) {
+    if (blinkActive && timeReached(now, blinkUntilMs)) {
       blinkActive = false;
       draw(baseFace);
     }
 
     // 2) Base ifade (NORMAL dışı) süresi bitti -> NORMAL'e dön
-    if (baseFace != NORMAL && now >= baseFaceUntilMs) {
+    if (baseFace != NORMAL && timeReached(now, baseFaceUntilMs)) {
       baseFace = NORMAL;
       if (!blinkActive) draw(baseFace);
-      nextBaseChangeMs = now + (unsigned long)random(5000, 7000);
+      nextBaseChangeMs = now + (uint32_t)random(5000, 7000);
+      baseChangeArmed = true;
     }
 
     // 3) 5-7 saniyede bir büyük ifade seç, 2 saniye tut
-    if (baseFace == NORMAL && now >= nextBaseChangeMs) {
+    if (baseFace == NORMAL && baseChangeArmed && timeReached(now, nextBaseChangeMs)) {
       baseFace = pickRandomBaseFace();
       baseFaceUntilMs = now + 2000UL;
       if (!blinkActive) draw(baseFace);
-
-      // Tekrar tetiklenmesin diye ileriye at; normal'e dönünce yeniden planlanacak
-      nextBaseChangeMs = now + 999999UL;
+      baseChangeArmed = false;   // normal'e dönünce yeniden planlanacak
     }
 
     // 4) Blink sık ve rastgele
-    if (!blinkActive && now >= nextBlinkMs) {
+    if (!blinkActive && timeReached(now, nextBlinkMs)) {
       blinkActive = true;
-      blinkUntilMs = now + (unsigned long)random(90, 180);
-      nextBlinkMs  = now + (unsigned long)random(600, 1800);
+      blinkUntilMs = now + (uint32_t)random(90, 180);
+      nextBlinkMs  = now + (uint32_t)random(600, 1800);
       draw(BLINK);
     }
   }
 
   // Tek seferlik yüz çizimi
-  void draw(FaceType type) {
-    display.clearDisplay();
+  void draw(FaceType type) { drawQ.push({ DrawRequest::FACE, (uint8_t)type, 0, 0 }); }
 
-    int lx = 40, rx = 88, y = 25, r = 8;
-    int mx = 64, my = 50;
+  // Dans animasyonu
+  void drawDance(int frame) { drawQ.push({ DrawRequest::DANCE, (uint8_t)frame, 0, 0 }); }
 
-    // ---- EYES ----
-    if (type == DEAD) {
-      display.drawLine(lx-6,y-6,lx+6,y+6,1); display.drawLine(lx+6,y-6,lx-6,y+6,1);
-      display.drawLine(rx-6,y-6,rx+6,y+6,1); display.drawLine(rx+6,y-6,rx-6,y+6,1);
-    }
-    else if (type == BLINK) {
-      display.fillRect(lx-8,y,16,2,1);
-      display.fillRect(rx-8,y,16,2,1);
-    }
-    else if (type == SHOCK) {
-      display.drawCircle(lx,y,r+3,1); display.drawCircle(rx,y,r+3,1);
-      display.fillCircle(lx,y,2,1);   display.fillCircle(rx,y,2,1);
-    }
-    else if (type == TONGUE) {
-      display.fillCircle(lx,y,r,1);
-      display.fillCircle(lx+2,y-2,2,0);
-      display.fillRect(rx-8,y,16,3,1);
-    }
-    else if (type == SNEAKY) {
-      display.fillCircle(lx,y,r,1); display.fillCircle(rx,y,r,1);
-      display.fillRect(lx-10,y-10,20,8,0);
-      display.fillRect(rx-10,y-10,20,8,0);
-    }
-    else if (type == LISTEN) {
-      display.fillCircle(lx,y,r,1); display.fillCircle(rx,y,r,1);
-      display.fillCircle(lx+2,y-1,3,0); display.fillCircle(rx+2,y-1,3,0);
-      display.drawLine(lx-10,y-12,lx+6,y-10,1);
-      display.drawLine(rx-6,y-10,rx+10,y-12,1);
-    }
-    else if (type == SPEAK) {
-      display.fillCircle(lx,y,r,1); display.fillCircle(rx,y,r,1);
-      display.fillCircle(lx+2,y-2,2,0); display.fillCircle(rx-2,y-2,2,0);
-    }
-    else if (type == FEAR) {
-      display.drawCircle(lx,y,r+4,1); display.drawCircle(rx,y,r+4,1);
-      display.fillCircle(lx,y,2,1);   display.fillCircle(rx,y,2,1);
-      display.drawLine(lx-10,y-14,lx+2,y-10,1);
-      display.drawLine(rx-2,y-10,rx+10,y-14,1);
-    }
-    else if (type == CRY) {
-      display.fillCircle(lx,y,r,1); display.fillCircle(rx,y,r,1);
-      display.fillCircle(lx+2,y+2,2,0); display.fillCircle(rx-2,y+2,2,0);
-      display.drawLine(lx+6,y+6,lx+6,y+16,1);
-      display.drawLine(rx-6,y+6,rx-6,y+16,1);
-    }
-    else {
-      // NORMAL
-      display.fillCircle(lx,y,r,1); display.fillCircle(rx,y,r,1);
-      display.fillCircle(lx+2,y-2,2,0); display.fillCircle(rx-2,y-2,2,0);
-    }
+  // "Video hissi" veren bomba sahnesi (faz + progress ile)
+  void drawBombScene(uint8_t phase, uint8_t progress, uint32_t elapsedMs) {
+    drawQ.push({ DrawRequest::BOMB, phase, progress, elapsedMs });
+  }
 
-    // ---- MOUTH ----
-    if (type == DEAD) {
-      display.drawLine(mx-10,my+5,mx+10,my-5,1);
-    }
-    else if (type == TONGUE) {
-      display.fillCircle(mx,my-2,8,1);
-      display.fillRect(mx-10,my-12,20,10,0);
-      display.fillCircle(mx+2,my+5,4,1);
-      display.drawLine(mx+2,my+3,mx+2,my+7,0);
+  // Render task: istekleri birleştir, slot geldiyse son isteği tek kare olarak çiz; çizdiyse true
+  bool render() {
+    DrawRequest r;
+    uint32_t requested = 0, merged = 0;
+    while (drawQ.pop(r)) {
+      requested++;
+      if (havePending) merged++;
+      pending = r;
+      havePending = true;
     }
-    else if (type == SHOCK || type == SPEAK) {
-      display.fillCircle(mx,my+2,6,1);
+    if (requested) {
+      lockStats();
+      frameStats.requested += requested;
+      frameStats.merged += merged;
+      unlockStats();
     }
-    else if (type == LISTEN) {
-      display.fillRect(mx-8,my+2,16,2,1);
-    }
-    else if (type == FEAR) {
-      display.drawCircle(mx,my+3,5,1);
-    }
-    else if (type == CRY) {
-      display.drawLine(mx-10,my+6,mx+10,my+6,1);
-      display.drawLine(mx-10,my+6,mx-6,my+2,1);
-      display.drawLine(mx+10,my+6,mx+6,my+2,1);
-    }
-    else if (type == SNEAKY) {
-      display.fillRect(mx-10,my,20,2,1);
+    if (!havePending) return false;
+
+    uint32_t now = nowUs32();
+    if (slotUs && !timeReached(now, nextSlotUs)) return false;   // slot dolmadı; yeni istek gelirse ezer
+
+    havePending = false;
+    switch (pending.kind) {
+      case DrawRequest::FACE:  renderFace((FaceType)pending.a); break;
+      case DrawRequest::DANCE: renderDance(pending.a); break;
+      case DrawRequest::BOMB:  renderBomb(pending.a, pending.b, pending.t); break;
     }
-    else {
-      // normal kapalı ağız
-      display.fillCircle(mx,my-2,8,1);
-      display.fillRect(mx-10,my-12,20,10,0);
+
+    // Adaptif slot: çizim + son panel gönderimi slotu aşıyorsa uzat, rahatlayınca hedefe dön
+    uint32_t renderUs = nowUs32() - now;
+    if (baseSlotUs) {
+      uint32_t busy = renderUs + link.getStats().lastFlushUs;
+      if (busy > slotUs) {
+        slotUs = busy + busy / 8;
+        if (slotUs > FACE_SLOT_MAX_US) slotUs = FACE_SLOT_MAX_US;
+      } else if (slotUs > baseSlotUs) {
+        uint32_t step = (slotUs - baseSlotUs) / 8;
+        slotUs -= step ? step : 1;
+      }
     }
 
-    display.display();
+    lockStats();
+    frameStats.presented++;
+    frameStats.lastRenderUs = renderUs;
+    frameStats.slotUs = slotUs;
+    if (baseSlotUs && slotUs > frameStats.maxSlotUs) frameStats.maxSlotUs = slotUs;
+    unlockStats();
+
+    // Slot ızgarası korunur (tick yuvarlaması FPS'i düşürmesin); bir slottan fazla gerideyse yeniden başlar
+    nextSlotUs += slotUs;
+    if (timeReached(now, nextSlotUs)) nextSlotUs = now + slotUs;
+    return true;
   }
 
-  // Dans animasyonu
-  void drawDance(int frame) {
+private:
+  // Derleme zamanında hazırlanmış atlas'tan blit
+  void renderFace(FaceType type) {
+    ENIC_PROFILE_SCOPE(PROF_FACE);
+    uint8_t* fb = display.getBuffer();
+    memset(fb, 0, SCREEN_WIDTH * OLED_PAGES);
+    blitFace(fb, type);
+    flush();
+  }
+
+  void renderDance(int frame) {
+    ENIC_PROFILE_SCOPE(PROF_FACE);
     display.clearDisplay();
     display.drawLine(0,60,128,60,1);
 
@@ -240,16 +346,16 @@ public:
       display.drawLine(cx,cy+15,cx-8,cy+28,1); display.drawLine(cx,cy+15,cx+8,cy+28,1);
     }
 
-    display.display();
+    flush();
   }
 
-  // "Video hissi" veren bomba sahnesi (faz + progress ile)
   // phase:
   // 0: 0-5s fitil + geri sayım
   // 1: 5-7s flash
   // 2: 7-12s patlama
   // 3: 12-30s duman/sonrası
-  void drawBombScene(uint8_t phase, uint8_t progress, unsigned long elapsedMs) {
+  void renderBomb(uint8_t phase, uint8_t progress, uint32_t elapsedMs) {
+    ENIC_PROFILE_SCOPE(PROF_FACE);
     display.clearDisplay();
 
     // Basit deterministic pseudo-random (frame'e göre)
@@ -292,7 +398,7 @@ public:
       display.print("T-");
       display.print(secLeft);
 
-      display.display();
+      flush();
       return;
     }
 
@@ -308,7 +414,7 @@ public:
       display.setTextSize(1);
       display.setCursor(34, 28);
       display.print("!!!");
-      display.display();
+      flush();
       return;
     }
 
@@ -333,7 +439,7 @@ public:
       display.setTextColor(1);
       display.setCursor(0, 0);
       display.print("BOOOOM!");
-      display.display();
+      flush();
       return;
     }
 
@@ -362,11 +468,11 @@ public:
       display.setTextColor(1);
       display.setCursor(0, 0);
       display.print("SMOKE...");
-      display.display();
+      flush();
       return;
     }
 
-    display.display();
+    flush();
   }
 };
 
@@ -0,0 +1,338 @@
+/**
+ * @file EnicFaceAtlas.h
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Compile-time rasterized facial expression atlas (page-packed 1bpp)
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ */
+#ifndef ENIC_FACE_ATLAS_H
+#define ENIC_FACE_ATLAS_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define SCREEN_WIDTH 128
+#define SCREEN_HEIGHT 64
+#define OLED_PAGES (SCREEN_HEIGHT / 8)
+
+// Yüz tipleri
+enum FaceType {
+  NORMAL,
+  BLINK,
+  DEAD,
+  TONGUE,
+  LISTEN,
+  SPEAK,
+  SHOCK,
+  SNEAKY,
+  CRY,
+  FEAR
+};
+
+static const int FACE_COUNT = FEAR + 1;
+
+// ---------------- constexpr rasterizer ----------------
+// Adafruit_GFX primitiflerinin (drawLine/drawCircle/fillCircle/fillRect) birebir
+// aynısı; SSD1306 framebuffer düzeninde (page-packed, LSB = üst satır) çizer.
+// 'atlas' bench suite'i blitFace() çıktısını host GFX ile çizilen orijinal diziyle bayt bayt karşılaştırır.
+struct FaceCanvas {
+  uint8_t px[SCREEN_WIDTH * OLED_PAGES] = {};
+
+  constexpr void drawPixel(int x, int y, int color) {
+    if (x < 0 || x >= SCREEN_WIDTH || y < 0 || y >= SCREEN_HEIGHT) return;
+    const int i = x + (y / 8) * SCREEN_WIDTH;
+    const uint8_t m = (uint8_t)(1 << (y & 7));
+    if (color) px[i] = (uint8_t)(px[i] | m);
+    else       px[i] = (uint8_t)(px[i] & ~m);
+  }
+
+  constexpr bool getPixel(int x, int y) const {
+    return (px[x + (y / 8) * SCREEN_WIDTH] >> (y & 7)) & 1;
+  }
+
+  constexpr void drawFastVLine(int x, int y, int h, int color) {
+    for (int i = 0; i < h; i++) drawPixel(x, y + i, color);
+  }
+
+  constexpr void drawFastHLine(int x, int y, int w, int color) {
+    for (int i = 0; i < w; i++) drawPixel(x + i, y, color);
+  }
+
+  constexpr void writeLine(int x0, int y0, int x1, int y1, int color) {
+    const bool steep = iabs(y1 - y0) > iabs(x1 - x0);
+    if (steep) { swap(x0, y0); swap(x1, y1); }
+    if (x0 > x1) { swap(x0, x1); swap(y0, y1); }
+
+    const int dx = x1 - x0;
+    const int dy = iabs(y1 - y0);
+    int err = dx / 2;
+    const int ystep = (y0 < y1) ? 1 : -1;
+
+    for (; x0 <= x1; x0++) {
+      if (steep) drawPixel(y0, x0, color);
+      else       drawPixel(x0, y0, color);
+      err -= dy;
+      if (err < 0) { y0 += ystep; err += dx; }
+    }
+  }
+
+  constexpr void drawLine(int x0, int y0, int x1, int y1, int color) {
+    if (x0 == x1) {
+      if (y0 > y1) swap(y0, y1);
+      drawFastVLine(x0, y0, y1 - y0 + 1, color);
+    } else if (y0 == y1) {
+      if (x0 > x1) swap(x0, x1);
+      drawFastHLine(x0, y0, x1 - x0 + 1, color);
+    } else {
+      writeLine(x0, y0, x1, y1, color);
+    }
+  }
+
+  constexpr void fillRect(int x, int y, int w, int h, int color) {
+    for (int i = x; i < x + w; i++) drawFastVLine(i, y, h, color);
+  }
+
+  constexpr void drawCircle(int x0, int y0, int r, int color) {
+    int f = 1 - r, ddF_x = 1, ddF_y = -2 * r, x = 0, y = r;
+
+    drawPixel(x0, y0 + r, color);
+    drawPixel(x0, y0 - r, color);
+    drawPixel(x0 + r, y0, color);
+    drawPixel(x0 - r, y0, color);
+
+    while (x < y) {
+      if (f >= 0) { y--; ddF_y += 2; f += ddF_y; }
+      x++; ddF_x += 2; f += ddF_x;
+
+      drawPixel(x0 + x, y0 + y, color); drawPixel(x0 - x, y0 + y, color);
+      drawPixel(x0 + x, y0 - y, color); drawPixel(x0 - x, y0 - y, color);
+      drawPixel(x0 + y, y0 + x, color); drawPixel(x0 - y, y0 + x, color);
+      drawPixel(x0 + y, y0 - x, color); drawPixel(x0 - y, y0 - x, color);
+    }
+  }
+
+  constexpr void fillCircle(int x0, int y0, int r, int color) {
+    drawFastVLine(x0, y0 - r, 2 * r + 1, color);
+
+    // fillCircleHelper(x0, y0, r, corners = 3, delta = 0)
+    int f = 1 - r, ddF_x = 1, ddF_y = -2 * r, x = 0, y = r, px = x, py = y;
+    const int delta = 1;
+
+    while (x < y) {
+      if (f >= 0) { y--; ddF_y += 2; f += ddF_y; }
+      x++; ddF_x += 2; f += ddF_x;
+
+      if (x < (y + 1)) {
+        drawFastVLine(x0 + x, y0 - y, 2 * y + delta, color);
+        drawFastVLine(x0 - x, y0 - y, 2 * y + delta, color);
+      }
+      if (y != py) {
+        drawFastVLine(x0 + py, y0 - px, 2 * px + delta, color);
+        drawFastVLine(x0 - py, y0 - px, 2 * px + delta, color);
+        py = y;
+      }
+      px = x;
+    }
+  }
+
+private:
+  static constexpr int iabs(int v) { return v < 0 ? -v : v; }
+  static constexpr void swap(int& a, int& b) { int t = a; a = b; b = t; }
+};
+
+// ---------------- Face geometry ----------------
+// Göz ve ağız ayrı katmanlar; aynı primitif çağrıları, sadece derleme zamanında.
+constexpr void rasterFaceEyes(FaceCanvas& display, FaceType type) {
+  const int lx = 40, rx = 88, y = 25, r = 8;
+
+  if (type == DEAD) {
+    display.drawLine(lx-6,y-6,lx+6,y+6,1); display.drawLine(lx+6,y-6,lx-6,y+6,1);
+    display.drawLine(rx-6,y-6,rx+6,y+6,1); display.drawLine(rx+6,y-6,rx-6,y+6,1);
+  }
+  else if (type == BLINK) {
+    display.fillRect(lx-8,y,16,2,1);
+    display.fillRect(rx-8,y,16,2,1);
+  }
+  else if (type == SHOCK) {
+    display.drawCircle(lx,y,r+3,1); display.drawCircle(rx,y,r+3,1);
+    display.fillCircle(lx,y,2,1);   display.fillCircle(rx,y,2,1);
+  }
+  else if (type == TONGUE) {
+    display.fillCircle(lx,y,r,1);
+    display.fillCircle(lx+2,y-2,2,0);
+    display.fillRect(rx-8,y,16,3,1);
+  }
+  else if (type == SNEAKY) {
+    display.fillCircle(lx,y,r,1); display.fillCircle(rx,y,r,1);
+    display.fillRect(lx-10,y-10,20,8,0);
+    display.fillRect(rx-10,y-10,20,8,0);
+  }
+  else if (type == LISTEN) {
+    display.fillCircle(lx,y,r,1); display.fillCircle(rx,y,r,1);
+    display.fillCircle(lx+2,y-1,3,0); display.fillCircle(rx+2,y-1,3,0);
+    display.drawLine(lx-10,y-12,lx+6,y-10,1);
+    display.drawLine(rx-6,y-10,rx+10,y-12,1);
+  }
+  else if (type == SPEAK) {
+    display.fillCircle(lx,y,r,1); display.fillCircle(rx,y,r,1);
+    display.fillCircle(lx+2,y-2,2,0); display.fillCircle(rx-2,y-2,2,0);
+  }
+  else if (type == FEAR) {
+    display.drawCircle(lx,y,r+4,1); display.drawCircle(rx,y,r+4,1);
+    display.fillCircle(lx,y,2,1);   display.fillCircle(rx,y,2,1);
+    display.drawLine(lx-10,y-14,lx+2,y-10,1);
+    display.drawLine(rx-2,y-10,rx+10,y-14,1);
+  }
+  else if (type == CRY) {
+    display.fillCircle(lx,y,r,1); display.fillCircle(rx,y,r,1);
+    display.fillCircle(lx+2,y+2,2,0); display.fillCircle(rx-2,y+2,2,0);
+    display.drawLine(lx+6,y+6,lx+6,y+16,1);
+    display.drawLine(rx-6,y+6,rx-6,y+16,1);
+  }
+  else {
+    // NORMAL
+    display.fillCircle(lx,y,r,1); display.fillCircle(rx,y,r,1);
+    display.fillCircle(lx+2,y-2,2,0); display.fillCircle(rx-2,y-2,2,0);
+  }
+}
+
+constexpr void rasterFaceMouth(FaceCanvas& display, FaceType type) {
+  const int mx = 64, my = 50;
+
+  if (type == DEAD) {
+    display.drawLine(mx-10,my+5,mx+10,my-5,1);
+  }
+  else if (type == TONGUE) {
+    display.fillCircle(mx,my-2,8,1);
+    display.fillRect(mx-10,my-12,20,10,0);
+    display.fillCircle(mx+2,my+5,4,1);
+    display.drawLine(mx+2,my+3,mx+2,my+7,0);
+  }
+  else if (type == SHOCK || type == SPEAK) {
+    display.fillCircle(mx,my+2,6,1);
+  }
+  else if (type == LISTEN) {
+    display.fillRect(mx-8,my+2,16,2,1);
+  }
+  else if (type == FEAR) {
+    display.drawCircle(mx,my+3,5,1);
+  }
+  else if (type == CRY) {
+    display.drawLine(mx-10,my+6,mx+10,my+6,1);
+    display.drawLine(mx-10,my+6,mx-6,my+2,1);
+    display.drawLine(mx+10,my+6,mx+6,my+2,1);
+  }
+  else if (type == SNEAKY) {
+    display.fillRect(mx-10,my,20,2,1);
+  }
+  else {
+    // normal kapalı ağız
+    display.fillCircle(mx,my-2,8,1);
+    display.fillRect(mx-10,my-12,20,10,0);
+  }
+}
+
+// ---------------- Atlas layout ----------------
+// Katman pencereleri (kolon x page). Tüm ifadelerin piksel kapsamını içerir;
+// aşağıdaki static_assert'ler pencere dışına taşma olmadığını doğrular.
+static const int FACE_EYE_COL0   = 24;
+static const int FACE_EYE_W      = 80;  // 24..103
+static const int FACE_EYE_PAGE0  = 1;
+static const int FACE_EYE_PAGES  = 5;   // satır 8..47
+
+static const int FACE_MOUTH_COL0  = 52;
+static const int FACE_MOUTH_W     = 24; // 52..75
+static const int FACE_MOUTH_PAGE0 = 4;
+static const int FACE_MOUTH_PAGES = 4;  // satır 32..63
+
+struct FaceAtlas {
+  uint8_t eyes[FACE_COUNT][FACE_EYE_PAGES * FACE_EYE_W];
+  uint8_t mouth[FACE_COUNT][FACE_MOUTH_PAGES * FACE_MOUTH_W];
+};
+
+constexpr void cropFaceLayer(const FaceCanvas& c, uint8_t* out, int col0, int w, int page0, int pages) {
+  for (int p = 0; p < pages; p++)
+    for (int x = 0; x < w; x++)
+      out[p * w + x] = c.px[(page0 + p) * SCREEN_WIDTH + col0 + x];
+}
+
+constexpr bool faceLayerInside(const FaceCanvas& c, int col0, int w, int page0, int pages) {
+  for (int p = 0; p < OLED_PAGES; p++)
+    for (int x = 0; x < SCREEN_WIDTH; x++) {
+      bool inside = (p >= page0 && p < page0 + pages && x >= col0 && x < col0 + w);
+      if (!inside && c.px[p * SCREEN_WIDTH + x] != 0) return false;
+    }
+  return true;
+}
+
+constexpr FaceAtlas bakeFaceAtlas() {
+  FaceAtlas atlas = {};
+  for (int t = 0; t < FACE_COUNT; t++) {
+    FaceCanvas eyes;
+    rasterFaceEyes(eyes, (FaceType)t);
+    cropFaceLayer(eyes, atlas.eyes[t], FACE_EYE_COL0, FACE_EYE_W, FACE_EYE_PAGE0, FACE_EYE_PAGES);
+
+    FaceCanvas mouth;
+    rasterFaceMouth(mouth, (FaceType)t);
+    cropFaceLayer(mouth, atlas.mouth[t], FACE_MOUTH_COL0, FACE_MOUTH_W, FACE_MOUTH_PAGE0, FACE_MOUTH_PAGES);
+  }
+  return atlas;
+}
+
+// Flash'ta (rodata) tek kopya
+inline constexpr FaceAtlas FACE_ATLAS = bakeFaceAtlas();
+
+// Çalışma anı çizimi: temiz framebuffer'a göz katmanı memcpy, ağız katmanı OR
+inline void blitFace(uint8_t* fb, FaceType type) {
+  const uint8_t* e = FACE_ATLAS.eyes[type];
+  for (int p = 0; p < FACE_EYE_PAGES; p++) {
+    memcpy(fb + (FACE_EYE_PAGE0 + p) * SCREEN_WIDTH + FACE_EYE_COL0,
+           e + p * FACE_EYE_W, FACE_EYE_W);
+  }
+
+  const uint8_t* m = FACE_ATLAS.mouth[type];
+  for (int p = 0; p < FACE_MOUTH_PAGES; p++) {
+    uint8_t* dst = fb + (FACE_MOUTH_PAGE0 + p) * SCREEN_WIDTH + FACE_MOUTH_COL0;
+    const uint8_t* src = m + p * FACE_MOUTH_W;
+    for (int x = 0; x < FACE_MOUTH_W; x++) dst[x] |= src[x];
+  }
+}
+
+// ---------------- Compile-time checks ----------------
+constexpr bool faceLayersFitWindows() {
+  for (int t = 0; t < FACE_COUNT; t++) {
+    FaceCanvas eyes;
+    rasterFaceEyes(eyes, (FaceType)t);
+    if (!faceLayerInside(eyes, FACE_EYE_COL0, FACE_EYE_W, FACE_EYE_PAGE0, FACE_EYE_PAGES)) return false;
+
+    FaceCanvas mouth;
+    rasterFaceMouth(mouth, (FaceType)t);
+    if (!faceLayerInside(mouth, FACE_MOUTH_COL0, FACE_MOUTH_W, FACE_MOUTH_PAGE0, FACE_MOUTH_PAGES)) return false;
+  }
+  return true;
+}
+
+// Katmanların OR'u, eski sıralı çizimle (göz + ağız aynı tuvalde) aynı olmalı:
+// ağızdaki siyah (0) dolgular göz piksellerine değmiyor.
+constexpr bool faceLayersMatchSequential() {
+  for (int t = 0; t < FACE_COUNT; t++) {
+    FaceCanvas seq;
+    rasterFaceEyes(seq, (FaceType)t);
+    rasterFaceMouth(seq, (FaceType)t);
+
+    FaceCanvas eyes, mouth;
+    rasterFaceEyes(eyes, (FaceType)t);
+    rasterFaceMouth(mouth, (FaceType)t);
+
+    for (int i = 0; i < SCREEN_WIDTH * OLED_PAGES; i++) {
+      if (seq.px[i] != (uint8_t)(eyes.px[i] | mouth.px[i])) return false;
+    }
+  }
+  return true;
+}
+
+static_assert(faceLayersFitWindows(), "face layer exceeds its atlas window");
+static_assert(faceLayersMatchSequential(), "face layers do not compose to the sequential drawing");
+
+#endif
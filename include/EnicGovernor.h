@@ -0,0 +1,152 @@
+/**
+ * @file EnicGovernor.h
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Forward speed governor: distance- and TTC-proportional cap between the FSM and EnicMotor
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ *
+ * FSM istediği hızı verir, governor filtrelenmiş mesafeye göre izin verilen ileri duty'yi
+ * hesaplar: açık alanda tam hız, slow..full aralığında doğrusal azalma, yakında sürünme hızı.
+ * Engel kendisi yaklaşıyorsa (TTC kısa) tavan ayrıca kısılır. Sadece çok yakın / çok kısa
+ * TTC'de rampasız acil durdurma. Geri ve yerinde dönüş sınırlanmaz (sonar sadece önde).
+ */
+#ifndef ENIC_GOVERNOR_H
+#define ENIC_GOVERNOR_H
+
+#include <Arduino.h>
+#include "EnicMotor.h"
+#include "EnicRangeFilter.h"
+#include "EnicMem.h"
+
+// Çalışma anında ayarlanabilir parametreler ("gov <no> <değer>"); hepsi tam sayı
+enum GovParam : uint8_t {
+  GOV_ENABLE,        // 0: kapalı (eski sabit hızlar)
+  GOV_CRUISE,        // AUTO açık alan hızı (duty)
+  GOV_MIN_DUTY,      // yakında sürünme hızı (duty)
+  GOV_SLOW_CM,       // bu mesafede ve altında sürünme
+  GOV_FULL_CM,       // bu mesafede ve üstünde tam hız
+  GOV_TTC_MS,        // TTC bunun altındaysa tavan TTC ile orantılı kısılır
+  GOV_STOP_CM,       // acil durdurma mesafesi
+  GOV_STOP_TTC_MS,   // acil durdurma TTC'si
+  GOV_PARAM_COUNT
+};
+
+struct GovParamDef {
+  const char* name;
+  int16_t def, lo, hi;
+};
+
+// GovParam sırasıyla
+inline constexpr GovParamDef GOV_PARAMS[GOV_PARAM_COUNT] = {
+  { "enable",      1,    0,    1 },
+  { "cruise",    180,   60,  255 },
+  { "min_duty",   70,   30,  200 },
+  { "slow_cm",    25,    5,  200 },
+  { "full_cm",    90,   10,  400 },
+  { "ttc_ms",   1500,  100, 5000 },
+  { "stop_cm",     8,    0,   50 },
+  { "stop_ttc_ms", 300,  0, 2000 },
+};
+
+class EnicGovernor {
+public:
+  struct GovernorStats {
+    uint32_t ticks = 0;         // ileri komut verilen tick
+    uint32_t limited = 0;       // tavan komutu kıstı
+    uint32_t ttcLimited = 0;    // tavanı TTC belirledi
+    uint32_t emergencies = 0;   // acil durdurma (her olay bir kez)
+    int16_t  lastCap = 255;
+  };
+
+private:
+  int16_t p[GOV_PARAM_COUNT];
+  GovernorStats stats;
+  bool inEmergency = false;
+
+  // Mesafe tavanı: slow altında min, full üstünde 255, arada doğrusal
+  float distanceCap(float d) const {
+    float lo = p[GOV_SLOW_CM], hi = p[GOV_FULL_CM];
+    if (d >= hi) return 255.0f;
+    if (d <= lo || hi <= lo) return p[GOV_MIN_DUTY];
+    return p[GOV_MIN_DUTY] + (255.0f - p[GOV_MIN_DUTY]) * (d - lo) / (hi - lo);
+  }
+
+public:
+  EnicGovernor() {
+    for (int i = 0; i < GOV_PARAM_COUNT; i++) p[i] = GOV_PARAMS[i].def;
+  }
+
+  bool enabled() const { return p[GOV_ENABLE] != 0; }
+  int cruise() const { return p[GOV_CRUISE]; }
+
+  int16_t get(uint8_t id) const { return id < GOV_PARAM_COUNT ? p[id] : 0; }
+  bool set(uint8_t id, long v) {
+    if (id >= GOV_PARAM_COUNT) return false;
+    const GovParamDef& d = GOV_PARAMS[id];
+    p[id] = (int16_t)constrain(v, (long)d.lo, (long)d.hi);
+    return true;
+  }
+
+  // İzin verilen ileri duty (0: acil durum). Echo yok = açık alan.
+  int cap(const RangeEstimate& r) {
+    if (!r.valid) return 255;
+    bool closing = r.closingCmS > 0.0f;
+    if (r.distCm <= p[GOV_STOP_CM] || (closing && r.ttcS * 1000.0f <= p[GOV_STOP_TTC_MS])) return 0;
+
+    float c = distanceCap(r.distCm);
+    float ttcMs = r.ttcS * 1000.0f;
+    if (closing && ttcMs < p[GOV_TTC_MS]) {
+      float t = p[GOV_MIN_DUTY] + (c - p[GOV_MIN_DUTY]) * ttcMs / p[GOV_TTC_MS];
+      if (t < c) { c = t; stats.ttcLimited++; }
+    }
+    return (int)c;
+  }
+
+  // FSM'in ileri sürüşü buradan geçer. İleri bileşen varsa (tek teker pivot / yay dahil) ileri giden
+  // teker tavana indirilir, eğrilik (oran) korunur; acil durumda EnicMotor::stop() (rampasız).
+  // İleri bileşeni olmayan sürüş (geri, yerinde dönüş, geri yay) sınırlanmaz.
+  void drive(EnicMotor* motor, int left, int right, const RangeEstimate& r) {
+    if (!enabled() || left + right <= 0) {
+      inEmergency = false;
+      motor->drive(left, right);
+      return;
+    }
+
+    stats.ticks++;
+    int c = cap(r);
+    stats.lastCap = (int16_t)c;
+    if (c == 0) {
+      if (!inEmergency) { stats.emergencies++; motor->stop(); }
+      inEmergency = true;
+      return;
+    }
+    inEmergency = false;
+
+    int fwd = left > right ? left : right;
+    if (fwd > c) {
+      left = left * c / fwd;
+      right = right * c / fwd;
+      stats.limited++;
+    }
+    motor->drive(left, right);
+  }
+
+  bool inEmergencyStop() const { return inEmergency; }
+
+  const GovernorStats& getStats() const { return stats; }
+  void resetStats() { stats = GovernorStats(); }
+
+  void printStats(Print& out) const {
+    for (int i = 0; i < GOV_PARAM_COUNT; i++) {
+      enicPrintf(out, "%d %-12s %d\n", i, GOV_PARAMS[i].name, p[i]);
+    }
+    out.print("gov ticks=");   out.print(stats.ticks);
+    out.print(" limited=");    out.print(stats.limited);
+    out.print(" ttc=");        out.print(stats.ttcLimited);
+    out.print(" emergency=");  out.print(stats.emergencies);
+    out.print(" cap=");        out.println(stats.lastCap);
+  }
+};
+
+#endif
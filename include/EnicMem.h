@@ -0,0 +1,220 @@
+/**
+ * @file EnicMem.h
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Memory budget: static RAM per subsystem, heap guard after boot, stack high-water marks
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ *
+ * Kalıcı durumun hepsi statik: framebuffer (EnicPanel), komut satırı, kuyruklar, uçuş kaydı halkası,
+ * JSON havuzu, task yığınları (xTaskCreateStatic). Heap sadece açılışta (I2C / LittleFS / NVS sürücüleri).
+ * Açılış raporu basılınca (EnicBoot) EnicMem::arm(): bundan sonraki her malloc/calloc/realloc sayılır.
+ *
+ * ENIC_HEAP_GUARD (-Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc ile; platformio.ini esp32dev_static):
+ *   0: kapalı. 1: sayar (task, boyut, çağıran adres; 'mem' komutu).
+ *   2: ayrıca sense / kontrol task'ında tahsis -> abort (panic çıktısında backtrace).
+ * Sarma sadece malloc sembolünü çağıranları görür (Arduino core, libstdc++, newlib, kütüphaneler);
+ * IDF içi heap_caps_malloc (NVS, LittleFS, sürücüler) heap istatistiklerinde görünür.
+ */
+#ifndef ENIC_MEM_H
+#define ENIC_MEM_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <stdarg.h>
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include "esp_heap_caps.h"
+#include "esp_rom_sys.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// Bağlayıcı betiğinin DRAM bölge sınırları
+extern "C" int _data_start, _data_end, _bss_start, _bss_end;
+#else
+#include <EnicHost.h>
+#endif
+
+#ifndef ENIC_HEAP_GUARD
+#define ENIC_HEAP_GUARD 0
+#endif
+
+// Print::printf 64 bayttan uzun çıktıda heap'ten tampon alır; raporlar bununla yığında biçimlenir
+static const size_t ENIC_PRINTF_MAX = 256;
+
+inline size_t enicPrintf(Print& out, const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+inline size_t enicPrintf(Print& out, const char* fmt, ...) {
+  char buf[ENIC_PRINTF_MAX];
+  va_list ap;
+  va_start(ap, fmt);
+  int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+  va_end(ap);
+  if (n < 0) return 0;
+  if (n >= (int)sizeof(buf)) n = sizeof(buf) - 1;   // kırpılır
+  return out.write((const uint8_t*)buf, (size_t)n);
+}
+
+class EnicMem {
+private:
+  struct Region { const char* name; uint32_t bytes; };
+  static const int MAX_REGIONS = 16;
+
+  // Cihazda kayıt setup'ta; host'ta her iş parçacığının kendi Rig'i (HostBoard gibi thread_local)
+#if defined(ARDUINO_ARCH_ESP32)
+  struct Stack { const char* name; TaskHandle_t handle; uint32_t bytes; bool strict; };
+  static const int MAX_STACKS = 8;
+  static inline Stack stacks[MAX_STACKS] = {};
+  static inline std::atomic<uint8_t> stackCount{0};   // setup (core 1) ve io startup'ı (core 0) ekler
+  static inline Region regions[MAX_REGIONS] = {};
+  static inline uint8_t regionCount = 0;
+
+  static inline std::atomic<bool> armed{false};
+  static inline std::atomic<uint32_t> allocs{0};        // sarmadan geçen tüm tahsisler
+  static inline std::atomic<uint32_t> armedAllocs{0};   // arm() sonrası
+  static inline std::atomic<uint32_t> armedBytes{0};
+  static inline size_t lastSize = 0;
+  static inline void* lastCaller = nullptr;
+  static inline const char* lastTask = nullptr;
+  static inline uint32_t heapAtArm = 0;
+  static inline bool linked = false;
+#else
+  static inline thread_local Region regions[MAX_REGIONS] = {};
+  static inline thread_local uint8_t regionCount = 0;
+  static inline thread_local bool armed = false;
+  static inline thread_local uint32_t allocsAtArm = 0;
+  static inline thread_local bool linked = false;
+#endif
+
+public:
+  // Alt sistemin statik RAM'i (sizeof nesne); aynı ad tekrar gelirse güncellenir
+  static void add(const char* name, uint32_t bytes) {
+    for (uint8_t i = 0; i < regionCount; i++) {
+      if (!strcmp(regions[i].name, name)) { regions[i].bytes = bytes; return; }
+    }
+    if (regionCount < MAX_REGIONS) regions[regionCount++] = { name, bytes };
+  }
+
+  static uint32_t staticBytes() {
+    uint32_t sum = 0;
+    for (uint8_t i = 0; i < regionCount; i++) sum += regions[i].bytes;
+    return sum;
+  }
+
+  // Host: yeni Rig öncesi (kayıtlar ve arm sıfırlanır)
+  static void clear() {
+    regionCount = 0;
+#if !defined(ARDUINO_ARCH_ESP32)
+    armed = false;
+#endif
+  }
+
+  // Sarma bağlandıysa toplam tahsis sayısı (host: bu iş parçacığı)
+  static uint32_t heapAllocs() {
+#if defined(ARDUINO_ARCH_ESP32)
+    return allocs.load(std::memory_order_relaxed);
+#else
+    return (uint32_t)hostHeapAllocs();
+#endif
+  }
+
+  // Bağlayıcı --wrap=malloc verilmediyse sayaç hiç artmaz; arm() öncesi bir deneme tahsisiyle anlaşılır
+  static bool probeLinked() {
+    uint32_t before = heapAllocs();
+    void* volatile p = malloc(1);
+    free(p);
+    return heapAllocs() != before;
+  }
+  static bool guardLinked() { return linked; }
+
+  // newlib dtoa'nın task başına Bigint önbelleği ilk float çıktısında heap'ten gelir:
+  // her task açılışta bir kez doldursun (raporlar sonra heap'e dokunmasın)
+  static void primeTask() {
+    char tmp[64];
+    snprintf(tmp, sizeof(tmp), "%.6g %.1f %.3f %lu", 123456.789, -0.05, 1.0e9, 4294967295UL);
+  }
+
+  // Açılış bitti: bundan sonraki her tahsis sayılır (mod 2'de gerçek zamanlı task'larda abort)
+  static void arm() {
+    linked = probeLinked();
+#if defined(ARDUINO_ARCH_ESP32)
+    heapAtArm = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    armedAllocs.store(0);
+    armedBytes.store(0);
+    armed.store(true);
+#else
+    allocsAtArm = heapAllocs();
+    armed = true;
+#endif
+  }
+
+  static bool isArmed() { return armed; }
+
+  static uint32_t allocsSinceArm() {
+#if defined(ARDUINO_ARCH_ESP32)
+    return armedAllocs.load();
+#else
+    return armed ? heapAllocs() - allocsAtArm : 0;
+#endif
+  }
+
+#if defined(ARDUINO_ARCH_ESP32)
+  // Task yığını (statik; boyut bayt). strict: mod 2'de bu task'ta tahsis abort
+  static void addStack(const char* name, TaskHandle_t h, uint32_t bytes, bool strict = false) {
+    if (!h) return;
+    uint8_t i = stackCount.load();
+    while (i < MAX_STACKS && !stackCount.compare_exchange_weak(i, (uint8_t)(i + 1))) {}
+    if (i >= MAX_STACKS) return;
+    stacks[i] = { name, h, bytes, strict };
+  }
+
+  // __wrap_malloc / calloc / realloc (main.cpp); tahsis yapmaz, kilit almaz
+  static void onAlloc(size_t n, void* caller) {
+    allocs.fetch_add(1, std::memory_order_relaxed);
+    if (!armed.load(std::memory_order_relaxed)) return;
+    armedAllocs.fetch_add(1, std::memory_order_relaxed);
+    armedBytes.fetch_add((uint32_t)n, std::memory_order_relaxed);
+    lastSize = n;
+    lastCaller = caller;
+    if (xPortInIsrContext()) { lastTask = "isr"; return; }
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    lastTask = pcTaskGetName(self);
+#if ENIC_HEAP_GUARD >= 2
+    uint8_t count = stackCount.load(std::memory_order_relaxed);
+    for (uint8_t i = 0; i < count && i < MAX_STACKS; i++) {
+      if (stacks[i].strict && stacks[i].handle == self) {
+        esp_rom_printf("heap alloc in %s after boot: %u B from %p\n", lastTask, (unsigned)n, caller);
+        abort();
+      }
+    }
+#endif
+  }
+#endif
+
+  // 'mem': statik RAM, heap (boş / en düşük / en büyük blok), açılış sonrası tahsisler, yığınlar
+  static void print(Print& out) {
+    enicPrintf(out, "mem guard=%d linked=%u armed=%u static=%lu B\n", ENIC_HEAP_GUARD, (unsigned)guardLinked(),
+               (unsigned)isArmed(), (unsigned long)staticBytes());
+    for (uint8_t i = 0; i < regionCount; i++) {
+      enicPrintf(out, "  %-10s %6lu\n", regions[i].name, (unsigned long)regions[i].bytes);
+    }
+#if defined(ARDUINO_ARCH_ESP32)
+    enicPrintf(out, "dram data=%lu bss=%lu\n", (unsigned long)((char*)&_data_end - (char*)&_data_start),
+               (unsigned long)((char*)&_bss_end - (char*)&_bss_start));
+    enicPrintf(out, "heap free=%lu min=%lu largest=%lu at_arm=%lu\n",
+               (unsigned long)heap_caps_get_free_size(MALLOC_CAP_8BIT),
+               (unsigned long)heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT),
+               (unsigned long)heap_caps_get_largest_free_block(MALLOC_CAP_8BIT), (unsigned long)heapAtArm);
+    enicPrintf(out, "after_boot allocs=%lu bytes=%lu last=%s:%u@%p\n", (unsigned long)armedAllocs.load(),
+               (unsigned long)armedBytes.load(), lastTask ? lastTask : "-", (unsigned)lastSize, lastCaller);
+    out.println("task         stack  free_min  strict");
+    for (uint8_t i = 0; i < stackCount; i++) {
+      enicPrintf(out, "%-12s %5lu  %8lu  %u\n", stacks[i].name, (unsigned long)stacks[i].bytes,
+                 (unsigned long)uxTaskGetStackHighWaterMark(stacks[i].handle), (unsigned)stacks[i].strict);
+    }
+#else
+    enicPrintf(out, "after_boot allocs=%lu\n", (unsigned long)allocsSinceArm());
+#endif
+  }
+};
+
+#endif
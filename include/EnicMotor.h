@@ -10,6 +10,11 @@
 #define ENIC_MOTOR_H
 
 #include <Arduino.h>
+#if defined(ARDUINO_ARCH_ESP32)
+#include "esp_timer.h"
+#endif
+#include "EnicEncoder.h"
+#include "EnicTime.h"
 
 #define M1_IN1 26
 #define M1_IN2 27
@@ -24,13 +29,89 @@ static const uint8_t M2_IN4_CH = 4;
 static const uint32_t MOTOR_PWM_FREQ = 20000;
 static const uint8_t  MOTOR_PWM_BITS = 8; // 0..255
 
+// Kontrol periyodu ve varsayılan profil limitleri (PWM birimi = 0..255 duty)
+static const uint32_t MOTOR_TICK_US      = 1000;     // 1 kHz
+static const float    MOTOR_ACCEL_DEFAULT = 1500.0f; // duty/s  -> 0..255 ~170 ms
+static const float    MOTOR_JERK_DEFAULT  = 30000.0f; // duty/s^2 (0: sınırsız -> trapez)
+
+// Uygulanan profilin anlık görüntüsü (getProfile)
+struct MotorProfile {
+  float targetLeft = 0, targetRight = 0;
+  float velLeft = 0, velRight = 0;     // uygulanan duty (işaretli)
+  float accLeft = 0, accRight = 0;     // duty/s
+  float maxAccel = MOTOR_ACCEL_DEFAULT;
+  float maxJerk = MOTOR_JERK_DEFAULT;
+  uint32_t ticks = 0;
+  uint32_t lateTicks = 0;              // periyodun 2 katından geç gelen tick
+  uint32_t maxTickUs = 0;              // en uzun tick aralığı
+
+  // Kapalı çevrim (ENIC_ENCODERS): ölçülen hız (duty birimi) ve PWM'e giden duty
+  bool closedLoop = false;
+  float measLeft = 0, measRight = 0;
+  float dutyLeft = 0, dutyRight = 0;
+};
+
+// Hız döngüsü kazançları (duty birimi): duty = kff*sp + kp*e + ki*∫e
+struct MotorGains {
+  float kff = 1.0f;
+  float kp = 0.8f;
+  float ki = 12.0f;          // 1/s
+  float iLimit = 120.0f;     // integral payı sınırı (duty)
+};
+
 class EnicMotor {
 private:
-  int targetLeft  = 0;
-  int targetRight = 0;
-  int currentLeft  = 0;
-  int currentRight = 0;
-  int rampStep = 14;
+  // Profil durumu: ESP32'de esp_timer task yazar, loop okur (lock altında)
+  MotorProfile prof;
+  bool stopRequested = false;
+  bool parked = false;          // IDLE güç modu: tick durdu (sadece kontrol task'ı değiştirir)
+
+  // Eksen başına limit ölçeği: iki teker aynı anda hedefe varsın (eğrilik korunur)
+  float scaleLeft = 1.0f, scaleRight = 1.0f;
+
+  int lastDutyLeft = 0x7FFF, lastDutyRight = 0x7FFF;
+
+#if ENIC_ENCODERS
+  EnicEncoder encLeft, encRight;
+  MotorGains gains;
+  float integLeft = 0, integRight = 0;
+
+  // Hız setpoint'i (profil çıkışı) -> duty. Doyumda integral büyümez (anti-windup).
+  float speedLoop(float sp, float meas, float& integ, float dt) {
+    if (sp == 0.0f && fabsf(meas) < 4.0f) { integ = 0.0f; return 0.0f; }
+
+    float e = sp - meas;
+    float u = gains.kff * sp + gains.kp * e + integ;
+    bool saturated = (u > 255.0f && e > 0) || (u < -255.0f && e < 0);
+    if (!saturated) {
+      integ += gains.ki * e * dt;
+      integ = constrain(integ, -gains.iLimit, gains.iLimit);
+    }
+    return constrain(u, -255.0f, 255.0f);
+  }
+#endif
+
+#if defined(ARDUINO_ARCH_ESP32)
+  portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+  esp_timer_handle_t timer = nullptr;
+  int64_t lastTickUs = 0;
+  void lock()   { portENTER_CRITICAL(&mux); }
+  void unlock() { portEXIT_CRITICAL(&mux); }
+
+  static void onTick(void* arg) {
+    EnicMotor* m = (EnicMotor*)arg;
+    int64_t now = esp_timer_get_time();
+    uint32_t dt = m->lastTickUs ? (uint32_t)(now - m->lastTickUs) : MOTOR_TICK_US;
+    m->lastTickUs = now;
+    m->tick(dt);
+  }
+#else
+  // Host: update() geçen sanal süreyi sabit adımlarla işler
+  uint32_t lastUpdateUs = 0;
+  uint32_t pendingUs = 0;
+  void lock() {}
+  void unlock() {}
+#endif
 
   static inline int clamp255(int v) {
     if (v > 255) return 255;
@@ -38,10 +119,33 @@ private:
     return v;
   }
 
-  static inline int approach(int cur, int tgt, int step) {
-    if (cur < tgt) { cur += step; if (cur > tgt) cur = tgt; }
-    else if (cur > tgt) { cur -= step; if (cur < tgt) cur = tgt; }
-    return cur;
+  // Jerk sınırlı hedef takibi: ivme, kalan mesafede durabilecek değeri aşmaz (S-eğrisi);
+  // jerk = 0 ise ivme doğrudan limitte (trapez). Hedef ters yöne döndüyse eldeki ivme
+  // ölçeksiz jBrake ile söndürülür; yoksa küçük ölçekli eksen hedefi çok aşar.
+  static void stepAxis(float& v, float& a, float target, float aMax, float jMax, float jBrake, float dt) {
+    float err = target - v;
+    if (err == 0.0f && a == 0.0f) return;
+
+    float dir = err > 0 ? 1.0f : -1.0f;
+    float aDes = aMax;
+    if (jMax > 0.0f) {
+      float aStop = sqrtf(2.0f * jMax * fabsf(err));   // bu ivmeden sıfıra inerken kat edilen yol = err
+      if (aStop < aDes) aDes = aStop;
+    }
+    aDes *= dir;
+
+    if (jMax > 0.0f) {
+      float da = (a * dir < 0.0f ? jBrake : jMax) * dt;
+      if (a < aDes - da) a += da;
+      else if (a > aDes + da) a -= da;
+      else a = aDes;
+    } else {
+      a = aDes;
+    }
+
+    float nv = v + a * dt;
+    if ((target - nv) * dir <= 0.0f) { nv = target; a = 0.0f; }  // hedefi geçme
+    v = constrain(nv, -255.0f, 255.0f);
   }
 
   void writeMotor(int leftSpeed, int rightSpeed) {
@@ -57,6 +161,56 @@ private:
     else                { ledcWrite(M2_IN3_CH, 0);          ledcWrite(M2_IN4_CH, -rightSpeed); }
   }
 
+  // Sabit periyotlu kontrol adımı; iki teker aynı adımda hesaplanır ve birlikte yazılır
+  void tick(uint32_t dtUs) {
+    if (dtUs > 20000) dtUs = 20000;   // uzun duraklamadan sonra sıçrama yapma
+    float dt = dtUs * 1e-6f;
+
+#if ENIC_ENCODERS
+    // PCNT okuması kendi spinlock'unu alır: kritik bölge dışında
+    if (dtUs > 0) { encLeft.sample(dtUs); encRight.sample(dtUs); }
+#endif
+
+    lock();
+    bool stopping = stopRequested;
+    if (stopping) {
+      stopRequested = false;
+      prof.targetLeft = prof.targetRight = 0;
+      prof.velLeft = prof.velRight = 0;
+      prof.accLeft = prof.accRight = 0;
+    }
+    stepAxis(prof.velLeft,  prof.accLeft,  prof.targetLeft,  prof.maxAccel * scaleLeft,  prof.maxJerk * scaleLeft,  prof.maxJerk, dt);
+    stepAxis(prof.velRight, prof.accRight, prof.targetRight, prof.maxAccel * scaleRight, prof.maxJerk * scaleRight, prof.maxJerk, dt);
+    prof.ticks++;
+    if (dtUs > 2 * MOTOR_TICK_US) prof.lateTicks++;
+    if (dtUs > prof.maxTickUs) prof.maxTickUs = dtUs;
+
+    float ul = prof.velLeft, ur = prof.velRight;
+#if ENIC_ENCODERS
+    prof.measLeft  = encLeft.getCps()  * (255.0f / ENC_CPS_AT_FULL);
+    prof.measRight = encRight.getCps() * (255.0f / ENC_CPS_AT_FULL);
+    if (prof.closedLoop) {
+      if (stopping) {
+        integLeft = integRight = 0.0f;
+      } else {
+        ul = speedLoop(prof.velLeft,  prof.measLeft,  integLeft,  dt);
+        ur = speedLoop(prof.velRight, prof.measRight, integRight, dt);
+      }
+    }
+#endif
+    prof.dutyLeft = ul;
+    prof.dutyRight = ur;
+    int dl = (int)lroundf(ul);
+    int dr = (int)lroundf(ur);
+    unlock();
+
+    if (dl != lastDutyLeft || dr != lastDutyRight) {
+      writeMotor(dl, dr);
+      lastDutyLeft = dl;
+      lastDutyRight = dr;
+    }
+  }
+
 public:
   void begin() {
     pinMode(M1_IN1, OUTPUT); pinMode(M1_IN2, OUTPUT);
@@ -72,31 +226,144 @@ public:
     ledcAttachPin(M2_IN3, M2_IN3_CH);
     ledcAttachPin(M2_IN4, M2_IN4_CH);
 
-    stop();
+    writeMotor(0, 0);
+    lastDutyLeft = lastDutyRight = 0;
+
+#if ENIC_ENCODERS
+    pinMode(ENC_L_A, INPUT); pinMode(ENC_L_B, INPUT);
+    pinMode(ENC_R_A, INPUT); pinMode(ENC_R_B, INPUT);
+    encLeft.begin(0, ENC_L_A, ENC_L_B);
+    encRight.begin(1, ENC_R_A, ENC_R_B);
+    prof.closedLoop = true;
+#endif
+
+#if defined(ARDUINO_ARCH_ESP32)
+    if (!timer) {
+      esp_timer_create_args_t args = {};
+      args.callback = &EnicMotor::onTick;
+      args.arg = this;
+      args.dispatch_method = ESP_TIMER_TASK;
+      args.name = "enic_motor";
+      esp_timer_create(&args, &timer);
+      esp_timer_start_periodic(timer, MOTOR_TICK_US);
+    }
+#else
+    lastUpdateUs = nowUs32();
+#endif
   }
 
-  void setRampStep(int step) {
-    if (step < 1) step = 1;
-    if (step > 60) step = 60;
-    rampStep = step;
+  // accel: duty/s (>0), jerk: duty/s^2 (0: trapez)
+  void setLimits(float accel, float jerk) {
+    if (accel < 50.0f) accel = 50.0f;
+    if (jerk < 0.0f) jerk = 0.0f;
+    lock();
+    prof.maxAccel = accel;
+    prof.maxJerk = jerk;
+    unlock();
   }
 
+#if ENIC_ENCODERS
+  // Kapalı çevrim açık/kapalı (karşılaştırma / enkoder arızası için)
+  void setClosedLoop(bool on) {
+    lock();
+    prof.closedLoop = on;
+    integLeft = integRight = 0.0f;
+    unlock();
+  }
+
+  void setGains(const MotorGains& g) {
+    lock();
+    gains = g;
+    unlock();
+  }
+
+  int32_t getEncoderLeft() const  { return encLeft.getCount(); }
+  int32_t getEncoderRight() const { return encRight.getCount(); }
+#endif
+
   void drive(int leftSpeed, int rightSpeed) {
-    targetLeft  = clamp255(leftSpeed);
-    targetRight = clamp255(rightSpeed);
+    float tl = (float)clamp255(leftSpeed);
+    float tr = (float)clamp255(rightSpeed);
+
+    lock();
+    if (tl != prof.targetLeft || tr != prof.targetRight) {
+      prof.targetLeft = tl;
+      prof.targetRight = tr;
+      float el = fabsf(tl - prof.velLeft), er = fabsf(tr - prof.velRight);
+      float em = el > er ? el : er;
+      scaleLeft  = em > 0.0f ? el / em : 1.0f;
+      scaleRight = em > 0.0f ? er / em : 1.0f;
+      if (scaleLeft < 0.05f) scaleLeft = 0.05f;     // küçük düzeltmeler de sonlu sürede bitsin
+      if (scaleRight < 0.05f) scaleRight = 0.05f;
+    }
+    unlock();
+    if (tl != 0.0f || tr != 0.0f) unpark();
+  }
+
+  // Duran motorda 1 kHz tick'i durdur (light sleep'i engellemesin); drive() geri başlatır
+  void park() {
+    if (parked) return;
+    lock();
+    bool rest = prof.targetLeft == 0.0f && prof.targetRight == 0.0f && prof.velLeft == 0.0f &&
+                prof.velRight == 0.0f && prof.accLeft == 0.0f && prof.accRight == 0.0f && !stopRequested;
+    unlock();
+    if (!rest) return;
+    parked = true;
+#if defined(ARDUINO_ARCH_ESP32)
+    esp_timer_stop(timer);
+#endif
+  }
+
+  void unpark() {
+    if (!parked) return;
+    parked = false;
+#if defined(ARDUINO_ARCH_ESP32)
+    lastTickUs = 0;             // ilk tick'in dt'si park süresini içermesin
+    esp_timer_start_periodic(timer, MOTOR_TICK_US);
+#else
+    lastUpdateUs = nowUs32();
+    pendingUs = 0;
+#endif
   }
 
+  bool isParked() const { return parked; }
+
+  // Anında dur (rampasız); ESP32'de bir sonraki tick'te (<=1 ms) uygulanır
   void stop() {
-    targetLeft = targetRight = 0;
-    currentLeft = currentRight = 0;
-    writeMotor(0, 0);
+    lock();
+    stopRequested = true;
+    unlock();
+#if !defined(ARDUINO_ARCH_ESP32)
+    tick(0);
+#endif
   }
 
+  // ESP32'de kontrol esp_timer'da koşar; host build'de geçen süre 1 ms adımlarla işlenir
   void update() {
-    currentLeft  = approach(currentLeft,  targetLeft,  rampStep);
-    currentRight = approach(currentRight, targetRight, rampStep);
-    writeMotor(currentLeft, currentRight);
+#if !defined(ARDUINO_ARCH_ESP32)
+    if (parked) return;
+    uint32_t now = nowUs32();
+    pendingUs += now - lastUpdateUs;
+    lastUpdateUs = now;
+    if (pendingUs > 100000) pendingUs = 100000;
+    while (pendingUs >= MOTOR_TICK_US) {
+      tick(MOTOR_TICK_US);
+      pendingUs -= MOTOR_TICK_US;
+    }
+#endif
   }
+
+  MotorProfile getProfile() {
+    lock();
+    MotorProfile p = prof;
+    unlock();
+    return p;
+  }
+
+  int getTargetLeft() const  { return (int)prof.targetLeft; }
+  int getTargetRight() const { return (int)prof.targetRight; }
+  int getCurrentLeft() const  { return (int)lroundf(prof.velLeft); }
+  int getCurrentRight() const { return (int)lroundf(prof.velRight); }
 };
 
 #endif
\ No newline at end of file
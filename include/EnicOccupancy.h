@@ -0,0 +1,166 @@
+/**
+ * @file EnicOccupancy.h
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Fixed-size scrolling occupancy grid from sonar + free-space turn planner
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ *
+ * 32x32 hücre x 8 cm (2.56 m kare), hücre başına int8 log-odds; robot merkezden uzaklaşınca
+ * ızgara kaydırılır (heap yok, 1 KB). Her sonar örneği ışın boyunca boşluk, uçta engel yazar.
+ * planTurn(): ızgaradan kutupsal açıklık histogramı çıkarır, en az dönüşle en açık yönü seçer.
+ */
+#ifndef ENIC_OCCUPANCY_H
+#define ENIC_OCCUPANCY_H
+
+#include <Arduino.h>
+#include <math.h>
+#include "EnicPose.h"
+
+static const int   OCC_N = 32;
+static const float OCC_CELL_CM = 8.0f;
+static const float OCC_RANGE_CM = 150.0f;    // bundan uzak ölçümler "boş ışın" sayılır
+
+static const int8_t OCC_HIT = 3;
+static const int8_t OCC_MISS = 1;
+static const int8_t OCC_MAX = 12;
+static const int8_t OCC_MIN = -6;
+static const int8_t OCC_THRESH = 3;          // üstü dolu
+
+static const float OCC_BEAM_HALF = 0.13f;    // HC-SR04 ~15 derece koni, yarısı (rad)
+static const float OCC_SONAR_FWD_CM = 9.0f;  // sonar, teker ekseninin (poz merkezi) bu kadar önünde
+
+// Planlayıcı: aday dönüşler (derece) ve robot genişliği için yan ışınlar
+static const int   PLAN_STEP_DEG = 15;
+static const int   PLAN_MAX_DEG = 180;
+static const float PLAN_HALF_WIDTH_CM = 9.0f; // şasi yarı genişliği: yan ışınlar paralel kaydırılır
+static const float PLAN_CLEAR_CAP_CM = OCC_RANGE_CM;
+static const float PLAN_UNKNOWN_W = 0.25f;   // görülmemiş hücre, görülmüş boş hücrenin dörtte biri kadar
+static const float PLAN_TURN_COST = 0.25f;   // cm / derece: küçük dönüş tercih edilir
+
+class EnicOccupancy {
+private:
+  int8_t cell[OCC_N][OCC_N] = {};
+  int32_t originX = -OCC_N / 2;   // cell[0][0]'ın dünya hücre koordinatı
+  int32_t originY = -OCC_N / 2;
+
+  static int32_t worldCell(float cm) { return (int32_t)floorf(cm / OCC_CELL_CM); }
+
+  int8_t* at(int32_t wx, int32_t wy) {
+    int32_t i = wx - originX, j = wy - originY;
+    if (i < 0 || j < 0 || i >= OCC_N || j >= OCC_N) return nullptr;
+    return &cell[i][j];
+  }
+  int8_t get(int32_t wx, int32_t wy) const {
+    int32_t i = wx - originX, j = wy - originY;
+    if (i < 0 || j < 0 || i >= OCC_N || j >= OCC_N) return 0;   // bilinmiyor
+    return cell[i][j];
+  }
+
+  static void add(int8_t* c, int d) {
+    if (!c) return;
+    int v = *c + d;
+    *c = (int8_t)(v > OCC_MAX ? OCC_MAX : (v < OCC_MIN ? OCC_MIN : v));
+  }
+
+  // Yeni [i][j] = eski [i+dx][j+dy]; okuma yönü yazmanın önünde kalacak sırayla, yerinde
+  void shift(int dx, int dy) {
+    for (int ii = 0; ii < OCC_N; ii++) {
+      int i = dx >= 0 ? ii : OCC_N - 1 - ii;
+      for (int jj = 0; jj < OCC_N; jj++) {
+        int j = dy >= 0 ? jj : OCC_N - 1 - jj;
+        int si = i + dx, sj = j + dy;
+        cell[i][j] = (si >= 0 && sj >= 0 && si < OCC_N && sj < OCC_N) ? cell[si][sj] : 0;
+      }
+    }
+    originX += dx;
+    originY += dy;
+  }
+
+  // Robot ortadaki yarıdan çıktıysa ızgarayı robot merkezde olacak şekilde kaydır
+  void recenter(const Pose& p) {
+    int32_t rx = worldCell(p.xCm) - originX, ry = worldCell(p.yCm) - originY;
+    if (rx >= OCC_N / 4 && rx < 3 * OCC_N / 4 && ry >= OCC_N / 4 && ry < 3 * OCC_N / 4) return;
+    shift(rx - OCC_N / 2, ry - OCC_N / 2);
+  }
+
+public:
+  void clear() {
+    memset(cell, 0, sizeof(cell));
+    originX = originY = -OCC_N / 2;
+  }
+
+  // Bir sonar örneği: hit=false -> ışın boyunca (OCC_RANGE_CM'ye kadar) boş
+  void integrate(const Pose& p, float distCm, bool hit) {
+    recenter(p);
+    if (hit && distCm > OCC_RANGE_CM) hit = false;
+    float len = hit ? distCm : OCC_RANGE_CM;
+    float c = cosf(p.theta), s = sinf(p.theta);
+    float sx = p.xCm + OCC_SONAR_FWD_CM * c, sy = p.yCm + OCC_SONAR_FWD_CM * s;
+
+    // Boşluk: uçtan bir hücre önce dur (engel hücresini silme)
+    int32_t lastX = INT32_MIN, lastY = INT32_MIN;
+    for (float r = 0.0f; r < len - OCC_CELL_CM; r += OCC_CELL_CM * 0.5f) {
+      int32_t wx = worldCell(sx + r * c), wy = worldCell(sy + r * s);
+      if (wx == lastX && wy == lastY) continue;
+      lastX = wx; lastY = wy;
+      add(at(wx, wy), -OCC_MISS);
+    }
+    if (!hit) return;
+
+    // Engel koninin neresinde bilinmiyor: uç yayına üç nokta
+    for (int k = -1; k <= 1; k++) {
+      float a = p.theta + k * OCC_BEAM_HALF;
+      add(at(worldCell(sx + distCm * cosf(a)), worldCell(sy + distCm * sinf(a))), OCC_HIT);
+    }
+  }
+
+  // (x, y)'den 'bearing' yönünde ilk dolu hücreye kadar ağırlıklı boşluk skoru (cm cinsinden, planTurn için):
+  // görülmüş boş hücre tam adım, bilinmeyen (0) hücre PLAN_UNKNOWN_W katı sayılır. Mesafe değil; üst sınır maxCm.
+  float clearance(float x, float y, float bearing, float maxCm) const {
+    float c = cosf(bearing), s = sinf(bearing);
+    const float step = OCC_CELL_CM * 0.5f;
+    float score = 0.0f;
+    for (float r = step; r < maxCm; r += step) {
+      int8_t v = get(worldCell(x + r * c), worldCell(y + r * s));
+      if (v > OCC_THRESH) return score;
+      score += v < 0 ? step : step * PLAN_UNKNOWN_W;
+    }
+    return score;
+  }
+  float clearance(const Pose& p, float bearing, float maxCm) const {
+    return clearance(p.xCm, p.yCm, bearing, maxCm);
+  }
+
+  // En iyi dönüş (rad, + sola). Kutupsal histogram: her aday için robot genişliğini
+  // kapsayan üç ışının en kısası; skor = açıklık - dönüş maliyeti.
+  float planTurn(const Pose& p) const {
+    float best = (float)M_PI;
+    float bestScore = -1e9f;
+    for (int deg = PLAN_STEP_DEG * 2; deg <= PLAN_MAX_DEG; deg += PLAN_STEP_DEG) {
+      for (int sgn = -1; sgn <= 1; sgn += 2) {
+        if (deg == PLAN_MAX_DEG && sgn < 0) continue;   // 180 tek aday
+        float off = sgn * deg * (float)DEG_TO_RAD;
+        float b = p.theta + off;
+        float nx = -sinf(b) * PLAN_HALF_WIDTH_CM, ny = cosf(b) * PLAN_HALF_WIDTH_CM;
+        float clear = clearance(p, b, PLAN_CLEAR_CAP_CM);
+        float l = clearance(p.xCm + nx, p.yCm + ny, b, PLAN_CLEAR_CAP_CM);
+        float r = clearance(p.xCm - nx, p.yCm - ny, b, PLAN_CLEAR_CAP_CM);
+        if (l < clear) clear = l;
+        if (r < clear) clear = r;
+        float score = clear - PLAN_TURN_COST * deg;
+        if (score > bestScore) { bestScore = score; best = off; }
+      }
+    }
+    return best;
+  }
+
+  int occupiedCells() const {
+    int n = 0;
+    for (int i = 0; i < OCC_N; i++)
+      for (int j = 0; j < OCC_N; j++) if (cell[i][j] > OCC_THRESH) n++;
+    return n;
+  }
+};
+
+#endif
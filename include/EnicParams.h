@@ -0,0 +1,464 @@
+/**
+ * @file EnicParams.h
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Typed parameter registry with bounds, JSON get/set/dump over serial, NVS persistence
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ *
+ * Ayarlanabilir tüm değerler tek bir EnicConfig yapısında; kayıt tablosu (PARAMS) her birine
+ * ad, tip, alan ofseti ve sınır verir. Sıcak yol tabloya bakmaz: FSM, governor, motor ve sense
+ * kendi kopyalarını okur, değişince EnicStateMachine::applyParams() günceller.
+ * Komutlar (kontrol task'ı, cevap tek satır JSON):
+ *   get [ad | önek]                       {"nav.auto_obs_enter":20,...}
+ *   set <ad> <değer> | set {"ad":değer,...} | set defaults
+ *   dump                                  parametre başına bir satır: tip, sınırlar, varsayılan
+ * JSON girişi ArduinoJson 7 ile sabit bir havuzda çözülür (heap yok; taşarsa NoMemory).
+ * Değerler NVS'e tek blob olarak yazılır (son değişiklikten 1 s sonra, log task'ında) ve
+ * açılışta tek getBytes ile okunur. Tablo düzeni değişince (ad / tip / ofset) eski blob yok sayılır.
+ */
+#ifndef ENIC_PARAMS_H
+#define ENIC_PARAMS_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <stddef.h>
+#include <ArduinoJson.h>
+#include <Preferences.h>
+#include "EnicTime.h"
+#include "EnicMem.h"
+#include "EnicGovernor.h"
+
+// Engel eşikleri ve kaçış süreleri (cm / ms / duty). Çalışma anında değiştirilebilir ki
+// simülatör (src/native/EnicSim) taransın; varsayılanlar sahada ayarlanmış değerler.
+struct NavTuning {
+  float autoObsEnter = 20.0f;
+  float autoObsExit  = 28.0f;
+  float avoidEarlyClear = 35.0f;          // bu açıklıkta kısa geri + kısa dönüş
+  float avoidTurnLead = 0.35f;            // rad: dönüşün rampayla durana kadar döndüğü açı
+  float manualObsLimit = 15.0f;
+  float manualClearLimit = 25.0f;
+  uint16_t avoidPauseMs = 250;            // dur + şaşır
+  uint16_t avoidBackMs = 480;
+  uint16_t avoidBackShortMs = 220;
+  uint16_t avoidTurnMinMs = 420, avoidTurnMaxMs = 780;           // rastgele kaçış
+  uint16_t avoidTurnShortMinMs = 180, avoidTurnShortMaxMs = 320;
+  uint16_t avoidScanMaxMs = 2500;         // planlı kaçış: etrafa bakış emniyet sınırı
+  uint16_t avoidSettleMs = 300;
+  int16_t  avoidDuty = 180;               // geri ve yerinde dönüş
+};
+
+// Önbellek yapısı: NVS blob'u da budur
+struct EnicConfig {
+  NavTuning nav;
+  int16_t gov[GOV_PARAM_COUNT];
+  int16_t autoSpeed = 130;                // AUTO, governor kapalıyken
+  int16_t manualSpeed = 200;              // ileri / geri, hız verilmezse
+  int16_t turnSpeed = 180;                // sol / sag, hız verilmezse
+  uint16_t pingMs = 40;
+  float filterAlpha = 0.6f, filterBeta = 0.2f, filterGateCm = 35.0f;
+  float motorAccel = MOTOR_ACCEL_DEFAULT, motorJerk = MOTOR_JERK_DEFAULT;
+  uint8_t powerSave = 1;
+
+  EnicConfig() {
+    for (int i = 0; i < GOV_PARAM_COUNT; i++) gov[i] = GOV_PARAMS[i].def;
+  }
+};
+
+enum ParamType : uint8_t { PARAM_F32, PARAM_I16, PARAM_U16, PARAM_U8 };
+
+struct ParamDef {
+  const char* name;
+  ParamType type;
+  uint16_t offset;
+  float lo, hi;
+};
+
+#define ENIC_PARAM(name, type, field, lo, hi) { name, type, (uint16_t)offsetof(EnicConfig, field), lo, hi }
+#define ENIC_GOV_PARAM(name, id) \
+  ENIC_PARAM(name, PARAM_I16, gov[id], (float)GOV_PARAMS[id].lo, (float)GOV_PARAMS[id].hi)
+
+inline constexpr ParamDef PARAMS[] = {
+  ENIC_PARAM("nav.auto_obs_enter",          PARAM_F32, nav.autoObsEnter,        5.0f,  150.0f),
+  ENIC_PARAM("nav.auto_obs_exit",           PARAM_F32, nav.autoObsExit,         5.0f,  200.0f),
+  ENIC_PARAM("nav.avoid_early_clear",       PARAM_F32, nav.avoidEarlyClear,     5.0f,  300.0f),
+  ENIC_PARAM("nav.avoid_turn_lead",         PARAM_F32, nav.avoidTurnLead,       0.0f,  1.5f),
+  ENIC_PARAM("nav.manual_obs_limit",        PARAM_F32, nav.manualObsLimit,      3.0f,  100.0f),
+  ENIC_PARAM("nav.manual_clear_limit",      PARAM_F32, nav.manualClearLimit,    3.0f,  150.0f),
+  ENIC_PARAM("nav.avoid_pause_ms",          PARAM_U16, nav.avoidPauseMs,        0.0f,  3000.0f),
+  ENIC_PARAM("nav.avoid_back_ms",           PARAM_U16, nav.avoidBackMs,         0.0f,  3000.0f),
+  ENIC_PARAM("nav.avoid_back_short_ms",     PARAM_U16, nav.avoidBackShortMs,    0.0f,  3000.0f),
+  ENIC_PARAM("nav.avoid_turn_min_ms",       PARAM_U16, nav.avoidTurnMinMs,      50.0f, 5000.0f),
+  ENIC_PARAM("nav.avoid_turn_max_ms",       PARAM_U16, nav.avoidTurnMaxMs,      50.0f, 5000.0f),
+  ENIC_PARAM("nav.avoid_turn_short_min_ms", PARAM_U16, nav.avoidTurnShortMinMs, 50.0f, 5000.0f),
+  ENIC_PARAM("nav.avoid_turn_short_max_ms", PARAM_U16, nav.avoidTurnShortMaxMs, 50.0f, 5000.0f),
+  ENIC_PARAM("nav.avoid_scan_max_ms",       PARAM_U16, nav.avoidScanMaxMs,      500.0f, 10000.0f),
+  ENIC_PARAM("nav.avoid_settle_ms",         PARAM_U16, nav.avoidSettleMs,       0.0f,  3000.0f),
+  ENIC_PARAM("nav.avoid_duty",              PARAM_I16, nav.avoidDuty,           60.0f, 255.0f),
+  ENIC_GOV_PARAM("gov.enable",      GOV_ENABLE),
+  ENIC_GOV_PARAM("gov.cruise",      GOV_CRUISE),
+  ENIC_GOV_PARAM("gov.min_duty",    GOV_MIN_DUTY),
+  ENIC_GOV_PARAM("gov.slow_cm",     GOV_SLOW_CM),
+  ENIC_GOV_PARAM("gov.full_cm",     GOV_FULL_CM),
+  ENIC_GOV_PARAM("gov.ttc_ms",      GOV_TTC_MS),
+  ENIC_GOV_PARAM("gov.stop_cm",     GOV_STOP_CM),
+  ENIC_GOV_PARAM("gov.stop_ttc_ms", GOV_STOP_TTC_MS),
+  ENIC_PARAM("speed.auto",                  PARAM_I16, autoSpeed,               60.0f, 255.0f),
+  ENIC_PARAM("speed.manual",                PARAM_I16, manualSpeed,             60.0f, 255.0f),
+  ENIC_PARAM("speed.turn",                  PARAM_I16, turnSpeed,               60.0f, 255.0f),
+  ENIC_PARAM("sense.ping_ms",               PARAM_U16, pingMs,                  30.0f, 1000.0f),
+  ENIC_PARAM("filter.alpha",                PARAM_F32, filterAlpha,             0.05f, 1.0f),
+  ENIC_PARAM("filter.beta",                 PARAM_F32, filterBeta,              0.0f,  1.0f),
+  ENIC_PARAM("filter.gate_cm",              PARAM_F32, filterGateCm,            5.0f,  400.0f),
+  ENIC_PARAM("motor.accel",                 PARAM_F32, motorAccel,              50.0f, 20000.0f),
+  ENIC_PARAM("motor.jerk",                  PARAM_F32, motorJerk,               0.0f,  500000.0f),
+  ENIC_PARAM("power.enable",                PARAM_U8,  powerSave,               0.0f,  1.0f),
+};
+
+#undef ENIC_GOV_PARAM
+#undef ENIC_PARAM
+
+static const int PARAM_COUNT = (int)(sizeof(PARAMS) / sizeof(PARAMS[0]));
+
+// Blob düzeninin kimliği: ad + tip + ofset + yapı boyu (FNV-1a)
+constexpr uint32_t paramLayoutHash() {
+  uint32_t h = 2166136261UL;
+  for (int i = 0; i < PARAM_COUNT; i++) {
+    for (const char* s = PARAMS[i].name; *s; s++) { h ^= (uint8_t)*s; h *= 16777619UL; }
+    h ^= PARAMS[i].type;   h *= 16777619UL;
+    h ^= PARAMS[i].offset; h *= 16777619UL;
+  }
+  h ^= (uint32_t)sizeof(EnicConfig);
+  return h * 16777619UL;
+}
+
+inline constexpr uint32_t PARAM_LAYOUT = paramLayoutHash();
+
+inline float paramRead(const EnicConfig& c, const ParamDef& d) {
+  const uint8_t* p = (const uint8_t*)&c + d.offset;
+  switch (d.type) {
+    case PARAM_F32: { float v;    memcpy(&v, p, sizeof(v)); return v; }
+    case PARAM_I16: { int16_t v;  memcpy(&v, p, sizeof(v)); return v; }
+    case PARAM_U16: { uint16_t v; memcpy(&v, p, sizeof(v)); return v; }
+    default:        return *p;
+  }
+}
+
+// Sınıra kırpar, tam sayı tiplerde yuvarlar; yazılan değeri döner
+inline float paramWrite(EnicConfig& c, const ParamDef& d, float v) {
+  if (!(v >= d.lo)) v = d.lo;               // NaN da alt sınıra
+  if (v > d.hi) v = d.hi;
+  uint8_t* p = (uint8_t*)&c + d.offset;
+  switch (d.type) {
+    case PARAM_F32: memcpy(p, &v, sizeof(v)); return v;
+    case PARAM_I16: { int16_t x = (int16_t)lroundf(v);  memcpy(p, &x, sizeof(x)); return x; }
+    case PARAM_U16: { uint16_t x = (uint16_t)lroundf(v); memcpy(p, &x, sizeof(x)); return x; }
+    default:        *p = (uint8_t)lroundf(v); return *p;
+  }
+}
+
+#ifndef ENIC_PARAM_JSON_POOL
+#define ENIC_PARAM_JSON_POOL 2048
+#endif
+
+static const uint32_t PARAM_SAVE_DELAY_MS = 1000;   // art arda set'ler tek yazmada birleşir
+
+// ArduinoJson 7 için sabit tampon: bump ayırıcı, her komutta reset(). Dolunca nullptr -> NoMemory.
+class EnicJsonPool : public ArduinoJson::Allocator {
+private:
+  static const size_t ALIGN = 8;
+  alignas(8) uint8_t buf[ENIC_PARAM_JSON_POOL];
+  size_t used = 0;
+  size_t highWater = 0;
+
+  // Her bloğun önünde boyu (reallocate kopyalayabilsin)
+  static size_t round(size_t n) { return (n + ALIGN - 1) & ~(ALIGN - 1); }
+  static size_t& sizeOf(void* p) { return *(size_t*)((uint8_t*)p - ALIGN); }
+
+public:
+  void* allocate(size_t n) override {
+    size_t need = ALIGN + round(n);
+    if (used + need > sizeof(buf)) return nullptr;
+    uint8_t* p = buf + used + ALIGN;
+    used += need;
+    if (used > highWater) highWater = used;
+    sizeOf(p) = n;
+    return p;
+  }
+
+  void deallocate(void* p) override {
+    if (p && (uint8_t*)p + round(sizeOf(p)) == buf + used) used -= ALIGN + round(sizeOf(p));   // sadece son blok geri alınır
+  }
+
+  void* reallocate(void* p, size_t n) override {
+    if (!p) return allocate(n);
+    size_t old = sizeOf(p);
+    if ((uint8_t*)p + round(old) == buf + used) {            // son blok: yerinde büyüt / küçült
+      size_t start = (uint8_t*)p - buf;
+      if (start + round(n) > sizeof(buf)) return nullptr;
+      used = start + round(n);
+      if (used > highWater) highWater = used;
+      sizeOf(p) = n;
+      return p;
+    }
+    void* q = allocate(n);
+    if (q) memcpy(q, p, old < n ? old : n);
+    return q;
+  }
+
+  void reset() { used = 0; }
+  size_t getHighWater() const { return highWater; }
+  size_t capacity() const { return sizeof(buf); }
+};
+
+class EnicParams {
+public:
+  struct ParamStats {
+    uint32_t sets = 0;          // uygulanan değer
+    uint32_t rejected = 0;      // bilinmeyen ad / hatalı değer / JSON hatası
+    uint32_t clamped = 0;       // sınıra kırpılan değer
+    uint32_t saves = 0;
+    uint32_t saveErrors = 0;
+  };
+
+  enum LoadResult : uint8_t { LOAD_DEFAULTS, LOAD_NVS, LOAD_STALE, LOAD_CORRUPT };
+
+private:
+  struct Blob {
+    uint32_t layout;
+    uint32_t sum;
+    EnicConfig cfg;
+  };
+
+  // ---- kontrol task'ı ----
+  EnicConfig cfg;
+  uint32_t gen = 1;
+  EnicJsonPool pool;
+  ParamStats stats;
+  LoadResult loaded = LOAD_DEFAULTS;
+
+  // ---- log task'ı: kalıcı kopya (seqlock) ----
+  EnicConfig shared;
+  std::atomic<uint32_t> seq{0};
+  std::atomic<bool> dirty{false};
+  std::atomic<uint32_t> dirtyAtMs{0};
+  Preferences prefs;
+  bool nvsOk = false;
+
+  static uint32_t checksum(const EnicConfig& c) {
+    const uint8_t* p = (const uint8_t*)&c;
+    uint32_t h = 2166136261UL;
+    for (size_t i = 0; i < sizeof(c); i++) { h ^= p[i]; h *= 16777619UL; }
+    return h;
+  }
+
+  // Kontrol task'ı yazdı: kalıcı kopyayı güncelle, kayıt zamanlayıcısını kur
+  void publish(uint32_t nowMs) {
+    gen++;
+    seq.fetch_add(1, std::memory_order_acq_rel);              // tek: yazılıyor
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(&shared, &cfg, sizeof(cfg));
+    seq.fetch_add(1, std::memory_order_release);
+    dirtyAtMs.store(nowMs, std::memory_order_relaxed);
+    dirty.store(true, std::memory_order_release);
+  }
+
+  bool apply(const ParamDef& d, float v, float& out) {
+    if (isnan(v)) { stats.rejected++; return false; }
+    out = paramWrite(cfg, d, v);
+    if (out != v) stats.clamped++;
+    stats.sets++;
+    return true;
+  }
+
+  static void printValue(Print& out, const ParamDef& d, float v) {
+    if (d.type == PARAM_F32) enicPrintf(out, "%.6g", v);
+    else enicPrintf(out, "%ld", (long)v);
+  }
+
+  static const char* typeName(ParamType t) {
+    switch (t) {
+      case PARAM_F32: return "float";
+      case PARAM_I16: return "i16";
+      case PARAM_U16: return "u16";
+      default:        return "u8";
+    }
+  }
+
+  void printError(Print& out, const char* err, const char* name) {
+    stats.rejected++;
+    for (const char* c = name; c && *c; c++) {
+      if (!isalnum((unsigned char)*c) && *c != '.' && *c != '_') { name = nullptr; break; }   // JSON'a kaçışsız
+    }
+    if (name) enicPrintf(out, "{\"ok\":false,\"err\":\"%s\",\"name\":\"%.40s\"}\n", err, name);
+    else enicPrintf(out, "{\"ok\":false,\"err\":\"%s\"}\n", err);
+  }
+
+  // set {"ad":değer,...}: önce hepsi doğrulanır, sonra uygulanır (yarım set yok)
+  bool setJson(Print& out, const char* text, uint32_t nowMs) {
+    pool.reset();
+    JsonDocument doc(&pool);
+    DeserializationError err = deserializeJson(doc, text);
+    if (err) { printError(out, err.c_str(), nullptr); return false; }
+    JsonObjectConst obj = doc.as<JsonObjectConst>();
+    if (obj.isNull()) { printError(out, "not an object", nullptr); return false; }
+
+    for (JsonPairConst kv : obj) {
+      if (!find(kv.key().c_str())) { printError(out, "unknown", kv.key().c_str()); return false; }
+      if (!kv.value().is<float>() && !kv.value().is<bool>()) { printError(out, "not a number", kv.key().c_str()); return false; }
+    }
+
+    out.print("{\"ok\":true");
+    for (JsonPairConst kv : obj) {
+      const ParamDef& d = *find(kv.key().c_str());
+      JsonVariantConst v = kv.value();
+      float applied = 0.0f;
+      apply(d, v.is<bool>() ? (v.as<bool>() ? 1.0f : 0.0f) : v.as<float>(), applied);
+      enicPrintf(out, ",\"%s\":", d.name);
+      printValue(out, d, applied);
+    }
+    out.println("}");
+    publish(nowMs);
+    return true;
+  }
+
+public:
+  // NVS'den tek okuma; geçersiz / eski düzen blob'unda varsayılanlar
+  LoadResult begin() {
+    nvsOk = prefs.begin("enic", false);
+    Blob b;
+    size_t n = nvsOk ? prefs.getBytes("cfg", &b, sizeof(b)) : 0;
+    if (n == 0) loaded = LOAD_DEFAULTS;
+    else if (n != sizeof(b) || b.layout != PARAM_LAYOUT) loaded = LOAD_STALE;
+    else if (b.sum != checksum(b.cfg)) loaded = LOAD_CORRUPT;
+    else {
+      cfg = b.cfg;
+      for (const ParamDef& d : PARAMS) paramWrite(cfg, d, paramRead(cfg, d));   // sınırlar değiştiyse
+      loaded = LOAD_NVS;
+    }
+    memcpy(&shared, &cfg, sizeof(cfg));
+    return loaded;
+  }
+
+  const EnicConfig& get() const { return cfg; }
+  uint32_t generation() const { return gen; }
+  LoadResult getLoadResult() const { return loaded; }
+
+  static const ParamDef* find(const char* name) {
+    for (const ParamDef& d : PARAMS) if (strcmp(d.name, name) == 0) return &d;
+    return nullptr;
+  }
+
+  // Tek değer (kısayol komutları: ping, gov, pwr); cevap yazmaz
+  bool set(const char* name, float v, uint32_t nowMs) {
+    const ParamDef* d = find(name);
+    float applied = 0.0f;
+    if (!d || !apply(*d, v, applied)) { if (!d) stats.rejected++; return false; }
+    publish(nowMs);
+    return true;
+  }
+
+  void setDefaults(uint32_t nowMs) {
+    cfg = EnicConfig();
+    publish(nowMs);
+  }
+
+  // ================= Komutlar (kontrol task'ı) =================
+  // get: hepsi; get <ad>: tek; get <önek>: "nav" -> nav.*
+  void printGet(Print& out, const char* arg) {
+    size_t n = arg ? strlen(arg) : 0;
+    bool any = false;
+    out.print("{");
+    for (const ParamDef& d : PARAMS) {
+      if (n && !(strncmp(d.name, arg, n) == 0 && (d.name[n] == '\0' || d.name[n] == '.'))) continue;
+      enicPrintf(out, "%s\"%s\":", any ? "," : "", d.name);
+      printValue(out, d, paramRead(cfg, d));
+      any = true;
+    }
+    out.println("}");
+    if (!any) stats.rejected++;
+  }
+
+  // Değer değiştiyse true (çağıran uygular)
+  bool handleSet(Print& out, char* arg, uint32_t nowMs) {
+    if (!arg || !*arg) { printError(out, "usage: set <name> <value> | set {json} | set defaults", nullptr); return false; }
+    if (*arg == '{') return setJson(out, arg, nowMs);
+    if (strcmp(arg, "defaults") == 0) {
+      setDefaults(nowMs);
+      out.println("{\"ok\":true,\"defaults\":true}");
+      return true;
+    }
+
+    char* name = arg;
+    char* val = name;
+    while (*val && *val != ' ' && *val != '\t') val++;
+    if (*val) *val++ = '\0';
+    while (*val == ' ' || *val == '\t') val++;
+
+    const ParamDef* d = find(name);
+    if (!d) { printError(out, "unknown", name); return false; }
+    char* end = nullptr;
+    float v = strtof(val, &end);
+    if (end == val || *end != '\0') { printError(out, "not a number", name); return false; }
+
+    float applied = 0.0f;
+    apply(*d, v, applied);
+    enicPrintf(out, "{\"ok\":true,\"%s\":", d->name);
+    printValue(out, *d, applied);
+    out.println("}");
+    publish(nowMs);
+    return true;
+  }
+
+  // Parametre başına bir satır + özet
+  void printDump(Print& out) const {
+    static const EnicConfig DEFAULTS;
+    for (const ParamDef& d : PARAMS) {
+      enicPrintf(out, "{\"name\":\"%s\",\"type\":\"%s\",\"value\":", d.name, typeName(d.type));
+      printValue(out, d, paramRead(cfg, d));
+      out.print(",\"min\":");
+      printValue(out, d, d.lo);
+      out.print(",\"max\":");
+      printValue(out, d, d.hi);
+      out.print(",\"default\":");
+      printValue(out, d, paramRead(DEFAULTS, d));
+      out.println("}");
+    }
+    static const char* const LOAD[] = { "defaults", "nvs", "stale", "corrupt" };
+    enicPrintf(out, "{\"params\":%d,\"bytes\":%u,\"loaded\":\"%s\",\"nvs\":%s,\"pending_save\":%s,\"sets\":%lu,"
+                    "\"rejected\":%lu,\"clamped\":%lu,\"saves\":%lu,\"save_errors\":%lu,\"json_pool\":%u,\"json_pool_hwm\":%u}\n",
+                    PARAM_COUNT, (unsigned)sizeof(EnicConfig), LOAD[loaded], nvsOk ? "true" : "false",
+                    dirty.load() ? "true" : "false", (unsigned long)stats.sets, (unsigned long)stats.rejected,
+                    (unsigned long)stats.clamped, (unsigned long)stats.saves, (unsigned long)stats.saveErrors,
+                    (unsigned)pool.capacity(), (unsigned)pool.getHighWater());
+  }
+
+  // ================= Log task'ı =================
+  // Son değişiklikten PARAM_SAVE_DELAY_MS sonra tek blob yazar; yazdıysa true
+  bool saveIfDue(uint32_t nowMs) {
+    if (!dirty.load(std::memory_order_acquire)) return false;
+    if (!timeReached(nowMs, dirtyAtMs.load(std::memory_order_relaxed) + PARAM_SAVE_DELAY_MS)) return false;
+    dirty.store(false, std::memory_order_release);   // kopyalarken gelen set tekrar işaretler
+
+    Blob b;
+    uint32_t s0, s1 = 0;
+    do {
+      s0 = seq.load(std::memory_order_acquire);
+      if (s0 & 1) continue;
+      memcpy(&b.cfg, &shared, sizeof(b.cfg));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      s1 = seq.load(std::memory_order_relaxed);
+    } while ((s0 & 1) || s0 != s1);
+
+    b.layout = PARAM_LAYOUT;
+    b.sum = checksum(b.cfg);
+    if (!nvsOk || prefs.putBytes("cfg", &b, sizeof(b)) != sizeof(b)) { stats.saveErrors++; return false; }
+    stats.saves++;
+    return true;
+  }
+
+  bool savePending() const { return dirty.load(std::memory_order_relaxed); }
+  const ParamStats& getStats() const { return stats; }
+};
+
+#endif
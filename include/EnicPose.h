@@ -0,0 +1,93 @@
+/**
+ * @file EnicPose.h
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Dead-reckoned planar pose (x, y, heading) from wheel encoders or commanded duty
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ *
+ * Enkoder varsa (ENIC_ENCODERS) sayım farklarından, yoksa EnicMotor'un uygulanan duty'sinden
+ * hız modeliyle. Sadece yerel harita için: dakikalar içinde kayar, mutlak konum iddiası yok.
+ */
+#ifndef ENIC_POSE_H
+#define ENIC_POSE_H
+
+#include <Arduino.h>
+#include <math.h>
+#include "EnicMotor.h"
+
+// Teker hızı @ duty 255 (mm/s) ve tekerler arası (mm); şasiye göre ayarlayın
+#ifndef POSE_MM_S_AT_FULL
+#define POSE_MM_S_AT_FULL 400.0f
+#endif
+#ifndef POSE_WHEEL_BASE_MM
+#define POSE_WHEEL_BASE_MM 120.0f
+#endif
+
+// ENC_CPS_AT_FULL sayım/s <-> POSE_MM_S_AT_FULL
+static const float POSE_MM_PER_COUNT = POSE_MM_S_AT_FULL / ENC_CPS_AT_FULL;
+
+struct Pose {
+  float xCm = 0.0f;
+  float yCm = 0.0f;
+  float theta = 0.0f;     // rad, (-pi, pi]
+};
+
+// Açı farkını (-pi, pi] aralığına indir
+inline float wrapAngle(float a) {
+  while (a > (float)M_PI) a -= 2.0f * (float)M_PI;
+  while (a <= -(float)M_PI) a += 2.0f * (float)M_PI;
+  return a;
+}
+
+class EnicPose {
+private:
+  Pose pose;
+  uint32_t lastMs = 0;
+  bool started = false;
+#if ENIC_ENCODERS
+  int32_t lastL = 0, lastR = 0;
+#endif
+
+  void integrate(float dlMm, float drMm) {
+    float ds = 0.5f * (dlMm + drMm) * 0.1f;                  // cm
+    float dth = (drMm - dlMm) / POSE_WHEEL_BASE_MM;
+    float mid = pose.theta + 0.5f * dth;
+    pose.xCm += ds * cosf(mid);
+    pose.yCm += ds * sinf(mid);
+    pose.theta = wrapAngle(pose.theta + dth);
+  }
+
+public:
+  void reset(const EnicMotor& motor, uint32_t now) {
+    pose = Pose();
+    lastMs = now;
+    started = true;
+#if ENIC_ENCODERS
+    lastL = motor.getEncoderLeft();
+    lastR = motor.getEncoderRight();
+#else
+    (void)motor;
+#endif
+  }
+
+  // FSM tick'inde çağrılır
+  void update(const EnicMotor& motor, uint32_t now) {
+    if (!started) { reset(motor, now); return; }
+#if ENIC_ENCODERS
+    int32_t l = motor.getEncoderLeft(), r = motor.getEncoderRight();
+    integrate((float)(l - lastL) * POSE_MM_PER_COUNT, (float)(r - lastR) * POSE_MM_PER_COUNT);
+    lastL = l;
+    lastR = r;
+#else
+    float dt = (float)(now - lastMs) * 1e-3f;
+    const float k = POSE_MM_S_AT_FULL / 255.0f * dt;
+    integrate((float)motor.getCurrentLeft() * k, (float)motor.getCurrentRight() * k);
+#endif
+    lastMs = now;
+  }
+
+  const Pose& get() const { return pose; }
+};
+
+#endif
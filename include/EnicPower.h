@@ -0,0 +1,277 @@
+/**
+ * @file EnicPower.h
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Power manager: ACTIVE/IDLE modes, CPU frequency scaling, light sleep, current estimate
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ *
+ * Alt sistemler "tutma" bitleriyle ACTIVE ister (FSM hareket / ses / telemetri); hiçbiri
+ * tutmuyorsa POWER_IDLE_AFTER_MS sonra IDLE. IDLE'da CPU 80 MHz, task'lar sabit periyot yerine
+ * bir sonraki olaya kadar uyur (EnicTasks), motor tick'i park edilir, sonar seyrek ping atar.
+ * ESP32: esp_pm (DFS + tickless idle'da otomatik light sleep, UART RX ile uyanma); esp_pm yoksa
+ * setCpuFrequencyMhz. Mod kararı sadece kontrol task'ında (update); hold/kick her task'tan.
+ * Akım tahmini ESP32 veri sayfası aralıklarından (WiFi/BT kapalı) + kart tabanı, motorlar hariç.
+ */
+#ifndef ENIC_POWER_H
+#define ENIC_POWER_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "EnicTime.h"
+#include "EnicMem.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include "esp_pm.h"
+#include "esp_sleep.h"
+#include "driver/uart.h"
+#endif
+
+#ifndef ENIC_BATTERY_MAH
+#define ENIC_BATTERY_MAH 2000
+#endif
+
+enum PowerMode : uint8_t { PWR_ACTIVE, PWR_IDLE, PWR_MODE_COUNT };
+
+// ACTIVE tutan sebepler (bit)
+enum PowerHold : uint8_t {
+  PWR_HOLD_FSM   = 1,   // IDLE dışı durum veya dönen teker
+  PWR_HOLD_SOUND = 2,   // buzzer çalıyor (LEDC light sleep'te durur)
+  PWR_HOLD_LINK  = 4,   // telemetri akışı açık
+};
+
+static const uint16_t POWER_ACTIVE_MHZ = 240;
+static const uint16_t POWER_IDLE_MHZ = 80;          // APB 80 MHz kalır: UART / LEDC / I2C etkilenmez
+static const uint32_t POWER_IDLE_AFTER_MS = 2000;   // son tutma / RX'ten sonra bu kadar sakin -> IDLE
+static const uint16_t POWER_IDLE_MAX_WAIT_MS = 100; // IDLE'da bir task'ın en uzun uykusu
+static const uint16_t POWER_SENSE_IDLE_MS = 20;
+static const uint16_t POWER_LOG_IDLE_MS = 500;
+static const uint16_t POWER_IDLE_PING_MS = 200;     // IDLE'da sonar aralığı (kullanıcınınki daha uzunsa o)
+
+// Akım modeli (mA). CPU: iki çekirdek waiti'de taban + meşgul çekirdek başına ek
+struct PowerCpuModel { uint16_t mhz; float baseMa; float perCoreMa; };
+static const PowerCpuModel POWER_CPU_MODEL[] = { { 240, 30.0f, 19.0f }, { 160, 27.0f, 8.5f }, { 80, 20.0f, 5.5f } };
+static const float POWER_LIGHT_SLEEP_MA = 0.8f;
+static const float POWER_BOARD_MA = 14.0f;          // OLED (~10) + HC-SR04 (~2) + LDO
+static const uint32_t POWER_WAKE_US = 60;           // task uyanışı başına bağlam + saat geçişi
+
+class EnicPower {
+public:
+  struct ModeStats {
+    uint64_t wallUs = 0;
+    uint64_t busyUs = 0;        // task adımlarının toplamı (iki çekirdek)
+    uint64_t noSleepUs = 0;     // ping uçuşta: light sleep yasak
+    uint32_t wakeups = 0;       // task aktivasyonu
+    uint32_t entries = 0;
+  };
+
+  struct Estimate {
+    float dutyPct;              // meşgul çekirdek-zamanı / (2 x süre)
+    float sleepPct;             // light sleep'te geçen süre
+    float idlePct;              // PWR_IDLE'da geçen süre
+    float wakeupsPerS;
+    float mA;
+    float hours;                // ENIC_BATTERY_MAH ile
+  };
+
+private:
+  std::atomic<uint8_t> mode{PWR_ACTIVE};
+  std::atomic<uint8_t> holds{0};
+  std::atomic<bool> kicked{false};
+  std::atomic<uint32_t> pendingBusyUs{0};
+  std::atomic<uint32_t> pendingWakeups{0};
+  std::atomic<uint32_t> pendingNoSleepUs{0};
+
+  bool enabled = true;
+  bool pmOk = false;            // DFS (esp_pm) var
+  bool sleepOk = false;         // otomatik light sleep var
+  uint32_t calmSinceMs = 0;
+  uint32_t lastUs = 0;
+  uint32_t noSleepSinceUs = 0;  // sense task
+  uint32_t rxWakes = 0;
+  ModeStats stats[PWR_MODE_COUNT];
+
+#if defined(ARDUINO_ARCH_ESP32)
+  esp_pm_lock_handle_t lockCpu = nullptr, lockAwake = nullptr, lockPing = nullptr;
+#endif
+
+  static const PowerCpuModel& cpuModel(uint16_t mhz) {
+    for (const PowerCpuModel& m : POWER_CPU_MODEL) if (m.mhz == mhz) return m;
+    return POWER_CPU_MODEL[0];
+  }
+
+  uint16_t modeMhz(uint8_t m) const { return m == PWR_IDLE ? POWER_IDLE_MHZ : POWER_ACTIVE_MHZ; }
+
+  void apply(PowerMode m) {
+#if defined(ARDUINO_ARCH_ESP32)
+    if (pmOk) {
+      if (m == PWR_ACTIVE) { esp_pm_lock_acquire(lockCpu); esp_pm_lock_acquire(lockAwake); }
+      else                 { esp_pm_lock_release(lockCpu); esp_pm_lock_release(lockAwake); }
+    } else {
+      setCpuFrequencyMhz(modeMhz(m));
+    }
+#endif
+    mode.store(m);
+    stats[m].entries++;
+  }
+
+  // Bekleyen sayaçları şu anki moda yaz
+  void account() {
+    uint32_t now = nowUs32();
+    ModeStats& s = stats[mode.load()];
+    s.wallUs += now - lastUs;
+    s.busyUs += pendingBusyUs.exchange(0);
+    s.wakeups += pendingWakeups.exchange(0);
+    s.noSleepUs += pendingNoSleepUs.exchange(0);
+    lastUs = now;
+  }
+
+public:
+  void begin() {
+#if defined(ARDUINO_ARCH_ESP32)
+    esp_pm_config_esp32_t cfg = {};
+    cfg.max_freq_mhz = POWER_ACTIVE_MHZ;
+    cfg.min_freq_mhz = POWER_IDLE_MHZ;
+    cfg.light_sleep_enable = true;
+    esp_err_t err = esp_pm_configure(&cfg);
+    if (err != ESP_OK) {          // tickless idle derlenmemiş: sadece DFS
+      cfg.light_sleep_enable = false;
+      err = esp_pm_configure(&cfg);
+    }
+    pmOk = err == ESP_OK;
+    sleepOk = pmOk && cfg.light_sleep_enable;
+    if (pmOk) {
+      esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "enic_active", &lockCpu);
+      esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "enic_awake", &lockAwake);
+      esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "enic_ping", &lockPing);
+    }
+    if (sleepOk) {
+      // Uyandıran kenarlar (ve uyanırken gelen birkaç bayt) kaybolur: host önce '\n' yollar
+      uart_set_wakeup_threshold(UART_NUM_0, 3);
+      esp_sleep_enable_uart_wakeup(0);
+    }
+#else
+    pmOk = sleepOk = true;        // host: tickless idle'lı cihaz derlemesi modellenir
+#endif
+    calmSinceMs = nowMs32();
+    lastUs = nowUs32();
+    apply(PWR_ACTIVE);
+  }
+
+  // ---------------- Her task ----------------
+  void hold(PowerHold h, bool on) {
+    if (on) holds.fetch_or(h);
+    else holds.fetch_and((uint8_t)~h);
+  }
+
+  // UART RX: hemen ACTIVE (kontrol task'ı bir sonraki update'te uygular)
+  void kick() { kicked.store(true); }
+
+  bool isIdle() const { return mode.load() == PWR_IDLE; }
+  PowerMode getMode() const { return (PowerMode)mode.load(); }
+
+  void addBusy(uint32_t us) {
+    pendingBusyUs.fetch_add(us);
+    pendingWakeups.fetch_add(1);
+  }
+
+  // Sense task: echo ölçülürken light sleep yok (uyanma gecikmesi darbe genişliğini bozar)
+  void holdNoSleep(bool on) {
+#if defined(ARDUINO_ARCH_ESP32)
+    if (sleepOk) { if (on) esp_pm_lock_acquire(lockPing); else esp_pm_lock_release(lockPing); }
+#endif
+    uint32_t now = nowUs32();
+    if (on) noSleepSinceUs = now;
+    else pendingNoSleepUs.fetch_add(now - noSleepSinceUs);
+  }
+
+  // ---------------- Kontrol task'ı ----------------
+  // Mod kararı; mod değiştiyse true (uyuyan task'lar uyandırılmalı)
+  bool update(uint32_t nowMs) {
+    account();
+    bool kick = kicked.exchange(false);
+    if (kick && isIdle()) rxWakes++;
+
+    PowerMode want = getMode();
+    if (!enabled || holds.load() || kick) {
+      calmSinceMs = nowMs;
+      want = PWR_ACTIVE;
+    } else if (nowMs - calmSinceMs >= POWER_IDLE_AFTER_MS) {
+      want = PWR_IDLE;
+    }
+    if (want == getMode()) return false;
+    apply(want);
+    return true;
+  }
+
+  // pwr 0: hep ACTIVE + sabit periyotlar (kıyas için "önce" durumu)
+  void setEnabled(bool on) {
+    enabled = on;
+    if (!on && isIdle()) kick();
+  }
+  bool isEnabled() const { return enabled; }
+  bool hasLightSleep() const { return sleepOk; }
+
+  const ModeStats& getModeStats(PowerMode m) const { return stats[m]; }
+
+  void resetStats() {
+    account();
+    for (ModeStats& s : stats) s = ModeStats();
+    rxWakes = 0;
+  }
+
+  Estimate estimate() const {
+    Estimate e = {};
+    double wall = 0.0, charge = 0.0, busy = 0.0, sleep = 0.0, wakeups = 0.0;
+    for (uint8_t m = 0; m < PWR_MODE_COUNT; m++) {
+      const ModeStats& s = stats[m];
+      if (!s.wallUs) continue;
+      const PowerCpuModel& cpu = cpuModel(modeMhz(m));
+      double w = (double)s.wallUs;
+      double awake = (double)s.busyUs + (double)s.wakeups * POWER_WAKE_US;   // çekirdek-µs
+      double cores = awake / w;
+      if (cores > 2.0) cores = 2.0;
+      // Light sleep: IDLE'da, hiçbir çekirdek çalışmıyor ve ping kilidi yokken
+      double sleepFrac = 0.0;
+      if (m == PWR_IDLE && sleepOk) {
+        sleepFrac = 1.0 - cores - (double)s.noSleepUs / w;
+        if (sleepFrac < 0.0) sleepFrac = 0.0;
+      }
+      double mA = sleepFrac * POWER_LIGHT_SLEEP_MA + (1.0 - sleepFrac) * cpu.baseMa + cores * cpu.perCoreMa;
+      charge += w * mA;
+      wall += w;
+      busy += awake;
+      sleep += w * sleepFrac;
+      wakeups += s.wakeups;
+    }
+    if (wall <= 0.0) return e;
+    e.dutyPct = (float)(100.0 * busy / (2.0 * wall));
+    e.sleepPct = (float)(100.0 * sleep / wall);
+    e.idlePct = (float)(100.0 * stats[PWR_IDLE].wallUs / wall);
+    e.wakeupsPerS = (float)(wakeups * 1e6 / wall);
+    e.mA = (float)(charge / wall) + POWER_BOARD_MA;
+    e.hours = ENIC_BATTERY_MAH / e.mA;
+    return e;
+  }
+
+  void printStats(Print& out) {
+    account();
+    static const char* const NAMES[PWR_MODE_COUNT] = { "ACTIVE", "IDLE" };
+    enicPrintf(out, "pwr enabled=%u mode=%s mhz=%u dfs=%u light_sleep=%u holds=0x%02x rx_wakes=%lu\n",
+                    (unsigned)enabled, NAMES[getMode()], (unsigned)modeMhz(getMode()), (unsigned)pmOk,
+                    (unsigned)sleepOk, (unsigned)holds.load(), (unsigned long)rxWakes);
+    out.println("mode    time_s   duty%   wakeups/s  nosleep%  entries");
+    for (uint8_t m = 0; m < PWR_MODE_COUNT; m++) {
+      const ModeStats& s = stats[m];
+      double w = s.wallUs ? (double)s.wallUs : 1.0;
+      enicPrintf(out, "%-7s %-8.1f %-7.3f %-10.1f %-9.1f %lu\n", NAMES[m], s.wallUs * 1e-6,
+                      100.0 * s.busyUs / (2.0 * w), s.wakeups * 1e6 / w, 100.0 * s.noSleepUs / w,
+                      (unsigned long)s.entries);
+    }
+    Estimate e = estimate();
+    enicPrintf(out, "est %.1f mA (logic, motors off), sleep %.1f%% -> %.1f h on %u mAh\n",
+                    e.mA, e.sleepPct, e.hours, (unsigned)ENIC_BATTERY_MAH);
+  }
+};
+
+#endif
@@ -0,0 +1,146 @@
+/**
+ * @file EnicProfile.h
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Lightweight cycle-count profiler for per-subsystem loop timing
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ */
+#ifndef ENIC_PROFILE_H
+#define ENIC_PROFILE_H
+
+#include <Arduino.h>
+#include "EnicMem.h"
+
+// platformio.ini: -D ENIC_PROFILE=1. 0 iken makrolar tamamen boşa düşer.
+#ifndef ENIC_PROFILE
+#define ENIC_PROFILE 0
+#endif
+
+enum ProfSlot : uint8_t {
+  PROF_LOOP,     // kontrol task'ı bir tur (EnicTasks::controlStep)
+  PROF_FSM,      // EnicStateMachine::update() (alt sistemler dahil)
+  PROF_SENSE,    // sense->update() (sense task'ı)
+  PROF_MOTOR,    // motor->update()
+  PROF_FACE,     // face->render() çizim + submit (io task'ı)
+  PROF_SHOW,     // show.update() (DANCE / BOMB gösterisi)
+  PROF_SERIAL,   // EnicSerialLink::poll() (io task'ı)
+  PROF_SLOT_COUNT
+};
+
+#if ENIC_PROFILE
+
+static const int PROF_HIST_BINS = 32; // log2(ns)
+
+// Süreler kayıt anında ns'ye çevrilir: EnicPower 240 <-> 80 MHz geçer (DFS), döküm anındaki
+// frekansla bölmek IDLE'dan sonra 3 kata kadar hata verirdi
+struct EnicProfSlot {
+  uint32_t count = 0;
+  uint32_t minNs = 0xFFFFFFFFUL;
+  uint32_t maxNs = 0;
+  uint64_t sumNs = 0;
+  uint32_t hist[PROF_HIST_BINS] = {};
+};
+
+// loop() başlangıçları arası süre (µs) -> periyot jitter'ı
+struct EnicProfPeriod {
+  uint32_t count = 0;
+  uint32_t minUs = 0xFFFFFFFFUL;
+  uint32_t maxUs = 0;
+  uint64_t sumUs = 0;
+  uint64_t sumSqUs = 0;
+};
+
+class EnicProfiler {
+public:
+  static inline uint32_t cycles() { return ESP.getCycleCount(); }
+
+  static inline void record(ProfSlot s, uint32_t cy) {
+    uint32_t ns = (uint32_t)((uint64_t)cy * 1000U / ESP.getCpuFreqMHz());
+    EnicProfSlot& sl = slots[s];
+    sl.count++;
+    sl.sumNs += ns;
+    if (ns < sl.minNs) sl.minNs = ns;
+    if (ns > sl.maxNs) sl.maxNs = ns;
+    sl.hist[31 - __builtin_clz(ns | 1UL)]++;
+  }
+
+  // paced = false: önceki bekleme IDLE uykusuydu (EnicTasks); periyot / jitter'a girmez
+  static inline void markLoopStart(bool paced) {
+    uint32_t nowUs = (uint32_t)micros();
+    if (lastLoopUs != 0 && paced) {
+      uint32_t p = nowUs - lastLoopUs;
+      period.count++;
+      period.sumUs += p;
+      period.sumSqUs += (uint64_t)p * p;
+      if (p < period.minUs) period.minUs = p;
+      if (p > period.maxUs) period.maxUs = p;
+    }
+    lastLoopUs = nowUs;
+  }
+
+  static void reset() {
+    for (int i = 0; i < PROF_SLOT_COUNT; i++) slots[i] = EnicProfSlot();
+    period = EnicProfPeriod();
+    lastLoopUs = 0;
+  }
+
+  static void dump(Print& out) {
+    static const char* const names[PROF_SLOT_COUNT] = {
+      "loop", "fsm", "sense", "motor", "face", "show", "serial"
+    };
+    out.println("slot    count     min_us    mean_us     max_us  hist(log2 ns:n)");
+    for (int i = 0; i < PROF_SLOT_COUNT; i++) {
+      const EnicProfSlot& sl = slots[i];
+      enicPrintf(out, "%-6s %6lu ", names[i], (unsigned long)sl.count);
+      if (sl.count == 0) { out.println("         -          -          -"); continue; }
+      enicPrintf(out, "%10.1f %10.1f %10.1f ",
+                      sl.minNs / 1000.0,
+                      (double)sl.sumNs / sl.count / 1000.0,
+                      sl.maxNs / 1000.0);
+      for (int b = 0; b < PROF_HIST_BINS; b++) {
+        if (sl.hist[b]) enicPrintf(out, " %d:%lu", b, (unsigned long)sl.hist[b]);
+      }
+      out.println();
+    }
+
+    if (period.count > 0) {
+      double mean = (double)period.sumUs / period.count;
+      double var  = (double)period.sumSqUs / period.count - mean * mean;
+      if (var < 0) var = 0;
+      enicPrintf(out, "period n=%lu min=%lu mean=%.1f max=%lu jitter_sd=%.1f us\n",
+                      (unsigned long)period.count, (unsigned long)period.minUs, mean,
+                      (unsigned long)period.maxUs, sqrt(var));
+    }
+  }
+
+private:
+  static inline EnicProfSlot slots[PROF_SLOT_COUNT];
+  static inline EnicProfPeriod period;
+  static inline uint32_t lastLoopUs = 0;
+};
+
+class EnicProfScope {
+public:
+  explicit EnicProfScope(ProfSlot s) : slot(s), t0(EnicProfiler::cycles()) {}
+  ~EnicProfScope() { EnicProfiler::record(slot, EnicProfiler::cycles() - t0); }
+private:
+  ProfSlot slot;
+  uint32_t t0;
+};
+
+#define ENIC_PROF_CAT2(a, b) a##b
+#define ENIC_PROF_CAT(a, b) ENIC_PROF_CAT2(a, b)
+#define ENIC_PROFILE_SCOPE(slot) EnicProfScope ENIC_PROF_CAT(_enicProf, __LINE__)(slot)
+#define ENIC_PROFILE_LOOP_MARK(paced) EnicProfiler::markLoopStart(paced)
+#define ENIC_PROFILE_DUMP(out) do { EnicProfiler::dump(out); EnicProfiler::reset(); } while (0)
+
+#else
+
+#define ENIC_PROFILE_SCOPE(slot) ((void)0)
+#define ENIC_PROFILE_LOOP_MARK(paced) ((void)0)
+#define ENIC_PROFILE_DUMP(out) (out).println("profiling disabled (build with -D ENIC_PROFILE=1)")
+
+#endif
+
+#endif
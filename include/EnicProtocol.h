@@ -0,0 +1,188 @@
+/**
+ * @file EnicProtocol.h
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Binary UART protocol: COBS framing, CRC-16, message and record layout
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ *
+ * Kablo üstünde çerçeve:  0x00 | COBS(payload) | 0x00
+ * Payload:                type u8 | seq u8 | body ... | crc16 (LE, type..body üstünde)
+ * CRC: CRC-16/CCITT-FALSE (poli 0x1021, başlangıç 0xFFFF). Çok baytlı alanlar little-endian.
+ *
+ * MSG_CMD gövdesi art arda kayıtlardan oluşur: op u8 | len u8 | data[len].
+ * Bilinmeyen op, len kadar atlanır (ileri uyumluluk).
+ * tools/enic_link.py bu dosyanın referans host tarafıdır; değişiklikler ikisine birden yapılmalı.
+ */
+#ifndef ENIC_PROTOCOL_H
+#define ENIC_PROTOCOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+static const uint8_t PROTO_DELIM = 0x00;
+
+static const size_t PROTO_MAX_PAYLOAD = 96;                          // type+seq+body+crc
+static const size_t PROTO_MAX_WIRE    = PROTO_MAX_PAYLOAD + PROTO_MAX_PAYLOAD / 254 + 1;
+static const size_t PROTO_HEADER      = 2;
+static const size_t PROTO_CRC         = 2;
+
+// ---------------- Mesaj tipleri ----------------
+enum ProtoMsg : uint8_t {
+  MSG_CMD       = 0x01,   // host -> robot: komut kayıtları
+  MSG_ACK       = 0x81,   // robot -> host: acked seq | status | uygulanan kayıt sayısı
+  MSG_TELEMETRY = 0x82,   // robot -> host: ProtoTelemetry
+  MSG_LOG       = 0x83,   // robot -> host: uçuş kaydı dökümü, art arda LogRecord (EnicRecorder.h)
+  MSG_LOG_END   = 0x84,   // robot -> host: döküm sonu, u32 kayıt sayısı | u32 kuyrukta düşen
+};
+
+enum ProtoAckStatus : uint8_t {
+  ACK_OK        = 0,
+  ACK_DUPLICATE = 1,      // aynı seq tekrar geldi; kayıtlar yeniden uygulanmadı
+  ACK_BAD_RECORD = 2,     // kayıt uzunluğu/argümanı hatalı; öncekiler uygulandı
+  ACK_BUSY      = 3,      // komut kuyruğu dolu; hiçbir kayıt alınmadı, aynı seq ile tekrar gönderin
+};
+
+// ---------------- Komut kayıtları (MSG_CMD) ----------------
+enum ProtoOp : uint8_t {
+  OP_DRIVE     = 0x01,    // i16 left, i16 right, u16 ms (0: süresiz)      -> MANUAL
+  OP_FACE      = 0x02,    // u8 FaceType, u16 ms, u8 sound (0: yok)        -> IDLE + ifade
+  OP_SOUND     = 0x03,    // u8 effect (1..5)
+  OP_MODE      = 0x04,    // u8 ProtoMode
+  OP_PING      = 0x05,    // u16 sonar ping aralığı (ms)
+  OP_TELEMETRY = 0x06,    // u16 telemetri periyodu (ms, 0: kapalı)
+};
+
+enum ProtoMode : uint8_t { MODE_STOP = 0, MODE_AUTO = 1, MODE_DANCE = 2, MODE_BOMB = 3 };
+
+// ---------------- Telemetri gövdesi (MSG_TELEMETRY, 28 bayt) ----------------
+static const uint16_t PROTO_U16_NONE = 0xFFFF;
+
+struct ProtoTelemetry {
+  uint32_t tMs;
+  uint8_t  state;         // AppState
+  uint8_t  flags;         // bit0: mesafe geçerli
+  uint16_t distMm;        // PROTO_U16_NONE: echo yok
+  int16_t  closingMmS;    // + yaklaşıyor
+  uint16_t ttcMs;         // PROTO_U16_NONE: yaklaşma yok
+  int16_t  targetLeft, targetRight;
+  int16_t  currentLeft, currentRight;
+  uint16_t loopAvgUs;     // son telemetri penceresindeki loop periyodu
+  uint16_t loopMaxUs;
+  uint16_t rxFrames;      // geçerli binary çerçeve sayısı (sarmalı)
+  uint16_t rxErrors;      // CRC / COBS / boyut hataları (sarmalı)
+};
+
+static const size_t PROTO_TELEMETRY_LEN = 28;
+
+// ---------------- Little-endian yardımcıları ----------------
+inline void putU16(uint8_t* p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+inline void putU32(uint8_t* p, uint32_t v) { putU16(p, (uint16_t)v); putU16(p + 2, (uint16_t)(v >> 16)); }
+inline uint16_t getU16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+inline int16_t getI16(const uint8_t* p) { return (int16_t)getU16(p); }
+
+inline size_t packTelemetry(const ProtoTelemetry& t, uint8_t* out) {
+  putU32(out + 0, t.tMs);
+  out[4] = t.state;
+  out[5] = t.flags;
+  putU16(out + 6,  t.distMm);
+  putU16(out + 8,  (uint16_t)t.closingMmS);
+  putU16(out + 10, t.ttcMs);
+  putU16(out + 12, (uint16_t)t.targetLeft);
+  putU16(out + 14, (uint16_t)t.targetRight);
+  putU16(out + 16, (uint16_t)t.currentLeft);
+  putU16(out + 18, (uint16_t)t.currentRight);
+  putU16(out + 20, t.loopAvgUs);
+  putU16(out + 22, t.loopMaxUs);
+  putU16(out + 24, t.rxFrames);
+  putU16(out + 26, t.rxErrors);
+  return PROTO_TELEMETRY_LEN;
+}
+
+// ---------------- CRC-16/CCITT-FALSE ----------------
+struct ProtoCrcTable { uint16_t v[256]; };
+
+constexpr ProtoCrcTable buildCrcTable() {
+  ProtoCrcTable t = {};
+  for (int i = 0; i < 256; i++) {
+    uint16_t c = (uint16_t)(i << 8);
+    for (int b = 0; b < 8; b++) c = (c & 0x8000) ? (uint16_t)((c << 1) ^ 0x1021) : (uint16_t)(c << 1);
+    t.v[i] = c;
+  }
+  return t;
+}
+
+inline constexpr ProtoCrcTable PROTO_CRC_TABLE = buildCrcTable();
+
+inline uint16_t protoCrc16(const uint8_t* data, size_t n) {
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < n; i++) crc = (uint16_t)((crc << 8) ^ PROTO_CRC_TABLE.v[(crc >> 8) ^ data[i]]);
+  return crc;
+}
+
+static_assert(PROTO_CRC_TABLE.v[1] == 0x1021, "CRC table");
+
+// ---------------- COBS ----------------
+// out en az n + n/254 + 1 bayt olmalı; yazılan bayt sayısını döner (sıfır içermez)
+inline size_t cobsEncode(const uint8_t* in, size_t n, uint8_t* out) {
+  size_t w = 1, codeAt = 0;
+  uint8_t code = 1;
+  for (size_t i = 0; i < n; i++) {
+    if (in[i] == 0) {
+      out[codeAt] = code; codeAt = w++; code = 1;
+    } else {
+      out[w++] = in[i];
+      if (++code == 0xFF) { out[codeAt] = code; codeAt = w++; code = 1; }
+    }
+  }
+  out[codeAt] = code;
+  return w;
+}
+
+// Hatalı kodlama veya kapasite aşımında 0
+inline size_t cobsDecode(const uint8_t* in, size_t n, uint8_t* out, size_t cap) {
+  size_t r = 0, w = 0;
+  while (r < n) {
+    uint8_t code = in[r++];
+    if (code == 0) return 0;
+    for (uint8_t i = 1; i < code; i++) {
+      if (r >= n || w >= cap) return 0;
+      out[w++] = in[r++];
+    }
+    if (code < 0xFF && r < n) {
+      if (w >= cap) return 0;
+      out[w++] = 0;
+    }
+  }
+  return w;
+}
+
+// ---------------- Çerçeve ----------------
+// type/seq/body -> kabloya hazır çerçeve (ayraçlar dahil). Sığmazsa 0.
+inline size_t protoBuildFrame(uint8_t type, uint8_t seq, const uint8_t* body, size_t len, uint8_t* wire) {
+  uint8_t raw[PROTO_MAX_PAYLOAD];
+  if (len + PROTO_HEADER + PROTO_CRC > sizeof(raw)) return 0;
+
+  raw[0] = type;
+  raw[1] = seq;
+  for (size_t i = 0; i < len; i++) raw[PROTO_HEADER + i] = body[i];
+  size_t n = PROTO_HEADER + len;
+  putU16(raw + n, protoCrc16(raw, n));
+  n += PROTO_CRC;
+
+  wire[0] = PROTO_DELIM;
+  size_t w = 1 + cobsEncode(raw, n, wire + 1);
+  wire[w++] = PROTO_DELIM;
+  return w;
+}
+
+// COBS gövdesi (ayraçsız) -> payload. CRC tutmazsa / kısa ise 0; başarıda payload uzunluğu (crc hariç).
+inline size_t protoParseFrame(const uint8_t* cobs, size_t n, uint8_t* payload, size_t cap) {
+  size_t len = cobsDecode(cobs, n, payload, cap);
+  if (len < PROTO_HEADER + PROTO_CRC) return 0;
+  len -= PROTO_CRC;
+  if (getU16(payload + len) != protoCrc16(payload, len)) return 0;
+  return len;
+}
+
+#endif
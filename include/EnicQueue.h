@@ -0,0 +1,142 @@
+/**
+ * @file EnicQueue.h
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Bounded wait-free single-producer/single-consumer ring buffer with high-water marks
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ *
+ * Tek üretici task push(), tek tüketici task pop() çağırır; ikisi de asla beklemez.
+ * Dolu kuyrukta push() false döner ve 'dropped' sayılır (üretici bloklanmaz).
+ * Tüm kuyruklar isimleriyle kayıt olur: 'queues' komutu EnicQueueRegistry::print ile listeler.
+ */
+#ifndef ENIC_QUEUE_H
+#define ENIC_QUEUE_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "EnicMem.h"
+
+struct QueueStats {
+  const char* name;
+  uint32_t capacity;
+  uint32_t size;
+  uint32_t highWater;   // gözlenen en yüksek doluluk
+  uint32_t pushed;
+  uint32_t dropped;     // dolu olduğu için reddedilen
+};
+
+class EnicQueueBase {
+public:
+  virtual QueueStats getStats() const = 0;
+  virtual void resetStats() = 0;
+protected:
+  ~EnicQueueBase() {}
+};
+
+// Kayıt cihazda sadece setup sırasında değişir; host simülatöründe her iş parçacığı kendi
+// robotunu kurup yıktığı için yuvalar atomik (dolu kayıt sessizce listelenmez)
+class EnicQueueRegistry {
+private:
+  static const int MAX_QUEUES = 12;
+  static inline std::atomic<EnicQueueBase*> queues[MAX_QUEUES] = {};
+
+public:
+  static void add(EnicQueueBase* q) {
+    for (int i = 0; i < MAX_QUEUES; i++) {
+      EnicQueueBase* empty = nullptr;
+      if (queues[i].compare_exchange_strong(empty, q)) return;
+    }
+  }
+  static void remove(EnicQueueBase* q) {
+    for (int i = 0; i < MAX_QUEUES; i++) {
+      EnicQueueBase* mine = q;
+      queues[i].compare_exchange_strong(mine, nullptr);
+    }
+  }
+
+  static void print(Print& out) {
+    out.println("queue            cap  size  high  pushed     dropped");
+    for (int i = 0; i < MAX_QUEUES; i++) {
+      EnicQueueBase* q = queues[i].load();
+      if (!q) continue;
+      QueueStats s = q->getStats();
+      enicPrintf(out, "%-15s %4lu  %4lu  %4lu  %-10lu %lu\n", s.name,
+                      (unsigned long)s.capacity, (unsigned long)s.size, (unsigned long)s.highWater,
+                      (unsigned long)s.pushed, (unsigned long)s.dropped);
+    }
+  }
+
+  static void resetAll() {
+    for (int i = 0; i < MAX_QUEUES; i++) {
+      EnicQueueBase* q = queues[i].load();
+      if (q) q->resetStats();
+    }
+  }
+};
+
+template <typename T, uint32_t N>
+class EnicQueue : public EnicQueueBase {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "EnicQueue capacity must be a power of two");
+
+private:
+  const char* name;
+  T buf[N];
+
+  // Serbest koşan indeksler (taşma güvenli: fark N'yi geçmez)
+  std::atomic<uint32_t> head{0};   // yalnız üretici yazar
+  std::atomic<uint32_t> tail{0};   // yalnız tüketici yazar
+
+  // Üretici tarafı sayaçları
+  uint32_t highWater = 0;
+  uint32_t pushed = 0;
+  uint32_t dropped = 0;
+
+public:
+  explicit EnicQueue(const char* queueName) : name(queueName) { EnicQueueRegistry::add(this); }
+  ~EnicQueue() { EnicQueueRegistry::remove(this); }
+
+  EnicQueue(const EnicQueue&) = delete;
+  EnicQueue& operator=(const EnicQueue&) = delete;
+
+  // Üretici: asla beklemez
+  bool push(const T& v) {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    uint32_t t = tail.load(std::memory_order_acquire);
+    if (h - t >= N) { dropped++; return false; }
+
+    buf[h & (N - 1)] = v;
+    head.store(h + 1, std::memory_order_release);
+
+    pushed++;
+    if (h + 1 - t > highWater) highWater = h + 1 - t;
+    return true;
+  }
+
+  // Tüketici: boşsa false
+  bool pop(T& out) {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    uint32_t h = head.load(std::memory_order_acquire);
+    if (t == h) return false;
+
+    out = buf[t & (N - 1)];
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Her iki taraftan çağrılabilir; anlık görüntü
+  uint32_t size() const {
+    return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+  }
+  bool empty() const { return size() == 0; }
+  static constexpr uint32_t capacity() { return N; }
+
+  QueueStats getStats() const override {
+    QueueStats s = { name, N, size(), highWater, pushed, dropped };
+    return s;
+  }
+
+  void resetStats() override { highWater = size(); pushed = 0; dropped = 0; }
+};
+
+#endif
@@ -0,0 +1,146 @@
+/**
+ * @file EnicRangeFilter.h
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Sonar range filter: median, outlier rejection, alpha-beta tracker, TTC
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ */
+#ifndef ENIC_RANGE_FILTER_H
+#define ENIC_RANGE_FILTER_H
+
+#include <Arduino.h>
+
+// Yaklaşma yoksa yayınlanan TTC
+static const float RANGE_TTC_NONE = 99.0f;
+
+struct RangeEstimate {
+  float distCm = 0.0f;        // filtrelenmiş mesafe
+  float closingCmS = 0.0f;    // + engele yaklaşıyor, - uzaklaşıyor
+  float ttcS = RANGE_TTC_NONE; // time-to-collision
+  uint32_t tMs = 0;      // son güncelleme zamanı
+  bool valid = false;         // false: önde ölçülebilir engel yok / henüz ölçüm yok
+};
+
+// Aşamalar (sabit boyut, heap yok):
+// 1) sentinel (echo yok) örnekler ring'e girmez; art arda gelirse "açık alan"
+// 2) son N geçerli örneğin medyanı
+// 3) tahmine göre inovasyon kapısı ile aykırı değer reddi
+// 4) alpha-beta takipçi -> mesafe + hız, ondan TTC
+class EnicRangeFilter {
+public:
+  static const int MEDIAN_N = 3;           // 1 örnek gecikme
+  static const uint8_t MISS_CLEAR = 4;     // art arda echo yok -> geçersiz
+  static const uint8_t OUTLIER_RESET = 3;  // art arda ret -> yeni seviyeye atla
+
+private:
+  float ring[MEDIAN_N] = {};
+  uint8_t ringHead = 0;
+  uint8_t ringCount = 0;
+
+  float alpha = 0.6f;
+  float beta  = 0.2f;
+  float gateCm = 35.0f;                    // + |v|*dt
+
+  float x = 0.0f;   // mesafe (cm)
+  float v = 0.0f;   // d(mesafe)/dt (cm/s); yaklaşırken negatif
+  bool  tracking = false;
+  uint32_t lastMs = 0;
+
+  uint8_t missStreak = 0;
+  uint8_t outlierStreak = 0;
+
+  uint32_t rejected = 0;
+
+  RangeEstimate est;
+
+  float median() const {
+    float a[MEDIAN_N];
+    for (int i = 0; i < ringCount; i++) a[i] = ring[i];
+    // küçük N için insertion sort
+    for (int i = 1; i < ringCount; i++) {
+      float k = a[i]; int j = i - 1;
+      while (j >= 0 && a[j] > k) { a[j + 1] = a[j]; j--; }
+      a[j + 1] = k;
+    }
+    return a[ringCount / 2];
+  }
+
+  void publish(uint32_t tMs) {
+    est.distCm = x;
+    est.closingCmS = -v;
+    est.ttcS = (est.closingCmS > 1.0f) ? (x / est.closingCmS) : RANGE_TTC_NONE;
+    if (est.ttcS > RANGE_TTC_NONE) est.ttcS = RANGE_TTC_NONE;
+    est.tMs = tMs;
+    est.valid = tracking;
+  }
+
+  void restart(float z, uint32_t tMs) {
+    x = z; v = 0.0f;
+    tracking = true;
+    lastMs = tMs;
+    outlierStreak = 0;
+  }
+
+public:
+  void reset() { *this = EnicRangeFilter(); }
+
+  void setGains(float a, float b) {
+    alpha = constrain(a, 0.05f, 1.0f);
+    beta  = constrain(b, 0.0f, 1.0f);
+  }
+  void setGate(float cm) { gateCm = constrain(cm, 5.0f, 400.0f); }
+
+  const RangeEstimate& get() const { return est; }
+  uint32_t getRejectedCount() const { return rejected; }
+
+  // noEcho: sensör menzil dışı / echo yok döndü
+  void push(float cm, bool noEcho, uint32_t tMs) {
+    if (noEcho) {
+      if (missStreak < 255) missStreak++;
+      if (missStreak >= MISS_CLEAR) {
+        tracking = false;
+        ringCount = 0; ringHead = 0;
+        v = 0.0f;
+      }
+      publish(tMs);
+      return;
+    }
+    missStreak = 0;
+
+    ring[ringHead] = cm;
+    ringHead = (uint8_t)((ringHead + 1) % MEDIAN_N);
+    if (ringCount < MEDIAN_N) ringCount++;
+    float z = median();
+
+    if (!tracking) { restart(z, tMs); publish(tMs); return; }
+
+    float dt = (tMs - lastMs) * 0.001f;
+    if (dt <= 0.0f) dt = 0.001f;
+    if (dt > 0.5f) { restart(z, tMs); publish(tMs); return; } // uzun boşluk: hız bilgisi bayat
+
+    float xp = x + v * dt;
+    float r  = z - xp;
+
+    if (fabsf(r) > gateCm + fabsf(v) * dt) {
+      rejected++;
+      if (++outlierStreak >= OUTLIER_RESET) {
+        // tutarlı yeni seviye (önüne bir şey girdi / çekildi)
+        ringCount = 0; ringHead = 0;
+        ring[ringHead] = cm; ringHead = 1; ringCount = 1;
+        restart(cm, tMs);
+      }
+      publish(est.tMs);
+      return;
+    }
+    outlierStreak = 0;
+
+    x = xp + alpha * r;
+    v = v + (beta / dt) * r;
+    if (x < 0.0f) x = 0.0f;
+    lastMs = tMs;
+    publish(tMs);
+  }
+};
+
+#endif
@@ -0,0 +1,291 @@
+/**
+ * @file EnicRecorder.h
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Flight recorder: fixed-size binary records, RAM ring, circular LittleFS log
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ *
+ * Kontrol task'ı record() ile 12 baytlık kayıt atar (tek üretici, beklemesiz EnicQueue).
+ * Log task'ı (core 0, en düşük öncelik) kuyruğu 512 baytlık bloklara toplar ve LOG_PATH'teki
+ * dairesel dosyaya yazar; dolu blok hemen, yarım blok LOG_SYNC_MS'de bir. Blok başlığındaki
+ * seq ile açılışta en yeni blok bulunur, yazım bir sonrakinden devam eder.
+ * Döküm ("log 1") MSG_LOG çerçeveleriyle en eskiden en yeniye akar; tools/enic_log.py çözer.
+ * Kayıt düzeni tools/enic_log.py ile aynı olmalı.
+ */
+#ifndef ENIC_RECORDER_H
+#define ENIC_RECORDER_H
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <atomic>
+#include "EnicQueue.h"
+#include "EnicProtocol.h"
+#include "EnicTime.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include "esp_system.h"
+#endif
+
+// Dosya boyu = ENIC_LOG_BLOCKS x 512 B (varsayılan 256 KB, ~40 kayıt/s ile ~9 dakika)
+#ifndef ENIC_LOG_BLOCKS
+#define ENIC_LOG_BLOCKS 512
+#endif
+
+enum LogType : uint8_t {
+  LOG_BOOT,      // a: esp_reset_reason(), v0: format sürümü
+  LOG_STATE,     // a: yeni AppState, v0: eski AppState
+  LOG_CMD,       // a: CommandId (metin) ya da 0x80 | ProtoOp (binary); v0..v2: ilk argümanlar
+                 //    (binary: verinin ilk üç LE i16 sözcüğü, tek baytlık veride o bayt)
+  LOG_RANGE,     // a: bit0 geçerli, bit1 echo; v0: filtreli mm, v1: yaklaşma mm/s, v2: ham mm (-1: yok)
+  LOG_MOTOR,     // a: governor acil durdurma; v0/v1: hedef duty sol/sağ, v2: governor tavanı
+  LOG_OVERRUN,   // v0: kontrol periyodu (0.1 ms), v1: kontrol adımı süresi (0.1 ms)
+  LOG_TYPE_COUNT
+};
+
+// Flash'ta ve kabloda aynen (little-endian, dolgu yok)
+struct LogRecord {
+  uint32_t tMs;
+  uint8_t  type;
+  uint8_t  a;
+  int16_t  v0, v1, v2;
+};
+
+static_assert(sizeof(LogRecord) == 12, "LogRecord layout is shared with tools/enic_log.py");
+
+// Blok: başlık + kayıtlar; magic tutmayan blok boş sayılır
+struct LogBlockHeader {
+  uint16_t magic;
+  uint8_t  version;
+  uint8_t  count;
+  uint32_t seq;
+};
+
+static const char* const LOG_PATH = "/enic.log";
+static const uint16_t LOG_MAGIC = 0x4C45;              // "EL"
+static const uint8_t  LOG_VERSION = 1;
+static const size_t   LOG_BLOCK_BYTES = 512;
+static const int      LOG_RECS_PER_BLOCK = (int)((LOG_BLOCK_BYTES - sizeof(LogBlockHeader)) / sizeof(LogRecord));
+static const uint32_t LOG_SYNC_MS = 2000;              // yarım bloğu en geç bu sürede flash'a yaz
+static const uint32_t LOG_RING = 256;                  // ~6 s tampon (döküm sırasında da dolmaz)
+static const int      LOG_RECS_PER_FRAME = (int)((PROTO_MAX_PAYLOAD - PROTO_HEADER - PROTO_CRC) / sizeof(LogRecord));
+
+class EnicRecorder {
+public:
+  struct RecorderStats {
+    uint32_t stored = 0;        // flash bloğuna giren kayıt
+    uint32_t blocks = 0;        // tamamlanan blok
+    uint32_t syncs = 0;         // yarım blok yazımı
+    uint32_t writeErrors = 0;
+    uint32_t lastWriteUs = 0;
+    uint32_t maxWriteUs = 0;
+    uint32_t dumps = 0;
+  };
+
+private:
+  EnicQueue<LogRecord, LOG_RING> ring{"log.ring"};
+
+  // ---- log task tarafı ----
+  File file;
+  std::atomic<bool> mounted{false};   // log task bağlar; log komutu kontrol tarafından okur
+  uint16_t blockIdx = 0;        // yazılan (yarım) blok
+  uint16_t fileBlocks = 0;      // dosyadaki blok sayısı; ilk turda büyür
+  uint32_t seq = 0;
+  uint8_t block[LOG_BLOCK_BYTES];
+  uint8_t count = 0;
+  bool dirty = false;
+  uint32_t lastSyncMs = 0;
+  uint8_t txSeq = 0;
+
+  RecorderStats stats;
+
+  // kontrol yazar, log task'ı okur
+  std::atomic<bool> dumpRequested{false};
+  std::atomic<bool> eraseRequested{false};
+
+  static int16_t sat16(long v) { return (int16_t)constrain(v, -32768L, 32767L); }
+
+  bool readHeader(uint16_t idx, LogBlockHeader& h) {
+    if (!file.seek((uint32_t)idx * LOG_BLOCK_BYTES)) return false;
+    if (file.read((uint8_t*)&h, sizeof(h)) != sizeof(h)) return false;
+    return h.magic == LOG_MAGIC && h.version == LOG_VERSION &&
+           h.count > 0 && h.count <= LOG_RECS_PER_BLOCK;
+  }
+
+  // Açılış: en yüksek seq'li bloğu bul, sonrakine yaz (yarım kalan blok olduğu gibi kalır)
+  void recover() {
+    fileBlocks = (uint16_t)min((size_t)ENIC_LOG_BLOCKS, file.size() / LOG_BLOCK_BYTES);
+    bool found = false;
+    uint32_t maxSeq = 0;
+    uint16_t maxIdx = 0;
+    for (uint16_t i = 0; i < fileBlocks; i++) {
+      LogBlockHeader h;
+      if (!readHeader(i, h)) continue;
+      if (!found || (int32_t)(h.seq - maxSeq) > 0) { found = true; maxSeq = h.seq; maxIdx = i; }
+    }
+    blockIdx = found ? (uint16_t)((maxIdx + 1) % ENIC_LOG_BLOCKS) : 0;
+    seq = found ? maxSeq + 1 : 0;
+  }
+
+  void startBlock() {
+    memset(block, 0, sizeof(block));
+    count = 0;
+    dirty = false;
+  }
+
+  // Mevcut bloğu yerine yaz; full ise sıradakine geç
+  void writeBlock(bool full) {
+    LogBlockHeader h = { LOG_MAGIC, LOG_VERSION, count, seq };
+    memcpy(block, &h, sizeof(h));
+
+    uint32_t t0 = nowUs32();
+    bool ok = file.seek((uint32_t)blockIdx * LOG_BLOCK_BYTES) &&
+              file.write(block, LOG_BLOCK_BYTES) == LOG_BLOCK_BYTES;
+    file.flush();
+    uint32_t dt = nowUs32() - t0;
+    stats.lastWriteUs = dt;
+    if (dt > stats.maxWriteUs) stats.maxWriteUs = dt;
+    if (!ok) stats.writeErrors++;
+    lastSyncMs = nowMs32();
+    dirty = false;
+
+    if (!full) { stats.syncs++; return; }
+    stats.blocks++;
+    if (blockIdx >= fileBlocks) fileBlocks = blockIdx + 1;
+    blockIdx = (uint16_t)((blockIdx + 1) % ENIC_LOG_BLOCKS);
+    seq++;
+    startBlock();
+  }
+
+  void append(const LogRecord& r) {
+    if (!mounted) return;
+    memcpy(block + sizeof(LogBlockHeader) + count * sizeof(LogRecord), &r, sizeof(r));
+    count++;
+    dirty = true;
+    stats.stored++;
+    if (count == LOG_RECS_PER_BLOCK) writeBlock(true);
+  }
+
+  void sendFrame(Print& out, uint8_t type, const uint8_t* body, size_t len) {
+    uint8_t wire[PROTO_MAX_WIRE + 2];
+    size_t n = protoBuildFrame(type, txSeq++, body, len, wire);
+    if (n) out.write(wire, n);
+  }
+
+  // En eskiden en yeniye. Dosya dolduysa en eski blok: yazılan blok boşsa kendisi (eski içerik
+  // henüz ezilmedi), değilse bir sonraki. seq geri giderse (yarım kalmış tur) blok atlanır.
+  void dump(Print& out) {
+    uint32_t sent = 0;
+    if (mounted) {
+      if (dirty) writeBlock(false);
+      uint16_t n = fileBlocks > blockIdx ? fileBlocks : (uint16_t)(blockIdx + 1);
+      uint16_t first = 0;
+      if (n >= ENIC_LOG_BLOCKS) first = (uint16_t)((blockIdx + (count > 0 ? 1 : 0)) % ENIC_LOG_BLOCKS);
+
+      uint8_t buf[LOG_BLOCK_BYTES];
+      bool any = false;
+      uint32_t lastSeq = 0;
+      for (uint16_t k = 0; k < n; k++) {
+        uint16_t idx = (uint16_t)((first + k) % n);
+        LogBlockHeader h;
+        if (!readHeader(idx, h)) continue;
+        if (any && (int32_t)(h.seq - lastSeq) <= 0) continue;
+        any = true;
+        lastSeq = h.seq;
+        size_t len = h.count * sizeof(LogRecord);
+        if (file.read(buf, len) != len) continue;
+        for (size_t off = 0; off < len; off += LOG_RECS_PER_FRAME * sizeof(LogRecord)) {
+          size_t chunk = min(len - off, LOG_RECS_PER_FRAME * sizeof(LogRecord));
+          sendFrame(out, MSG_LOG, buf + off, chunk);
+          sent += (uint32_t)(chunk / sizeof(LogRecord));
+        }
+      }
+    }
+
+    uint8_t end[8];
+    putU32(end, sent);
+    putU32(end + 4, ring.getStats().dropped);
+    sendFrame(out, MSG_LOG_END, end, sizeof(end));
+    stats.dumps++;
+  }
+
+  void erase() {
+    if (!mounted) return;
+    file.close();
+    LittleFS.remove(LOG_PATH);
+    file = LittleFS.open(LOG_PATH, "w+");
+    fileBlocks = 0;
+    blockIdx = 0;
+    seq = 0;
+    startBlock();
+  }
+
+public:
+  // setup'ta, task'lardan önce (kontrol tarafı): sadece açılış kaydı, flash'a dokunmaz
+  void begin() {
+#if defined(ARDUINO_ARCH_ESP32)
+    uint8_t reason = (uint8_t)esp_reset_reason();
+#else
+    uint8_t reason = 0;
+#endif
+    record(LOG_BOOT, reason, LOG_VERSION);
+  }
+
+  // Log task'ının ilk işi: bağla, son bloğu bul. Bölüm bozuksa biçimlendirir (saniyeler sürebilir;
+  // kontrol beklemez, kayıtlar halkada birikir). Bağlanamazsa kayıtlar atılır.
+  bool mount() {
+    startBlock();
+    lastSyncMs = nowMs32();
+    mounted = LittleFS.begin(true);
+    if (mounted) {
+      file = LittleFS.exists(LOG_PATH) ? LittleFS.open(LOG_PATH, "r+") : LittleFS.open(LOG_PATH, "w+");
+      mounted = (bool)file;
+    }
+    if (mounted) recover();
+    return mounted;
+  }
+
+  // ================= Kontrol task tarafı =================
+  // Tek üretici; kuyruk doluysa kayıt düşer (sayılır), asla beklemez
+  void record(LogType type, uint8_t a, long v0 = 0, long v1 = 0, long v2 = 0) {
+    LogRecord r = { nowMs32(), (uint8_t)type, a, sat16(v0), sat16(v1), sat16(v2) };
+    ring.push(r);
+  }
+
+  void requestDump()  { dumpRequested.store(true); }
+  void requestErase() { eraseRequested.store(true); }
+
+  // ================= Log task tarafı =================
+  void drainStep() {
+    if (eraseRequested.exchange(false)) erase();
+
+    LogRecord r;
+    while (ring.pop(r)) append(r);
+
+    if (dirty && nowMs32() - lastSyncMs >= LOG_SYNC_MS) writeBlock(false);
+    if (dumpRequested.exchange(false)) dump(Serial);
+  }
+
+  bool isMounted() const { return mounted; }
+  const RecorderStats& getStats() const { return stats; }
+  QueueStats getRingStats() const { return ring.getStats(); }
+
+  void printStats(Print& out) const {
+    QueueStats q = ring.getStats();
+    out.print("log mounted=");  out.print(mounted ? 1 : 0);
+    out.print(" records=");     out.print(q.pushed);
+    out.print(" dropped=");     out.print(q.dropped);
+    out.print(" ring_high=");   out.print(q.highWater);
+    out.print(" stored=");      out.print(stats.stored);
+    out.print(" blocks=");      out.print(stats.blocks);
+    out.print(" syncs=");       out.print(stats.syncs);
+    out.print(" block=");       out.print((unsigned long)blockIdx);
+    out.print("/");             out.print((unsigned long)ENIC_LOG_BLOCKS);
+    out.print(" seq=");         out.print(seq);
+    out.print(" write_us=");    out.print(stats.lastWriteUs);
+    out.print(" max_write_us="); out.print(stats.maxWriteUs);
+    out.print(" errors=");      out.println(stats.writeErrors);
+  }
+};
+
+#endif
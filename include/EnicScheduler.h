@@ -0,0 +1,279 @@
+/**
+ * @file EnicScheduler.h
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Cooperative deadline scheduler: hierarchical timer wheel, one-shot and periodic tasks
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ *
+ * 1 ms tick, 4 seviye x 64 yuva (2^24 ms ~ 4.6 saat; daha uzunu son seviyede bekletilip yeniden
+ * yerleştirilir). Görevler sabit havuzda (heap yok), yuvalarda çift bağlı liste; yuva doluluğu
+ * 64 bitlik maskelerde. advance() boş yuvaları maskeden atlar: maliyet görev sayısıyla değil
+ * vadesi gelen olay + kademe sayısıyla ölçeklenir. Zaman yalnız göreli (vade - şimdi) kullanılır,
+ * millis() sarması sorun değil. Tek iş parçacığı: advance ve start/cancel aynı task'tan.
+ */
+#ifndef ENIC_SCHEDULER_H
+#define ENIC_SCHEDULER_H
+
+#include <Arduino.h>
+#include "EnicTime.h"
+#include "EnicMem.h"
+
+typedef void (*SchedFn)(void* ctx);
+
+static const uint8_t  SCHED_MAX_TASKS = 16;
+static const uint8_t  SCHED_LEVELS = 4;
+static const uint8_t  SCHED_SLOT_BITS = 6;
+static const uint8_t  SCHED_SLOTS = 1 << SCHED_SLOT_BITS;
+static const uint32_t SCHED_WHEEL_SPAN_MS = 1UL << (SCHED_SLOT_BITS * SCHED_LEVELS);
+static const uint16_t SCHED_DEFAULT_SLACK_MS = 10;   // tek seferlikte bundan geç = kaçırılmış
+
+class EnicScheduler {
+public:
+  typedef int8_t Id;   // -1: havuz dolu
+
+  struct TaskStats {
+    uint32_t runs = 0;
+    uint32_t missed = 0;        // periyodik: atlanan periyot; tek seferlik: slack'ten geç
+    uint32_t maxLateMs = 0;
+  };
+
+  struct WheelStats {
+    uint32_t advances = 0;
+    uint32_t ticks = 0;         // işlenen (boş olmayan / kademe) tick
+    uint32_t cascaded = 0;      // üst seviyeden inen görev
+    uint32_t fired = 0;
+  };
+
+private:
+  static const uint8_t NO_SLOT = 0xFF;
+
+  struct Task {
+    const char* name = nullptr;
+    SchedFn fn = nullptr;       // nullptr: sadece vade (pending() ile sorulur)
+    void* ctx = nullptr;
+    uint32_t due = 0;
+    uint32_t period = 0;        // 0: tek seferlik
+    uint16_t slackMs = SCHED_DEFAULT_SLACK_MS;
+    int8_t next = -1, prev = -1;
+    uint8_t slot = NO_SLOT;     // seviye * 64 + yuva
+    bool firing = false;        // bu tick'te çalışacaklar listesinde
+    TaskStats stats;
+  };
+
+  Task tasks[SCHED_MAX_TASKS];
+  uint8_t taskCount = 0;
+  uint8_t armed = 0;
+  int8_t head[SCHED_LEVELS * SCHED_SLOTS];
+  uint64_t occupied[SCHED_LEVELS] = {};
+  uint32_t curMs = 0;           // işlenmiş son tick
+  WheelStats wstats;
+
+  static uint8_t shiftOf(uint8_t level) { return level * SCHED_SLOT_BITS; }
+
+  // inTick: processTick içinden (kademe); vadesi bu tick olan bu tick'in seviye-0 yuvasına
+  void link(Id id, bool inTick = false) {
+    Task& t = tasks[id];
+    int32_t delta = (int32_t)(t.due - curMs);
+    uint32_t at = t.due;
+    uint8_t level = 0;
+    if (delta < (inTick ? 0 : 1)) {
+      at = inTick ? curMs : curMs + 1;                  // gecikmiş: ilk işlenecek tick
+    } else if ((uint32_t)delta >= SCHED_WHEEL_SPAN_MS) {
+      level = SCHED_LEVELS - 1;                         // çok uzak: son seviyede bekle, inince yeniden yerleş
+      at = curMs + SCHED_WHEEL_SPAN_MS - (1UL << shiftOf(level));
+    } else {
+      while (level < SCHED_LEVELS - 1 && (uint32_t)delta >= (1UL << shiftOf(level + 1))) level++;
+    }
+    uint8_t idx = (at >> shiftOf(level)) & (SCHED_SLOTS - 1);
+    uint8_t s = level * SCHED_SLOTS + idx;
+
+    t.slot = s;
+    t.prev = -1;
+    t.next = head[s];
+    if (head[s] >= 0) tasks[head[s]].prev = id;
+    head[s] = id;
+    occupied[level] |= 1ULL << idx;
+    armed++;
+  }
+
+  void unlink(Id id) {
+    Task& t = tasks[id];
+    if (t.slot == NO_SLOT) return;
+    if (t.prev >= 0) tasks[t.prev].next = t.next;
+    else head[t.slot] = t.next;
+    if (t.next >= 0) tasks[t.next].prev = t.prev;
+    if (head[t.slot] < 0) occupied[t.slot / SCHED_SLOTS] &= ~(1ULL << (t.slot % SCHED_SLOTS));
+    t.slot = NO_SLOT;
+    armed--;
+  }
+
+  // Yuvayı boşalt, görevleri dizide döndür
+  uint8_t detach(uint8_t s, Id* out) {
+    uint8_t n = 0;
+    while (head[s] >= 0) {
+      Id id = head[s];
+      unlink(id);
+      out[n++] = id;
+    }
+    return n;
+  }
+
+  void arm(Id id, uint32_t due, uint32_t period) {
+    if (id < 0 || id >= taskCount) return;
+    unlink(id);
+    Task& t = tasks[id];
+    t.firing = false;
+    t.due = due;
+    t.period = period;
+    link(id);
+  }
+
+  void fire(Id id, uint32_t nowMs) {
+    Task& t = tasks[id];
+    if (!t.firing) return;      // aynı tick'te önceki bir callback iptal etti / yeniden kurdu
+    t.firing = false;
+
+    uint32_t late = timeReached(nowMs, t.due) ? nowMs - t.due : 0;
+    if (late > t.stats.maxLateMs) t.stats.maxLateMs = late;
+    t.stats.runs++;
+    wstats.fired++;
+
+    if (t.period) {
+      // Faz korunur (kayma birikmez); tamamen kaçırılan periyotlar atlanır ve sayılır
+      uint32_t skipped = late / t.period;
+      t.stats.missed += skipped;
+      t.due += (skipped + 1) * t.period;
+      link(id);                 // callback iptal edebilsin diye önce kur
+    } else if (late > t.slackMs) {
+      t.stats.missed++;
+    }
+    if (t.fn) t.fn(t.ctx);
+  }
+
+  void processTick(uint32_t nowMs) {
+    Id ids[SCHED_MAX_TASKS];
+    bool busy = false;
+
+    // Üst seviyeden alta: aynı tick'te inen görev bir alt kademede de işlenebilsin
+    for (uint8_t level = SCHED_LEVELS - 1; level >= 1; level--) {
+      uint8_t sh = shiftOf(level);
+      if (curMs & ((1UL << sh) - 1)) continue;
+      uint8_t idx = (curMs >> sh) & (SCHED_SLOTS - 1);
+      if (!(occupied[level] & (1ULL << idx))) continue;
+      uint8_t n = detach(level * SCHED_SLOTS + idx, ids);
+      for (uint8_t i = 0; i < n; i++) link(ids[i], true);
+      wstats.cascaded += n;
+      busy = true;
+    }
+
+    uint8_t idx = curMs & (SCHED_SLOTS - 1);
+    if (occupied[0] & (1ULL << idx)) {
+      uint8_t n = detach(idx, ids);
+      for (uint8_t i = 0; i < n; i++) tasks[ids[i]].firing = true;
+      for (uint8_t i = 0; i < n; i++) fire(ids[i], nowMs);
+      busy = true;
+    }
+    if (busy) wstats.ticks++;
+  }
+
+  // curMs'ten sonra bir şey olabilecek ilk tick'e uzaklık
+  uint32_t nextEventIn() const {
+    if (occupied[0]) {
+      uint8_t from = (curMs + 1) & (SCHED_SLOTS - 1);
+      uint64_t rot = from ? (occupied[0] >> from) | (occupied[0] << (64 - from)) : occupied[0];
+      uint32_t d = (uint32_t)__builtin_ctzll(rot) + 1;
+      uint32_t toEdge = SCHED_SLOTS - (curMs & (SCHED_SLOTS - 1));
+      return d < toEdge ? d : toEdge;
+    }
+    // Seviye 0 boş: ilk dolu seviyenin kademe sınırına atla
+    uint8_t level = 1;
+    while (level < SCHED_LEVELS - 1 && !occupied[level]) level++;
+    uint32_t span = 1UL << shiftOf(level);
+    return span - (curMs & (span - 1));
+  }
+
+public:
+  EnicScheduler() {
+    for (int i = 0; i < SCHED_LEVELS * SCHED_SLOTS; i++) head[i] = -1;
+  }
+
+  // Saat başlangıcı; görevler kurulmadan önce
+  void begin(uint32_t nowMs) { curMs = nowMs; }
+
+  Id add(const char* name, SchedFn fn = nullptr, void* ctx = nullptr, uint16_t slackMs = SCHED_DEFAULT_SLACK_MS) {
+    if (taskCount >= SCHED_MAX_TASKS) return -1;
+    Task& t = tasks[taskCount];
+    t.name = name;
+    t.fn = fn;
+    t.ctx = ctx;
+    t.slackMs = slackMs;
+    return (Id)taskCount++;
+  }
+
+  // Süreler son advance() zamanına göre
+  void startOnce(Id id, uint32_t delayMs) { arm(id, curMs + delayMs, 0); }
+  void startEvery(Id id, uint32_t periodMs, uint32_t firstDelayMs) {
+    arm(id, curMs + firstDelayMs, periodMs ? periodMs : 1);
+  }
+  void cancel(Id id) {
+    if (id < 0 || id >= taskCount) return;
+    unlink(id);
+    tasks[id].firing = false;
+  }
+
+  bool pending(Id id) const { return id >= 0 && id < taskCount && tasks[id].slot != NO_SLOT; }
+  int32_t remaining(Id id) const { return pending(id) ? timeUntil(curMs, tasks[id].due) : 0; }
+  uint32_t now() const { return curMs; }
+
+  // En yakın vadeye kalan süre, en fazla limit (uyku hesabı için; havuz taranır, tick başına değil)
+  uint32_t nextDueIn(uint32_t limit) const {
+    for (uint8_t i = 0; i < taskCount; i++) {
+      if (tasks[i].slot == NO_SLOT) continue;
+      int32_t r = timeUntil(curMs, tasks[i].due);
+      if (r <= 0) return 0;
+      if ((uint32_t)r < limit) limit = (uint32_t)r;
+    }
+    return limit;
+  }
+
+  // Vadesi gelenleri sırayla çalıştır (callback'ler burada, çağıranın task'ında)
+  void advance(uint32_t nowMs) {
+    wstats.advances++;
+    while ((int32_t)(nowMs - curMs) > 0) {
+      if (!armed) { curMs = nowMs; return; }
+      uint32_t step = nextEventIn();
+      if ((uint32_t)(nowMs - curMs) < step) { curMs = nowMs; return; }
+      curMs += step;
+      processTick(nowMs);
+    }
+  }
+
+  uint8_t getArmedCount() const { return armed; }
+  const WheelStats& getWheelStats() const { return wstats; }
+  const TaskStats& getTaskStats(Id id) const { return tasks[id].stats; }
+  uint32_t getMissedTotal() const {
+    uint32_t n = 0;
+    for (uint8_t i = 0; i < taskCount; i++) n += tasks[i].stats.missed;
+    return n;
+  }
+  void resetStats() {
+    wstats = WheelStats();
+    for (uint8_t i = 0; i < taskCount; i++) tasks[i].stats = TaskStats();
+  }
+
+  void printStats(Print& out) const {
+    enicPrintf(out, "sched now=%lu armed=%u advances=%lu ticks=%lu cascaded=%lu fired=%lu\n",
+                    (unsigned long)curMs, (unsigned)armed, (unsigned long)wstats.advances,
+                    (unsigned long)wstats.ticks, (unsigned long)wstats.cascaded, (unsigned long)wstats.fired);
+    out.println("id task           period  left    runs       missed  max_late");
+    for (uint8_t i = 0; i < taskCount; i++) {
+      const Task& t = tasks[i];
+      enicPrintf(out, "%-2u %-14s %-7lu %-7ld %-10lu %-7lu %lu\n", (unsigned)i, t.name, (unsigned long)t.period,
+                      (long)remaining(i), (unsigned long)t.stats.runs, (unsigned long)t.stats.missed,
+                      (unsigned long)t.stats.maxLateMs);
+    }
+  }
+};
+
+#endif
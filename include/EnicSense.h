@@ -10,149 +10,173 @@
 #define ENIC_SENSE_H
 
 #include <Arduino.h>
-
-#define TRIG_PIN 5
-#define ECHO_PIN 18
+#include "EnicSonar.h"
+#include "EnicRangeFilter.h"
+#include "EnicSound.h"
+#include "EnicQueue.h"
+#include "EnicTime.h"
+#include "EnicPower.h"
 
 #define BUZZER_PIN 4
 #define BUZZER_CHANNEL 0
 
+// Açılış ısınması: medyan penceresi dolana kadar sonarın izin verdiği en kısa aralıkla ping
+static const uint8_t SENSE_WARMUP_PINGS = EnicRangeFilter::MEDIAN_N;
+static const uint16_t SENSE_WARMUP_PING_MS = 30;
+
+// Sense task -> kontrol: filtrelenmiş mesafe + o ping'in ham değeri (harita filtre gecikmesi istemez)
+struct SenseSample {
+  RangeEstimate range;
+  float rawCm;            // >= SONAR_NO_ECHO: echo yok
+};
+
+// Kontrol -> sense task: ses / sonar / filtre istekleri
+struct SenseRequest {
+  enum Kind : uint8_t { PLAY, STOP, PING_INTERVAL, FILTER } kind;
+  uint16_t value;                     // FILTER: kapı (cm)
+  float a = 0.0f, b = 0.0f;           // FILTER: alpha, beta
+};
+
+// İki tarafı olan sınıf: update() sense task'ında (sonar, filtre, ses) koşar;
+// getDistance()/getRange()/playEffect()/stopSound()/setPingInterval() kontrol tarafındadır.
+// Taraflar arasında paylaşılan tek şey iki SPSC kuyruktur.
 class EnicSense {
 private:
-  float emaDist = 999.0f;
-  bool  emaInit = false;
-  float emaAlpha = 0.45f;
-
-  unsigned long lastPingMs = 0;
-  unsigned long pingIntervalMs = 80;
-
-  struct SoundJob {
-    bool active = false;
-    int type = 0;
-    int step = 0;
-    unsigned long nextMs = 0;
-  } sound;
-
-  float readDistanceOnce() {
-    digitalWrite(TRIG_PIN, LOW);
-    delayMicroseconds(2);
-    digitalWrite(TRIG_PIN, HIGH);
-    delayMicroseconds(10);
-    digitalWrite(TRIG_PIN, LOW);
-
-    long duration = pulseIn(ECHO_PIN, HIGH, 10000);
-    if (duration <= 0) return 999.0f;
-
-    float d = duration * 0.034f / 2.0f;
-    if (d <= 0 || d > 400) return 999.0f;
-    return d;
-  }
+  // ---- sense task tarafı ----
+  EnicRangeFilter range;
+
+  EnicSonar sonar;
 
-  void startSound(int type) {
-    sound.active = true;
-    sound.type = type;
-    sound.step = 0;
-    sound.nextMs = millis();
+  EnicSound sound;
+
+  // IDLE güç modunda seyrek ping; kullanıcının aralığı saklanır
+  EnicPower* power = nullptr;
+  uint16_t userPingMs = 40;
+  bool pingStretched = false;
+  bool pingHeld = false;
+  uint8_t warmupLeft = SENSE_WARMUP_PINGS;
+
+  uint16_t pingTarget() const {
+    if (warmupLeft) return SENSE_WARMUP_PING_MS;
+    return pingStretched && userPingMs < POWER_IDLE_PING_MS ? POWER_IDLE_PING_MS : userPingMs;
   }
 
+  // ---- kuyruklar ----
+  EnicQueue<SenseSample, 8> samples{"sense.samples"};
+  EnicQueue<SenseRequest, 8> requests{"sense.requests"};
+
+  // ---- kontrol tarafı ----
+  RangeEstimate latest;
+  float latestRawCm = SONAR_NO_ECHO;
+  uint32_t received = 0;
+
 public:
-  void begin() {
-    pinMode(TRIG_PIN, OUTPUT);
-    pinMode(ECHO_PIN, INPUT);
+  // warmupPings = 0: ilk pingten itibaren normal aralık (karşılaştırma için)
+  void begin(uint8_t warmupPings = SENSE_WARMUP_PINGS) {
+    sonar.begin();
+    sound.begin(BUZZER_PIN, BUZZER_CHANNEL);
+    warmupLeft = warmupPings;
+    sonar.setPingInterval(pingTarget());
+  }
 
-    ledcSetup(BUZZER_CHANNEL, 2000, 8);
-    ledcAttachPin(BUZZER_PIN, BUZZER_CHANNEL);
+  // Ses -> ACTIVE tutar; IDLE'da ping aralığı uzar, echo beklenirken light sleep yok
+  void setPower(EnicPower* p) { power = p; }
+
+  // ================= Kontrol tarafı =================
+  // Bekleyen örnekleri al; FSM tick'inden önce çağrılır
+  void receive() {
+    SenseSample s;
+    while (samples.pop(s)) {
+      latest = s.range;
+      latestRawCm = s.rawCm;
+      received++;
+    }
+  }
 
-    stopSound();
+  // Önde geçerli engel yoksa SONAR_NO_ECHO (999) -> FSM için "yol açık"
+  float getDistance() const {
+    return latest.valid ? latest.distCm : SONAR_NO_ECHO;
   }
 
-  float getDistance() const { return emaDist; }
+  // Mesafe + yaklaşma hızı + TTC, zaman damgası ve geçerlilik ile
+  const RangeEstimate& getRange() const { return latest; }
+
+  // Son ping'in filtresiz değeri; getSampleCount() değiştiyse yeni ping var
+  float getRawDistance() const { return latestRawCm; }
+  uint32_t getSampleCount() const { return received; }
 
-  void stopSound() {
-    ledcWriteTone(BUZZER_CHANNEL, 0);
-    ledcWrite(BUZZER_CHANNEL, 0);
-    sound.active = false;
-    sound.type = 0;
-    sound.step = 0;
+  void setPingInterval(unsigned long ms) {
+    requests.push({ SenseRequest::PING_INTERVAL, (uint16_t)(ms > 0xFFFF ? 0xFFFF : ms) });
   }
 
-  // 1:Korku, 2:Mutlu, 3:Konuşma, 4:Dans, 5:Ağlama
+  // Takipçi kazançları + aykırı değer kapısı (EnicRangeFilter sınırlarına kırpılır)
+  void setFilter(float alpha, float beta, float gateCm) {
+    requests.push({ SenseRequest::FILTER, (uint16_t)constrain(gateCm, 0.0f, 65535.0f), alpha, beta });
+  }
+
+  void stopSound() { requests.push({ SenseRequest::STOP, 0 }); }
+
+  // 1:Korku, 2:Mutlu, 3:Konuşma, 4:Dans, 5:Ağlama (SoundEffect). Öncelik/birleştirme EnicSound'da.
   void playEffect(int type) {
     if (type <= 0) return;
-    startSound(type);
+    requests.push({ SenseRequest::PLAY, (uint16_t)type });
   }
 
-  void update() {
-    unsigned long now = millis();
-
-    // Distance (EMA)
-    if (now - lastPingMs >= pingIntervalMs) {
-      lastPingMs = now;
+  // ================= Sense task tarafı =================
+  EnicRangeFilter& getRangeFilter() { return range; }
 
-      float d1 = readDistanceOnce();
-      delayMicroseconds(200);
-      float d2 = readDistanceOnce();
-      float d = (d1 + d2) * 0.5f;
+  // Isınma pingleri bitti: filtre penceresi dolu (echo yoksa "açık alan" kararı verilmiş)
+  bool isWarm() const { return warmupLeft == 0; }
+  const EnicSonar& getSonar() const { return sonar; }
+  EnicSound& getSound() { return sound; }
 
-      if (!emaInit) { emaDist = d; emaInit = true; }
-      else { emaDist = (emaAlpha * d) + ((1.0f - emaAlpha) * emaDist); }
+  void update() {
+    uint32_t now = nowMs32();
+
+    SenseRequest r;
+    while (requests.pop(r)) {
+      switch (r.kind) {
+        case SenseRequest::PLAY:          sound.play((uint8_t)r.value); break;
+        case SenseRequest::STOP:          sound.stop(); break;
+        case SenseRequest::PING_INTERVAL:
+          userPingMs = r.value;
+          sonar.setPingInterval(pingTarget());
+          break;
+        case SenseRequest::FILTER:
+          range.setGains(r.a, r.b);
+          range.setGate(r.value);
+          break;
+      }
     }
 
-    // Sound scheduler
-    if (!sound.active) return;
-    if (now < sound.nextMs) return;
-
-    switch (sound.type) {
-      case 1: { // FEAR sweep
-        static const int tones[] = {2000, 1700, 1400, 1100, 900, 750, 650, 550};
-        if (sound.step >= (int)(sizeof(tones)/sizeof(tones[0]))) { stopSound(); break; }
-        ledcWriteTone(BUZZER_CHANNEL, tones[sound.step++]);
-        ledcWrite(BUZZER_CHANNEL, 200);
-        sound.nextMs = now + 18;
-        break;
-      }
-      case 2: { // HAPPY 2 bips
-        if (sound.step == 0) {
-          ledcWriteTone(BUZZER_CHANNEL, 1000); ledcWrite(BUZZER_CHANNEL, 220);
-          sound.step = 1; sound.nextMs = now + 90;
-        } else if (sound.step == 1) {
-          ledcWriteTone(BUZZER_CHANNEL, 0); ledcWrite(BUZZER_CHANNEL, 0);
-          sound.step = 2; sound.nextMs = now + 35;
-        } else if (sound.step == 2) {
-          ledcWriteTone(BUZZER_CHANNEL, 2000); ledcWrite(BUZZER_CHANNEL, 220);
-          sound.step = 3; sound.nextMs = now + 90;
-        } else stopSound();
-        break;
+    if (power) {
+      bool idle = power->isIdle();
+      if (idle != pingStretched) {
+        pingStretched = idle;
+        sonar.setPingInterval(pingTarget());
       }
-      case 3: { // SPEAK short chirp
-        if (sound.step == 0) {
-          ledcWriteTone(BUZZER_CHANNEL, random(700, 2600));
-          ledcWrite(BUZZER_CHANNEL, 190);
-          sound.step = 1; sound.nextMs = now + 90;
-        } else stopSound();
-        break;
-      }
-      case 4: { // DANCE beat
-        if (sound.step == 0) { ledcWriteTone(BUZZER_CHANNEL, 120); ledcWrite(BUZZER_CHANNEL, 220); sound.step=1; sound.nextMs=now+70; }
-        else if (sound.step == 1) { ledcWriteTone(BUZZER_CHANNEL, 0); ledcWrite(BUZZER_CHANNEL, 0); sound.step=2; sound.nextMs=now+25; }
-        else if (sound.step == 2) { ledcWriteTone(BUZZER_CHANNEL, 850); ledcWrite(BUZZER_CHANNEL, 220); sound.step=3; sound.nextMs=now+55; }
-        else stopSound();
-        break;
-      }
-      case 5: { // CRY
-        static const int tones[] = {420, 360, 300, 360, 420, 0, 420, 360, 300, 0};
-        if (sound.step >= (int)(sizeof(tones)/sizeof(tones[0]))) { stopSound(); break; }
-        int t = tones[sound.step++];
-        ledcWriteTone(BUZZER_CHANNEL, t);
-        ledcWrite(BUZZER_CHANNEL, t == 0 ? 0 : 170);
-        sound.nextMs = now + 90;
-        break;
+    }
+
+    // Distance - ölçüm interrupt ile tamamlanır, burada sadece filtreye verilir
+    float d;
+    if (sonar.poll(now, d)) {
+      range.push(d, d >= SONAR_NO_ECHO, now);
+      samples.push({ range.get(), d });
+      if (warmupLeft && --warmupLeft == 0) sonar.setPingInterval(pingTarget());
+    }
+
+    // Nota zamanlaması esp_timer'da; host build'de burada ilerletilir
+    sound.poll();
+
+    if (power) {
+      power->hold(PWR_HOLD_SOUND, sound.isPlaying());
+      bool flying = sonar.inFlight();
+      if (flying != pingHeld) {
+        pingHeld = flying;
+        power->holdNoSleep(flying);
       }
-      default:
-        stopSound();
-        break;
     }
   }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,343 @@
+/**
+ * @file EnicSerialLink.h
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief UART demux: text command lines + COBS/CRC binary frames, periodic telemetry
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ *
+ * Metin komutları 0x00 içermez; 0x00 binary çerçeve başlatır, sonraki 0x00 bitirir.
+ * Ardışık 0x00'lar boş çerçeve sayılır ve binary modda kalınır (0x00 F1 0x00 0x00 F2 0x00).
+ *
+ * İki tarafı vardır:
+ *  - io task'ı: poll() baytları okur, çerçeveyi doğrular, ACK'i hemen yollar ve komutu cmdQ'ya atar
+ *  - kontrol task'ı: drainCommands() cmdQ'yu FSM'e uygular, publishStatus() telemetri anlık
+ *    görüntüsünü statusQ'ya atar; io task'ı onu bir sonraki poll()'da gönderir
+ */
+#ifndef ENIC_SERIAL_LINK_H
+#define ENIC_SERIAL_LINK_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "EnicProtocol.h"
+#include "EnicCommand.h"
+#include "EnicQueue.h"
+#include "EnicTime.h"
+#include "EnicState.h"
+#include "EnicMotor.h"
+#include "EnicSense.h"
+
+static const unsigned long ENIC_SERIAL_BAUD = 921600;
+
+// io -> kontrol: doğrulanmış tek komut (binary kayıt veya metin satırı)
+struct LinkCommand {
+  uint8_t op;                         // ProtoOp, LINK_TEXT: metin satırı
+  uint8_t len;
+  uint8_t data[CMD_LINE_MAX + 1];
+};
+
+static const uint8_t LINK_TEXT = 0x00;
+
+class EnicSerialLink {
+public:
+  struct LinkStats {
+    uint32_t rxFrames = 0;      // CRC doğru çerçeve
+    uint32_t rxErrors = 0;      // COBS / CRC / boyut
+    uint32_t rxDuplicates = 0;  // aynı seq tekrar
+    uint32_t rxSeqGaps = 0;     // atlanan seq sayısı (kayıp çerçeve)
+    uint32_t records = 0;       // kuyruğa alınan komut kaydı
+    uint32_t badRecords = 0;
+    uint32_t busy = 0;          // cmdQ dolu -> ACK_BUSY
+    uint32_t textLines = 0;
+    uint32_t textDropped = 0;   // cmdQ dolu iken gelen metin satırı
+    uint32_t txFrames = 0;
+  };
+
+private:
+  EnicStateMachine* brain;
+  EnicMotor* motor;
+  EnicSense* sense;
+
+  EnicQueue<LinkCommand, 16> cmdQ{"link.cmd"};
+  EnicQueue<ProtoTelemetry, 2> statusQ{"link.status"};
+
+  // ---- io tarafı: RX ----
+  EnicLineReader text;
+  bool inFrame = false;
+  bool frameOverflow = false;
+  uint8_t frame[PROTO_MAX_WIRE];
+  size_t frameLen = 0;
+
+  bool haveSeq = false;
+  uint8_t lastSeq = 0;          // son kabul edilen çerçeve (tekrar tespiti)
+  bool haveRxSeq = false;
+  uint8_t rxSeq = 0;            // son görülen çerçeve (kayıp sayımı; BUSY dahil)
+  uint8_t lastStatus = ACK_OK;
+  uint8_t lastApplied = 0;
+
+  // ---- io tarafı: TX ----
+  uint8_t txSeq = 0;
+
+  // io yazar, kontrol okur
+  std::atomic<uint16_t> telemetryPeriodMs{0};   // 0: kapalı (host OP_TELEMETRY ile açar)
+  std::atomic<bool> telemetryRestart{false};
+
+  // ---- kontrol tarafı ----
+  uint32_t nextTelemetryMs = 0;
+
+  // kontrol turu periyodu (drainCommands çağrıları arası), telemetri penceresi başına
+  uint32_t lastDrainUs = 0;
+  uint32_t loopSumUs = 0;
+  uint32_t loopMaxUs = 0;
+  uint32_t loopCount = 0;
+
+  LinkStats stats;
+
+  static uint16_t sat16(uint32_t v) { return v > 0xFFFF ? 0xFFFF : (uint16_t)v; }
+  static int16_t sat16s(float v) {
+    if (v > 32767.0f) return 32767;
+    if (v < -32768.0f) return -32768;
+    return (int16_t)v;
+  }
+
+  void sendFrame(uint8_t type, uint8_t seq, const uint8_t* body, size_t len) {
+    uint8_t wire[PROTO_MAX_WIRE + 2];
+    size_t n = protoBuildFrame(type, seq, body, len, wire);
+    if (n == 0) return;
+    Serial.write(wire, n);
+    stats.txFrames++;
+  }
+
+  void sendAck(uint8_t seq, uint8_t status, uint8_t applied) {
+    uint8_t body[3] = { seq, status, applied };
+    sendFrame(MSG_ACK, seq, body, sizeof(body));
+  }
+
+  // io: tek kaydın argümanlarını doğrula (uygulama kontrol tarafında)
+  static bool checkRecord(uint8_t op, const uint8_t* d, uint8_t len) {
+    switch (op) {
+      case OP_DRIVE:     return len == 6;
+      case OP_FACE:      return len == 4 && d[0] < FACE_COUNT;
+      case OP_SOUND:     return len == 1;
+      case OP_MODE:      return len == 1 && d[0] <= MODE_BOMB;
+      case OP_PING:      return len == 2 && getU16(d) != 0;
+      case OP_TELEMETRY: return len == 2;
+      default:           return true;   // bilinmeyen op: atla
+    }
+  }
+
+  static bool knownOp(uint8_t op) { return op >= OP_DRIVE && op <= OP_PING; }
+
+  // kontrol: doğrulanmış kaydı uygula
+  void applyRecord(uint8_t op, const uint8_t* d, uint8_t len) {
+    if (EnicRecorder* rec = brain->getRecorder()) {
+      rec->record(LOG_CMD, 0x80 | op, len >= 2 ? getI16(d) : (len ? d[0] : 0),
+                  len >= 4 ? getI16(d + 2) : 0, len >= 6 ? getI16(d + 4) : 0);
+    }
+
+    switch (op) {
+      case OP_DRIVE:
+        brain->driveManual(getI16(d), getI16(d + 2), getU16(d + 4));
+        return;
+
+      case OP_FACE:
+        brain->showFace((FaceType)d[0], getU16(d + 1), d[3]);
+        return;
+
+      case OP_SOUND:
+        sense->playEffect(d[0]);
+        return;
+
+      case OP_MODE: {
+        static const AppEvent modeEvent[] = { EV_STOP, EV_AUTO, EV_DANCE, EV_BOMB };
+        brain->requestMode(modeEvent[d[0]]);
+        return;
+      }
+
+      case OP_PING:
+        brain->setPingInterval(getU16(d));   // ASCII ping gibi: depo (30 ms taban, NVS)
+        return;
+
+      default:
+        return;
+    }
+  }
+
+  void handleCmd(uint8_t seq, const uint8_t* body, size_t len) {
+    if (haveSeq && seq == lastSeq) {
+      stats.rxDuplicates++;
+      sendAck(seq, ACK_DUPLICATE, lastApplied);
+      return;
+    }
+
+    // Sadece ileri atlamalar kayıp sayılır; BUSY sonrası geri gelen tekrar denemeler değil
+    uint8_t ahead = (uint8_t)(seq - rxSeq);
+    if (!haveRxSeq || (ahead != 0 && ahead < 128)) {
+      if (haveRxSeq) stats.rxSeqGaps += (uint8_t)(ahead - 1);
+      haveRxSeq = true;
+      rxSeq = seq;
+    }
+
+    // Önce doğrula ve kuyruğa girecek kayıtları say: çerçeve ya tamamen alınır ya hiç (ACK_BUSY)
+    uint8_t status = ACK_OK;
+    uint8_t valid = 0;
+    uint32_t needed = 0;
+    size_t r = 0;
+    while (r < len) {
+      if (r + 2 > len || r + 2 + body[r + 1] > len) { status = ACK_BAD_RECORD; break; }
+      uint8_t op = body[r], n = body[r + 1];
+      if (!checkRecord(op, body + r + 2, n)) { status = ACK_BAD_RECORD; break; }
+      if (knownOp(op)) needed++;
+      valid++;
+      r += 2 + n;
+    }
+
+    // Tek üretici io task'ı: boş yer kontrolden sonra sadece artabilir
+    if (needed > cmdQ.capacity() - cmdQ.size()) {
+      stats.busy++;
+      sendAck(seq, ACK_BUSY, 0);     // seq kaydedilmez; aynı seq ile tekrar denenebilir
+      return;
+    }
+
+    r = 0;
+    for (uint8_t i = 0; i < valid; i++) {
+      uint8_t op = body[r], n = body[r + 1];
+      if (op == OP_TELEMETRY) {
+        telemetryPeriodMs.store(getU16(body + r + 2));
+        telemetryRestart.store(true);
+      } else if (knownOp(op)) {
+        LinkCommand c;
+        c.op = op;
+        c.len = n;
+        memcpy(c.data, body + r + 2, n);
+        cmdQ.push(c);
+      }
+      r += 2 + n;
+    }
+
+    stats.records += valid;
+    if (status != ACK_OK) stats.badRecords++;
+
+    haveSeq = true;
+    lastSeq = seq;
+    lastStatus = status;
+    lastApplied = valid;
+    sendAck(seq, status, valid);
+  }
+
+  void endFrame() {
+    if (frameLen == 0) return;                // boş çerçeve / ardışık ayraç
+
+    uint8_t payload[PROTO_MAX_PAYLOAD];
+    size_t len = frameOverflow ? 0 : protoParseFrame(frame, frameLen, payload, sizeof(payload));
+    frameLen = 0;
+    frameOverflow = false;
+    inFrame = false;
+
+    if (len == 0) { stats.rxErrors++; return; }
+    stats.rxFrames++;
+
+    if (payload[0] == MSG_CMD) handleCmd(payload[1], payload + PROTO_HEADER, len - PROTO_HEADER);
+  }
+
+  void feed(uint8_t c) {
+    if (c == PROTO_DELIM) {
+      if (inFrame) endFrame();
+      else inFrame = true;
+      return;
+    }
+
+    if (inFrame) {
+      if (frameLen < sizeof(frame)) frame[frameLen++] = c;
+      else frameOverflow = true;
+      return;
+    }
+
+    if (text.feed((char)c)) {
+      stats.textLines++;
+      LinkCommand cmd;
+      cmd.op = LINK_TEXT;
+      strncpy((char*)cmd.data, text.line(), CMD_LINE_MAX);
+      cmd.data[CMD_LINE_MAX] = '\0';
+      cmd.len = (uint8_t)strlen((char*)cmd.data);
+      if (!cmdQ.push(cmd)) stats.textDropped++;
+    }
+  }
+
+public:
+  EnicSerialLink(EnicStateMachine* b, EnicMotor* m, EnicSense* s)
+    : brain(b), motor(m), sense(s) {}
+
+  // ================= io task tarafı =================
+  // Gelen baytları işle, kontrol tarafının hazırladığı telemetriyi gönder
+  void poll() {
+    while (Serial.available()) feed((uint8_t)Serial.read());
+
+    ProtoTelemetry t;
+    while (statusQ.pop(t)) {
+      t.rxFrames = (uint16_t)stats.rxFrames;
+      t.rxErrors = (uint16_t)stats.rxErrors;
+      uint8_t body[PROTO_TELEMETRY_LEN];
+      sendFrame(MSG_TELEMETRY, txSeq++, body, packTelemetry(t, body));
+    }
+  }
+
+  // ================= Kontrol task tarafı =================
+  // Kontrol turunun başında: bekleyen komutları FSM'e uygula
+  void drainCommands() {
+    uint32_t nowUs = nowUs32();
+    if (lastDrainUs != 0) {
+      uint32_t dt = nowUs - lastDrainUs;
+      loopSumUs += dt;
+      loopCount++;
+      if (dt > loopMaxUs) loopMaxUs = dt;
+    }
+    lastDrainUs = nowUs;
+
+    LinkCommand c;
+    while (cmdQ.pop(c)) {
+      if (c.op == LINK_TEXT) brain->handleCommand((char*)c.data);
+      else applyRecord(c.op, c.data, c.len);
+    }
+  }
+
+  // Telemetri akışı açık (host izliyor): güç yöneticisi ACTIVE tutar
+  bool isStreaming() const { return telemetryPeriodMs.load() != 0; }
+
+  // Kontrol turunun sonunda: zamanı geldiyse durum anlık görüntüsünü io tarafına ver
+  void publishStatus() {
+    uint16_t period = telemetryPeriodMs.load();
+    if (period == 0) return;
+
+    uint32_t nowMs = nowMs32();
+    if (telemetryRestart.exchange(false)) nextTelemetryMs = nowMs;
+    if (!timeReached(nowMs, nextTelemetryMs)) return;
+    nextTelemetryMs += period;
+    if (timeReached(nowMs, nextTelemetryMs)) nextTelemetryMs = nowMs + period; // geride kaldıysa yakala
+
+    const RangeEstimate& r = sense->getRange();
+
+    ProtoTelemetry t;
+    t.tMs = nowMs;
+    t.state = (uint8_t)brain->getState();
+    t.flags = r.valid ? 0x01 : 0x00;
+    t.distMm = r.valid ? sat16((uint32_t)(r.distCm * 10.0f)) : PROTO_U16_NONE;
+    t.closingMmS = sat16s(r.closingCmS * 10.0f);
+    t.ttcMs = (r.valid && r.ttcS < RANGE_TTC_NONE) ? sat16((uint32_t)(r.ttcS * 1000.0f)) : PROTO_U16_NONE;
+    t.targetLeft = (int16_t)motor->getTargetLeft();
+    t.targetRight = (int16_t)motor->getTargetRight();
+    t.currentLeft = (int16_t)motor->getCurrentLeft();
+    t.currentRight = (int16_t)motor->getCurrentRight();
+    t.loopAvgUs = loopCount ? sat16(loopSumUs / loopCount) : 0;
+    t.loopMaxUs = sat16(loopMaxUs);
+    t.rxFrames = 0;   // io tarafı doldurur
+    t.rxErrors = 0;
+    statusQ.push(t);  // io geride kaldıysa bu örnek atılır (dropped sayılır)
+
+    loopSumUs = loopMaxUs = loopCount = 0;
+  }
+
+  const LinkStats& getStats() const { return stats; }
+};
+
+#endif
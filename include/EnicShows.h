@@ -0,0 +1,73 @@
+/**
+ * @file EnicShows.h
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Choreography data for the timeline player (bomb countdown, dance)
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ *
+ * Yeni gösteri = yeni anahtar tablosu + Timeline satırı. Anahtarlar atMs'e göre sıralı olmalı.
+ */
+#ifndef ENIC_SHOWS_H
+#define ENIC_SHOWS_H
+
+#include "EnicTimeline.h"
+#include "EnicSound.h"
+
+#define TL_SCENE_KEY(at, scene, param, frameMs) { at, TL_SCENE, scene, param, frameMs }
+#define TL_SOUND_KEY(at, effect)                { at, TL_SOUND, effect, 0, 0 }
+#define TL_MOTOR_KEY(at, left, right)           { at, TL_MOTOR, 0, left, right }
+
+// ---------------- BOMB: 30 s ----------------
+// 0-5s fitil + geri sayım, 5-7s flash, 7-12s patlama, 12-30s duman; ekran ~14 FPS
+static const TimelineKey SHOW_BOMB_KEYS[] = {
+  TL_MOTOR_KEY(    0, 0, 0),
+  TL_SCENE_KEY(    0, SCENE_BOMB, 0, 70),
+  TL_SOUND_KEY(    0, SND_SPEAK),             // fitil chirp'leri (250-600 ms arası)
+  TL_SOUND_KEY(  420, SND_SPEAK),
+  TL_SOUND_KEY(  810, SND_SPEAK),
+  TL_SOUND_KEY( 1300, SND_SPEAK),
+  TL_SOUND_KEY( 1650, SND_SPEAK),
+  TL_SOUND_KEY( 2120, SND_SPEAK),
+  TL_SOUND_KEY( 2600, SND_SPEAK),
+  TL_SOUND_KEY( 2950, SND_SPEAK),
+  TL_SOUND_KEY( 3420, SND_SPEAK),
+  TL_SOUND_KEY( 3900, SND_SPEAK),
+  TL_SOUND_KEY( 4260, SND_SPEAK),
+  TL_SOUND_KEY( 4700, SND_SPEAK),
+  TL_SCENE_KEY( 5000, SCENE_BOMB, 1, 70),
+  TL_SCENE_KEY( 7000, SCENE_BOMB, 2, 70),
+  TL_SOUND_KEY( 7000, SND_FEAR),              // patlama
+  TL_SCENE_KEY(12000, SCENE_BOMB, 3, 70),
+  TL_SOUND_KEY(12000, SND_HAPPY),             // "aftershock"
+};
+
+// ---------------- DANCE: 2 ölçü x 4 vuruş, 250 ms ----------------
+// Vuruşta hareket, arada dur: sol, sağ, ileri, geri. Her hareket duruştan başlar ve durağı kendi
+// başlangıcından sayılır (EnicTimeline motor parçası): kontrol periyodu ne olursa olsun zıt hareketler
+// eşit sürer, rampalar simetrik -> açık çevrimde robot yerinde kalır (timeline bench: tur sonu net yol
+// tepe yolun %10'u altında). Kapalı çevrimde (ENIC_ENCODERS) PI integrali hareketten harekete taşındığından
+// birkaç turda kayabilir.
+static const TimelineKey SHOW_DANCE_KEYS[] = {
+  TL_SCENE_KEY(   0, SCENE_DANCE, 0, 0), TL_SOUND_KEY(   0, SND_DANCE), TL_MOTOR_KEY(   0, -150,  150),
+  TL_SCENE_KEY( 250, SCENE_DANCE, 1, 0), TL_SOUND_KEY( 250, SND_DANCE), TL_MOTOR_KEY( 250,    0,    0),
+  TL_SCENE_KEY( 500, SCENE_DANCE, 2, 0), TL_SOUND_KEY( 500, SND_DANCE), TL_MOTOR_KEY( 500,  150, -150),
+  TL_SCENE_KEY( 750, SCENE_DANCE, 3, 0), TL_SOUND_KEY( 750, SND_DANCE), TL_MOTOR_KEY( 750,    0,    0),
+  TL_SCENE_KEY(1000, SCENE_DANCE, 0, 0), TL_SOUND_KEY(1000, SND_DANCE), TL_MOTOR_KEY(1000,  160,  160),
+  TL_SCENE_KEY(1250, SCENE_DANCE, 1, 0), TL_SOUND_KEY(1250, SND_DANCE), TL_MOTOR_KEY(1250,    0,    0),
+  TL_SCENE_KEY(1500, SCENE_DANCE, 2, 0), TL_SOUND_KEY(1500, SND_DANCE), TL_MOTOR_KEY(1500, -160, -160),
+  TL_SCENE_KEY(1750, SCENE_DANCE, 3, 0), TL_SOUND_KEY(1750, SND_DANCE), TL_MOTOR_KEY(1750,    0,    0),
+};
+
+#undef TL_SCENE_KEY
+#undef TL_SOUND_KEY
+#undef TL_MOTOR_KEY
+
+#define TL_SHOW(keys, durationMs, loop) { keys, (uint16_t)(sizeof(keys) / sizeof(keys[0])), durationMs, loop }
+
+static const Timeline SHOW_BOMB  = TL_SHOW(SHOW_BOMB_KEYS, 30000, false);
+static const Timeline SHOW_DANCE = TL_SHOW(SHOW_DANCE_KEYS, 2000, true);
+
+#undef TL_SHOW
+
+#endif
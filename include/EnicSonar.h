@@ -0,0 +1,120 @@
+/**
+ * @file EnicSonar.h
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Interrupt-driven, non-blocking HC-SR04 ranging engine
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ */
+#ifndef ENIC_SONAR_H
+#define ENIC_SONAR_H
+
+#include <Arduino.h>
+#include "EnicTime.h"
+
+#define TRIG_PIN 5
+#define ECHO_PIN 18
+
+// Sonuç yok / menzil dışı
+static const float SONAR_NO_ECHO = 999.0f;
+static const float SONAR_MAX_CM  = 400.0f;
+
+// 400 cm gidiş-dönüş ~23.5 ms; üstü zaman aşımı sayılır
+static const unsigned long SONAR_ECHO_TIMEOUT_US = 26000;
+
+class EnicSonar {
+private:
+  enum PingState : uint8_t { PING_IDLE, PING_TRIGGERED, PING_ECHO_HIGH, PING_DONE };
+
+  // ISR ile paylaşılan alanlar
+  volatile uint8_t state = PING_IDLE;
+  volatile uint32_t riseUs = 0;
+  volatile uint32_t widthUs = 0;
+
+  uint32_t trigUs = 0;
+  uint32_t lastPingMs = 0;
+  unsigned long pingIntervalMs = 40;
+
+  uint32_t samples = 0;
+  uint32_t timeouts = 0;
+
+  // Echo hattının iki kenarı: yükselen -> zaman damgası, düşen -> genişlik
+  static void IRAM_ATTR echoIsr(void* arg) {
+    EnicSonar* self = (EnicSonar*)arg;
+    uint32_t t = nowUs32();
+    if (digitalRead(ECHO_PIN)) {
+      if (self->state == PING_TRIGGERED) {
+        self->riseUs = t;
+        self->state = PING_ECHO_HIGH;
+      }
+    } else if (self->state == PING_ECHO_HIGH) {
+      self->widthUs = t - self->riseUs;
+      self->state = PING_DONE;
+    }
+  }
+
+  void trigger() {
+    digitalWrite(TRIG_PIN, HIGH);
+    delayMicroseconds(10);
+    digitalWrite(TRIG_PIN, LOW);
+    trigUs = nowUs32();
+    state = PING_TRIGGERED;
+  }
+
+public:
+  void begin() {
+    pinMode(TRIG_PIN, OUTPUT);
+    pinMode(ECHO_PIN, INPUT);
+    digitalWrite(TRIG_PIN, LOW);
+    state = PING_IDLE;
+    lastPingMs = nowMs32() - pingIntervalMs;   // ilk ping hemen, açılış saatinden bağımsız
+    attachInterruptArg(ECHO_PIN, echoIsr, this, CHANGE);
+  }
+
+  void setPingInterval(unsigned long ms) {
+    if (ms < 30) ms = 30;     // önceki echo'nun sönmesi için
+    if (ms > 1000) ms = 1000;
+    pingIntervalMs = ms;
+  }
+  unsigned long getPingInterval() const { return pingIntervalMs; }
+
+  // Tetiklendi, echo kenarları bekleniyor (zamanlama hassas)
+  bool inFlight() const { uint8_t st = state; return st == PING_TRIGGERED || st == PING_ECHO_HIGH; }
+
+  uint32_t getSampleCount() const { return samples; }
+  uint32_t getTimeoutCount() const { return timeouts; }
+
+  // Loop'tan çağrılır, hiç beklemez. Yeni ölçüm tamamlandıysa true döner;
+  // cm yoksa SONAR_NO_ECHO.
+  bool poll(uint32_t nowMs, float& outCm) {
+    uint8_t st = state;
+
+    if (st == PING_DONE) {
+      uint32_t w = widthUs;
+      state = PING_IDLE;
+      samples++;
+
+      float d = w * 0.034f / 2.0f;
+      outCm = (d <= 0 || d > SONAR_MAX_CM) ? SONAR_NO_ECHO : d;
+      return true;
+    }
+
+    if (st == PING_TRIGGERED || st == PING_ECHO_HIGH) {
+      if (nowUs32() - trigUs < SONAR_ECHO_TIMEOUT_US) return false;
+      state = PING_IDLE;
+      samples++;
+      timeouts++;
+      outCm = SONAR_NO_ECHO;
+      return true;
+    }
+
+    // PING_IDLE: sıradaki ping; modül önceki echo'yu hâlâ tutuyorsa bekle
+    if (nowMs - lastPingMs >= pingIntervalMs && !digitalRead(ECHO_PIN)) {
+      lastPingMs = nowMs;
+      trigger();
+    }
+    return false;
+  }
+};
+
+#endif
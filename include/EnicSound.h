@@ -0,0 +1,301 @@
+/**
+ * @file EnicSound.h
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Table-driven buzzer engine: flash note tables, esp_timer clock, priority queue
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ *
+ * Nota sınırları esp_timer ile (mutlak deadline, loop yükünden bağımsız) işlenir.
+ * Host build'de esp_timer yok: poll() ile aynı step() çağrılır.
+ *
+ * İstek kuralları (playEffect):
+ *  - Aynı efekt çalıyor / kuyrukta: SND_MERGE -> yok sayılır, SND_RESTART -> baştan başlar
+ *  - Daha yüksek öncelik: çalanı keser
+ *  - Eşit / düşük öncelik: öncelik sırasıyla kuyruğa (dolu ise en düşük atılır)
+ */
+#ifndef ENIC_SOUND_H
+#define ENIC_SOUND_H
+
+#include <Arduino.h>
+#if defined(ARDUINO_ARCH_ESP32)
+#include "esp_timer.h"
+#endif
+
+// Efekt numaraları (EnicSense::playEffect ile uyumlu)
+enum SoundEffect : uint8_t {
+  SND_NONE  = 0,
+  SND_FEAR  = 1,
+  SND_HAPPY = 2,
+  SND_SPEAK = 3,
+  SND_DANCE = 4,
+  SND_CRY   = 5,
+  SND_EFFECT_COUNT
+};
+
+enum SoundMerge : uint8_t { SND_MERGE, SND_RESTART };
+
+struct SoundNote {
+  uint16_t freqHz;      // 0: sus
+  uint16_t freqSpan;    // >0: freqHz + random(0, span)
+  uint8_t  duty;
+  uint16_t ms;
+};
+
+struct SoundEffectDef {
+  const SoundNote* notes;
+  uint8_t count;
+  uint8_t priority;     // büyük olan keser
+  SoundMerge merge;
+};
+
+// ---------------- Nota tabloları (flash) ----------------
+static const SoundNote SND_NOTES_FEAR[] = {
+  {2000, 0, 200, 18}, {1700, 0, 200, 18}, {1400, 0, 200, 18}, {1100, 0, 200, 18},
+  { 900, 0, 200, 18}, { 750, 0, 200, 18}, { 650, 0, 200, 18}, { 550, 0, 200, 18},
+};
+static const SoundNote SND_NOTES_HAPPY[] = {
+  {1000, 0, 220, 90}, {0, 0, 0, 35}, {2000, 0, 220, 90},
+};
+static const SoundNote SND_NOTES_SPEAK[] = {
+  {700, 1900, 190, 90},
+};
+static const SoundNote SND_NOTES_DANCE[] = {
+  {120, 0, 220, 70}, {0, 0, 0, 25}, {850, 0, 220, 55},
+};
+static const SoundNote SND_NOTES_CRY[] = {
+  {420, 0, 170, 90}, {360, 0, 170, 90}, {300, 0, 170, 90}, {360, 0, 170, 90}, {420, 0, 170, 90},
+  {  0, 0,   0, 90}, {420, 0, 170, 90}, {360, 0, 170, 90}, {300, 0, 170, 90}, {  0, 0,   0, 90},
+};
+
+#define SND_DEF(tbl, prio, merge) { tbl, (uint8_t)(sizeof(tbl) / sizeof(tbl[0])), prio, merge }
+
+// SoundEffect sırasıyla; yeni efekt = yeni tablo + yeni satır
+static const SoundEffectDef SOUND_EFFECTS[SND_EFFECT_COUNT] = {
+  { nullptr, 0, 0, SND_MERGE },                     // SND_NONE
+  SND_DEF(SND_NOTES_FEAR,  3, SND_MERGE),
+  SND_DEF(SND_NOTES_HAPPY, 2, SND_MERGE),
+  SND_DEF(SND_NOTES_SPEAK, 1, SND_RESTART),
+  SND_DEF(SND_NOTES_DANCE, 0, SND_MERGE),
+  SND_DEF(SND_NOTES_CRY,   2, SND_MERGE),
+};
+
+#undef SND_DEF
+
+class EnicSound {
+public:
+  struct SoundStats {
+    uint32_t requested = 0;
+    uint32_t started = 0;     // çalmaya başlayan efekt
+    uint32_t preempted = 0;   // daha yüksek öncelik / restart ile kesilen
+    uint32_t merged = 0;      // zaten çalıyor / kuyrukta olduğu için yok sayılan
+    uint32_t queued = 0;
+    uint32_t dropped = 0;     // kuyruk taşması
+    uint32_t notes = 0;
+  };
+
+private:
+  static const uint8_t QUEUE_CAP = 4;
+
+  uint8_t channel = 0;
+
+  // Paylaşılan durum (loop task <-> esp_timer task), lock altında
+  volatile uint8_t current = SND_NONE;
+  volatile uint8_t noteIdx = 0;
+  volatile bool switchPending = false;  // current baştan başlamalı / susmalı
+  uint8_t queue[QUEUE_CAP];
+  uint8_t queueLen = 0;
+  SoundStats stats;
+
+  // Sadece step() tarafı
+  int64_t deadlineUs = 0;
+  bool running = false;
+
+#if defined(ARDUINO_ARCH_ESP32)
+  portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+  esp_timer_handle_t timer = nullptr;
+  void lock()   { portENTER_CRITICAL(&mux); }
+  void unlock() { portEXIT_CRITICAL(&mux); }
+  static int64_t nowUs() { return esp_timer_get_time(); }
+
+  static void onTimer(void* arg) { ((EnicSound*)arg)->onTimerFire(esp_timer_get_time()); }
+
+  // kick() ile callback'in kendi yeniden kurulumu yarışırsa erken tetiklenme olabilir: deadline'a ertele
+  void onTimerFire(int64_t now) {
+    if (!switchPending && running && now + 200 < deadlineUs) {
+      esp_timer_start_once(timer, (uint64_t)(deadlineUs - now));
+      return;
+    }
+    step(now);
+  }
+#else
+  void lock() {}
+  void unlock() {}
+  static int64_t nowUs() { return esp_timer_get_time(); }
+#endif
+
+  bool inQueue(uint8_t e) const {
+    for (uint8_t i = 0; i < queueLen; i++) if (queue[i] == e) return true;
+    return false;
+  }
+
+  // Öncelik sırasına göre ekle (eşitlerde FIFO); doluysa en düşük atılır
+  void enqueue(uint8_t e) {
+    uint8_t prio = SOUND_EFFECTS[e].priority;
+    if (queueLen == QUEUE_CAP) {
+      if (SOUND_EFFECTS[queue[QUEUE_CAP - 1]].priority >= prio) { stats.dropped++; return; }
+      queueLen--;
+      stats.dropped++;
+    }
+    uint8_t i = queueLen;
+    while (i > 0 && SOUND_EFFECTS[queue[i - 1]].priority < prio) { queue[i] = queue[i - 1]; i--; }
+    queue[i] = e;
+    queueLen++;
+    stats.queued++;
+  }
+
+  // Timer'ı hemen tetikle (çalan notanın kalanı iptal)
+  void kick() {
+#if defined(ARDUINO_ARCH_ESP32)
+    esp_timer_stop(timer);
+    // Callback kendini yeniden kurmuşsa INVALID_STATE döner; switchPending bir sonraki nota sınırında işlenir
+    esp_timer_start_once(timer, 1);
+#endif
+  }
+
+  void writeTone(uint16_t freq, uint8_t duty) {
+    ledcWriteTone(channel, freq);
+    ledcWrite(channel, freq == 0 ? 0 : duty);
+  }
+
+  // Bir nota sınırı: sıradaki notayı çal, süresini (µs) döndür; 0 = sessiz/bitti
+  uint32_t advance(int64_t now) {
+    lock();
+    if (switchPending) {
+      switchPending = false;
+      deadlineUs = now;
+    } else if (current != SND_NONE) {
+      if (++noteIdx >= SOUND_EFFECTS[current].count) {
+        current = SND_NONE;
+        noteIdx = 0;
+        if (queueLen) {
+          current = queue[0];
+          for (uint8_t i = 1; i < queueLen; i++) queue[i - 1] = queue[i];
+          queueLen--;
+          stats.started++;
+        }
+      }
+    }
+
+    uint8_t e = current;
+    SoundNote n = {0, 0, 0, 0};
+    if (e != SND_NONE) { n = SOUND_EFFECTS[e].notes[noteIdx]; stats.notes++; }
+    unlock();
+
+    if (e == SND_NONE) { writeTone(0, 0); return 0; }
+
+    uint16_t f = n.freqHz;
+    if (f && n.freqSpan) f = (uint16_t)(f + random(0, n.freqSpan));
+    writeTone(f, n.duty);
+    return (uint32_t)n.ms * 1000UL;
+  }
+
+  // Timer callback / host poll ortak yolu; mutlak deadline ile kayma birikmez
+  void step(int64_t now) {
+    uint32_t d = advance(now);
+    running = (d != 0);
+    if (!running) return;
+    deadlineUs += d;
+
+#if defined(ARDUINO_ARCH_ESP32)
+    int64_t wait = deadlineUs - esp_timer_get_time();
+    if (wait < 1) wait = 1;
+    esp_timer_start_once(timer, (uint64_t)wait);
+#endif
+  }
+
+public:
+  void begin(uint8_t pin, uint8_t ch) {
+    channel = ch;
+    ledcSetup(channel, 2000, 8);
+    ledcAttachPin(pin, channel);
+    writeTone(0, 0);
+
+#if defined(ARDUINO_ARCH_ESP32)
+    if (!timer) {
+      esp_timer_create_args_t args = {};
+      args.callback = &EnicSound::onTimer;
+      args.arg = this;
+      args.dispatch_method = ESP_TIMER_TASK;
+      args.name = "enic_snd";
+      esp_timer_create(&args, &timer);
+    }
+#endif
+  }
+
+  void play(uint8_t e) {
+    if (e == SND_NONE || e >= SND_EFFECT_COUNT) return;
+    const SoundEffectDef& def = SOUND_EFFECTS[e];
+    bool doKick = false;
+
+    lock();
+    stats.requested++;
+    if (current == e) {
+      if (def.merge == SND_RESTART) {
+        noteIdx = 0; switchPending = true; doKick = true;
+        stats.preempted++; stats.started++;
+      } else {
+        stats.merged++;
+      }
+    } else if (inQueue(e)) {
+      stats.merged++;
+    } else if (current == SND_NONE) {
+      current = e; noteIdx = 0; switchPending = true; doKick = true;
+      stats.started++;
+    } else if (def.priority > SOUND_EFFECTS[current].priority) {
+      current = e; noteIdx = 0; switchPending = true; doKick = true;
+      stats.preempted++; stats.started++;
+    } else {
+      enqueue(e);
+    }
+    unlock();
+
+    if (doKick) kick();
+  }
+
+  // Çalanı ve kuyruğu boşalt
+  void stop() {
+    lock();
+    current = SND_NONE;
+    noteIdx = 0;
+    queueLen = 0;
+    switchPending = true;
+    unlock();
+    kick();
+  }
+
+  // Host: nota sınırlarını sanal saate göre işle. ESP32'de esp_timer sürer, no-op.
+  void poll() {
+#if !defined(ARDUINO_ARCH_ESP32)
+    int64_t now = nowUs();
+    while (switchPending || (running && now >= deadlineUs)) step(switchPending ? now : deadlineUs);
+#endif
+  }
+
+  bool isPlaying() const { return current != SND_NONE; }
+  uint8_t getCurrent() const { return current; }
+  uint8_t getQueueLength() const { return queueLen; }
+
+  const SoundStats& getStats() const { return stats; }
+  void resetStats() { lock(); stats = SoundStats(); unlock(); }
+
+  // Efekt toplam süresi (ms), bench / zamanlama için
+  static uint32_t effectMs(uint8_t e) {
+    if (e == SND_NONE || e >= SND_EFFECT_COUNT) return 0;
+    uint32_t ms = 0;
+    for (uint8_t i = 0; i < SOUND_EFFECTS[e].count; i++) ms += SOUND_EFFECTS[e].notes[i].ms;
+    return ms;
+  }
+};
+
+#endif
@@ -13,9 +13,34 @@
 #include "EnicMotor.h"
 #include "EnicFace.h"
 #include "EnicSense.h"
-#include "EnicBomb.h"
-
-enum AppState { IDLE, MANUAL, MANUAL_OBSTACLE, AUTO, AVOIDING, DANCE, BOMB };
+#include "EnicTimeline.h"
+#include "EnicShows.h"
+#include "EnicProfile.h"
+#include "EnicCommand.h"
+#include "EnicPose.h"
+#include "EnicOccupancy.h"
+#include "EnicGovernor.h"
+#include "EnicRecorder.h"
+#include "EnicScheduler.h"
+#include "EnicPower.h"
+#include "EnicParams.h"
+#include "EnicBoot.h"
+#include "EnicMem.h"
+
+enum AppState : uint8_t { IDLE, MANUAL, MANUAL_OBSTACLE, AUTO, AVOIDING, DANCE, BOMB, STATE_COUNT };
+
+// FSM olayları: komutlar + tick içinde algılanan koşullar
+enum AppEvent : uint8_t {
+  EV_STOP,       // dur, ifade komutları
+  EV_AUTO,       // otonom / gez
+  EV_DANCE,      // dans
+  EV_BOMB,       // bomb
+  EV_MANUAL,     // ileri / geri / sol / sag
+  EV_OBSTACLE,   // mesafe eşiğin altına indi
+  EV_CLEAR,      // engel kalktı
+  EV_DONE,       // durumun kendi akışı bitti (kaçış manevrası, gösteri)
+  EVENT_COUNT
+};
 
 class EnicStateMachine {
 private:
@@ -23,239 +48,629 @@ private:
   EnicFace*  face;
   EnicSense* sense;
 
-  EnicBomb bomb;
+  // DANCE / BOMB: veri olarak gösteri (EnicShows.h)
+  EnicTimeline show;
 
   AppState currentState = IDLE;
-  unsigned long now = 0;
+  uint32_t now = 0;
+
+  // Süreli işler tek zamanlayıcıda; callback'siz olanlar sadece vade (pending() ile sorulur)
+  EnicScheduler sched;
+  EnicScheduler::Id tmAutoMove, tmAvoid, tmManual, tmFaceOverride;
 
   // AUTO pattern
-  unsigned long timerAutoMove = 0;
   bool isAutoMoving = false;
+  int autoSpeedFixed = 130;          // governor kapalıyken
+  int manualSpeed = 200, turnSpeed = 180;   // ileri/geri, sol/sag hız verilmezse
 
-  // DANCE
-  unsigned long timerDance = 0;
-  int danceFrame = 0;
+  // İleri sürüş hız tavanı (AUTO + MANUAL): mesafe / TTC ile
+  EnicGovernor gov;
 
   // AVOID
-  enum AvoidPhase { AV_START, AV_BACK, AV_TURN, AV_DONE };
+  enum AvoidPhase { AV_START, AV_BACK, AV_TURN, AV_SCAN, AV_DONE, AV_SETTLE };
   AvoidPhase avoidPhase = AV_START;
-  unsigned long avoidUntil = 0;
   int avoidTurnDir = 1;
+  float avoidLeft = 0.0f;           // planlı dönüşte kalan açı (rad, avoidTurnDir yönünde)
+  float scanSwept = 0.0f;           // etrafa bakış: dönülen toplam açı
+  float avoidLastTheta = 0.0f;
+  bool avoidPlanner = true;         // false: eski rastgele yön / süre
+
+  // Uçuş kaydı (nullptr: kapalı); motor hedefi sadece anlamlı değişimde yazılır
+  EnicRecorder* rec = nullptr;
+  EnicPower* power = nullptr;       // IDLE güç modunda motor tick'i park edilir
+  EnicParams* params = nullptr;     // get/set/dump; nullptr: derlenmiş varsayılanlar
+  const EnicBoot* boot = nullptr;   // boot komutu: açılış fazları
+  int loggedLeft = 0, loggedRight = 0;
+  static const int LOG_MOTOR_STEP = 8;
+
+  // Yerel harita: dead-reckoning pozu + sonar doluluk ızgarası
+  EnicPose pose;
+  EnicOccupancy occ;
+  uint32_t lastSample = 0;
 
   // thresholds
-  const float AUTO_OBS_ENTER = 20.0f;
-  const float AUTO_OBS_EXIT  = 28.0f;
-  const float AVOID_EARLY_CLEAR = 35.0f;
-
-  const float MANUAL_OBS_LIMIT = 15.0f;
-  const float MANUAL_CLEAR_LIMIT = 25.0f;
+  NavTuning nav;
 
   bool autoObstacleLatched = false;
 
+  // MANUAL: süreli komut (ileri 150 800) tmManual ile biter; istenen hız governor'dan her tick geçer
+  int manualLeft = 0, manualRight = 0;
+
   // Face override for commands
   bool faceOverrideActive = false;
   FaceType faceOverrideType = NORMAL;
-  unsigned long faceOverrideUntil = 0;
 
-  void setFaceOverride(FaceType t, unsigned long ms, int soundType = 0) {
+  // ---------------- Tablo tipleri ----------------
+  typedef void (EnicStateMachine::*Action)();
+  typedef void (EnicStateMachine::*Tick)(float dist);
+  typedef bool (EnicStateMachine::*Guard)() const;
+
+  struct StateDesc {
+    AppState id;
+    Action enter;   // nullptr: yok
+    Action exit;    // nullptr: yok
+    Tick   tick;
+  };
+
+  struct Transition {
+    AppState from;  // ANY_STATE: her durumdan
+    AppEvent event;
+    AppState to;
+    Guard    guard; // nullptr: koşulsuz
+  };
+
+  // (durum, olay) -> TRANSITIONS indeksi; derleme zamanında kurulur
+  struct RouteTable {
+    int8_t at[STATE_COUNT][EVENT_COUNT];
+  };
+
+  static const AppState ANY_STATE = STATE_COUNT;
+
+  static const StateDesc STATES[STATE_COUNT];
+  static const Transition TRANSITIONS[];
+  static const int TRANSITION_COUNT;
+  static const RouteTable ROUTES;
+
+  static constexpr RouteTable buildRoutes(const Transition* tr, int n);
+  static constexpr bool statesInOrder(const StateDesc* st);
+
+  void setFaceOverride(FaceType t, uint32_t ms, int soundType = 0) {
     faceOverrideActive = true;
     faceOverrideType = t;
-    faceOverrideUntil = millis() + ms;
+    sched.startOnce(tmFaceOverride, ms);
     face->draw(t);
     if (soundType > 0) sense->playEffect(soundType);
   }
 
-  void enterState(AppState st) {
-    if (st == IDLE) {
-      motor->drive(0, 0);
-    }
-    else if (st == MANUAL) {
-      face->draw(NORMAL);
-    }
-    else if (st == MANUAL_OBSTACLE) {
-      motor->drive(0, 0);
-      face->draw(FEAR);
-      sense->playEffect(1);
-    }
-    else if (st == AUTO) {
-      face->draw(NORMAL);
-      sense->playEffect(2);
-      isAutoMoving = true;
-      timerAutoMove = millis() + random(2000, 5000);
-    }
-    else if (st == AVOIDING) {
-      avoidPhase = AV_START;
-      avoidUntil = millis();
-      avoidTurnDir = (random(0, 2) == 0) ? 1 : -1;
-    }
-    else if (st == DANCE) {
-      motor->drive(0, 0);
-      timerDance = millis();
-      danceFrame = 0;
-    }
-    else if (st == BOMB) {
-      motor->drive(0, 0);
-      bomb.start();
-    }
+  // ---------------- Zamanlayıcı callback'leri (update() içinde, tick'ten önce) ----------------
+  static void onFaceOverrideEnd(void* ctx) {
+    EnicStateMachine* self = (EnicStateMachine*)ctx;
+    self->faceOverrideActive = false;
+    if (self->currentState == IDLE) self->face->draw(NORMAL);
+  }
+
+  static void onManualTimeout(void* ctx) {
+    EnicStateMachine* self = (EnicStateMachine*)ctx;
+    if (self->currentState == MANUAL) self->fire(EV_STOP);
+  }
+
+  void trace(LogType type, uint8_t a, long v0 = 0, long v1 = 0, long v2 = 0) {
+    if (rec) rec->record(type, a, v0, v1, v2);
+  }
+
+  void traceMotor() {
+    int l = motor->getTargetLeft(), r = motor->getTargetRight();
+    bool stopChanged = (l == 0) != (loggedLeft == 0) || (r == 0) != (loggedRight == 0);
+    if (!stopChanged && abs(l - loggedLeft) < LOG_MOTOR_STEP && abs(r - loggedRight) < LOG_MOTOR_STEP) return;
+    loggedLeft = l;
+    loggedRight = r;
+    trace(LOG_MOTOR, gov.inEmergencyStop() ? 1 : 0, l, r, gov.getStats().lastCap);
   }
 
   void changeState(AppState st) {
     if (st == currentState) return;
+    trace(LOG_STATE, st, currentState);
+    const StateDesc& from = STATES[currentState];
+    if (from.exit) (this->*from.exit)();
     currentState = st;
-    enterState(st);
+    const StateDesc& to = STATES[st];
+    if (to.enter) (this->*to.enter)();
+  }
+
+  // Olayı mevcut durumun rotasına göre işle; geçiş olduysa true
+  bool fire(AppEvent ev) {
+    int8_t i = ROUTES.at[currentState][ev];
+    if (i < 0) return false;
+    const Transition& t = TRANSITIONS[i];
+    if (t.guard && !(this->*t.guard)()) return false;
+    changeState(t.to);
+    return true;
+  }
+
+  // ---------------- Guards ----------------
+  bool obstacleNotLatched() const { return !autoObstacleLatched; }
+
+  // ---------------- Entry / exit ----------------
+  void enterIdle() {
+    motor->drive(0, 0);
+  }
+
+  void enterManual() {
+    face->draw(NORMAL);
+  }
+
+  // Argümansız: varsayılan hız, süresiz. Hız 0..255, süre 0 = süresiz.
+  void manualCommand(const ParsedCommand& cmd, int defSpeed, int dirL, int dirR) {
+    int speed = cmd.argc > 0 ? (int)constrain(cmd.argv[0], 0L, 255L) : defSpeed;
+    long ms   = cmd.argc > 1 ? constrain(cmd.argv[1], 0L, 60000L) : 0L;
+    driveManual(dirL * speed, dirR * speed, (uint32_t)ms);
+  }
+
+  // Kısayol komutları (ping, gov, pwr) depoya yazar ki kalıcı olsun; depo yoksa false
+  bool tune(const char* name, float v) {
+    if (!params || !params->set(name, v, nowMs32())) return false;
+    applyParams();
+    return true;
   }
 
-  void startAvoiding() {
+  void enterManualObstacle() {
+    motor->drive(0, 0);
+    face->draw(FEAR);
+    sense->playEffect(1);
+  }
+
+  void enterAuto() {
+    face->draw(NORMAL);
+    sense->playEffect(2);
+    isAutoMoving = true;
+    sched.startOnce(tmAutoMove, random(2000, 5000));
+  }
+
+  void enterAvoiding() {
     autoObstacleLatched = true;
-    changeState(AVOIDING);
+    avoidPhase = AV_START;
+    sched.cancel(tmAvoid);
+    avoidTurnDir = (random(0, 2) == 0) ? 1 : -1;
+  }
+
+  void exitAvoiding() {
+    motor->drive(0, 0); // yarım kalan geri/dönüş manevrası sürmesin
+  }
+
+  void enterDance() { show.start(&SHOW_DANCE, nowMs32()); }
+  void enterBomb()  { show.start(&SHOW_BOMB, nowMs32()); }
+
+  void exitShow() {
+    show.stop();
+    motor->drive(0, 0); // dans adımı sürmesin
+  }
+
+  void turnInPlace(int dir) {
+    motor->drive(-dir * nav.avoidDuty, dir * nav.avoidDuty);
+  }
+
+  // ---------------- Ticks ----------------
+  void tickIdle(float) {
+    if (!faceOverrideActive) face->updateIdle();   // override bitişi: onFaceOverrideEnd
+  }
+
+  void tickManual(float dist) {
+    if (dist < nav.manualObsLimit) { fire(EV_OBSTACLE); return; }
+    gov.drive(motor, manualLeft, manualRight, sense->getRange());
+  }
+
+  void tickManualObstacle(float dist) {
+    motor->drive(0, 0);
+    if (dist > nav.manualClearLimit) fire(EV_CLEAR);
+  }
+
+  void tickAuto(float dist) {
+    if (dist < nav.autoObsEnter && fire(EV_OBSTACLE)) return;
+    if (autoObstacleLatched && dist > nav.autoObsExit) autoObstacleLatched = false;
+
+    if (!sched.pending(tmAutoMove)) {
+      isAutoMoving = !isAutoMoving;
+      if (isAutoMoving) sched.startOnce(tmAutoMove, random(2500, 6500));
+      else { sched.startOnce(tmAutoMove, random(1500, 4500)); motor->drive(0, 0); }
+    }
+
+    if (isAutoMoving) {
+      int v = gov.enabled() ? gov.cruise() : autoSpeedFixed;
+      gov.drive(motor, v, v, sense->getRange());
+      // Acil durdurma mandaldan bağımsız kaçışa geçer (yoksa engel önünde beklerdi)
+      if (gov.inEmergencyStop()) {
+        autoObstacleLatched = false;
+        fire(EV_OBSTACLE);
+        return;
+      }
+    }
+    else face->updateIdle();
   }
 
-  void updateAvoiding(float dist) {
-    bool canEarlyFinish = (dist >= AVOID_EARLY_CLEAR);
+  void tickAvoiding(float dist) {
+    bool canEarlyFinish = (dist >= nav.avoidEarlyClear);
 
     switch (avoidPhase) {
       case AV_START:
         motor->drive(0, 0);
         face->draw(SHOCK);
         sense->playEffect(1);
-        avoidUntil = now + 250;
+        sched.startOnce(tmAvoid, nav.avoidPauseMs);
         avoidPhase = AV_BACK;
         break;
 
       case AV_BACK:
-        if (now < avoidUntil) return;
+        if (sched.pending(tmAvoid)) return;
         face->draw(SNEAKY);
-        motor->drive(-180, -180);
-        avoidUntil = now + (canEarlyFinish ? 220UL : 480UL);
+        motor->drive(-nav.avoidDuty, -nav.avoidDuty);
+        sched.startOnce(tmAvoid, canEarlyFinish ? nav.avoidBackShortMs : nav.avoidBackMs);
         avoidPhase = AV_TURN;
         break;
 
       case AV_TURN:
-        if (now < avoidUntil) return;
-        if (avoidTurnDir > 0) motor->drive(-180, 180);
-        else motor->drive(180, -180);
-        avoidUntil = now + (canEarlyFinish ? (unsigned long)random(180, 320)
-                                           : (unsigned long)random(420, 780));
+        if (sched.pending(tmAvoid)) return;
+        if (avoidPlanner) {
+          // Önce yerinde bir tur: tek ileri bakan sonar çevreyi haritaya yazsın
+          scanSwept = 0.0f;
+          avoidLastTheta = pose.get().theta;
+          sched.startOnce(tmAvoid, nav.avoidScanMaxMs);
+          avoidPhase = AV_SCAN;
+        } else {
+          sched.startOnce(tmAvoid, canEarlyFinish ? random(nav.avoidTurnShortMinMs, nav.avoidTurnShortMaxMs)
+                                                  : random(nav.avoidTurnMinMs, nav.avoidTurnMaxMs));
+          avoidPhase = AV_DONE;
+        }
+        turnInPlace(avoidTurnDir);
+        break;
+
+      case AV_SCAN: {
+        scanSwept += fabsf(wrapAngle(pose.get().theta - avoidLastTheta));
+        avoidLastTheta = pose.get().theta;
+        if (scanSwept < 2.0f * (float)M_PI - nav.avoidTurnLead && sched.pending(tmAvoid)) return;
+
+        // Haritadan en açık yön; süre yerine poz ile dön, süre sadece emniyet sınırı
+        float off = occ.planTurn(pose.get());
+        avoidTurnDir = off > 0.0f ? 1 : -1;
+        avoidLeft = fabsf(off);
+        sched.startOnce(tmAvoid, (uint32_t)(fabsf(off) * 400.0f) + 500UL);
+        turnInPlace(avoidTurnDir);
         avoidPhase = AV_DONE;
         break;
+      }
 
       case AV_DONE:
-        if (now < avoidUntil) return;
-        motor->drive(0, 0);
-        changeState(AUTO);
+        if (avoidPlanner) {
+          // Kalan açı adım adım (180'e yakın hedefte sarma farkı yanıltmasın); rampa payı kadar
+          // erken bırak, tekerler durunca AUTO'ya dön (yoksa dönüş ileri sürüşe taşar)
+          avoidLeft -= wrapAngle(pose.get().theta - avoidLastTheta) * avoidTurnDir;
+          avoidLastTheta = pose.get().theta;
+          bool reached = avoidLeft <= nav.avoidTurnLead;
+          if (!reached && sched.pending(tmAvoid)) return;
+          motor->drive(0, 0);
+          sched.startOnce(tmAvoid, nav.avoidSettleMs);
+          avoidPhase = AV_SETTLE;
+          return;
+        }
+        if (sched.pending(tmAvoid)) return;
+        fire(EV_DONE);
+        break;
+
+      case AV_SETTLE:
+        if ((motor->getCurrentLeft() != 0 || motor->getCurrentRight() != 0) && sched.pending(tmAvoid)) return;
+        // Boş yöne dönüldü: yakın okuma artık yeni engel, mandal onu yutmasın
+        autoObstacleLatched = false;
+        fire(EV_DONE);
         break;
     }
   }
 
+  // DANCE / BOMB: sahne, ses ve motor anahtarları tek saatten; döngüsüz gösteri bitince EV_DONE
+  void tickShow(float) {
+    bool stillPlaying;
+    { ENIC_PROFILE_SCOPE(PROF_SHOW); stillPlaying = show.update(now); }
+    if (!stillPlaying) fire(EV_DONE);
+  }
+
 public:
   EnicStateMachine(EnicMotor* m, EnicFace* f, EnicSense* s)
-    : motor(m), face(f), sense(s) {}
+    : motor(m), face(f), sense(s) {
+    tmAutoMove     = sched.add("auto_move");
+    tmAvoid        = sched.add("avoid_phase");
+    tmManual       = sched.add("manual_stop", &EnicStateMachine::onManualTimeout, this);
+    tmFaceOverride = sched.add("face_override", &EnicStateMachine::onFaceOverrideEnd, this);
+  }
 
   void begin() {
-    bomb.begin(motor, face, sense);
+    sched.begin(nowMs32());
+    show.begin(motor, face, sense);
     changeState(IDLE);
   }
 
-  void handleCommand(String cmd) {
-    cmd.trim();
-    cmd.toLowerCase();
+  AppState getState() const { return currentState; }
+  const EnicTimeline& getShow() const { return show; }
+  const Pose& getPose() const { return pose.get(); }
+  const EnicOccupancy& getOccupancy() const { return occ; }
 
-    if (cmd == "dur")   { changeState(IDLE); return; }
-    if (cmd == "otonom" || cmd == "gez") { changeState(AUTO); return; }
-    if (cmd == "dans")  { changeState(DANCE); return; }
+  // Kaçış yönü: true -> haritadan planla, false -> rastgele (karşılaştırma için)
+  void setAvoidPlanner(bool on) { avoidPlanner = on; }
 
-    // NEW: bomb mode
-    if (cmd == "bomb")  { changeState(BOMB); return; }
+  EnicGovernor& getGovernor() { return gov; }
+  const EnicScheduler& getScheduler() const { return sched; }
 
-    // expression commands
-    if (cmd == "konus") { setFaceOverride(SPEAK, 1200, 3); changeState(IDLE); return; }
-    if (cmd == "dinle") { setFaceOverride(LISTEN, 1400, 3); changeState(IDLE); return; }
-    if (cmd == "sasir") { setFaceOverride(SHOCK, 1000, 1);  changeState(IDLE); return; }
-    if (cmd == "kork")  { setFaceOverride(FEAR, 1300, 1);   changeState(IDLE); return; }
-    if (cmd == "agla")  { setFaceOverride(CRY, 1600, 5);    changeState(IDLE); return; }
-    if (cmd == "dil")   { setFaceOverride(TONGUE, 1400, 3); changeState(IDLE); return; }
+  // Eşikler ve kaçış süreleri; bir sonraki tick'ten itibaren geçerli
+  const NavTuning& getNavTuning() const { return nav; }
+  void setNavTuning(const NavTuning& t) { nav = t; }
 
-    // manual motion
-    if (cmd == "ileri") { changeState(MANUAL); motor->drive(200, 200); return; }
-    if (cmd == "geri")  { changeState(MANUAL); motor->drive(-200,-200); return; }
-    if (cmd == "sol")   { changeState(MANUAL); motor->drive(-180,180); return; }
-    if (cmd == "sag")   { changeState(MANUAL); motor->drive(180,-180); return; }
+  // Durum geçişleri, komutlar, mesafe örnekleri ve motor hedefleri kaydedilir
+  void setRecorder(EnicRecorder* r) { rec = r; }
+  EnicRecorder* getRecorder() const { return rec; }
+
+  // pwr komutu + motor park; nullptr: hep tam hız
+  void setPower(EnicPower* p) { power = p; }
+
+  // Parametre deposu: bağlanınca değerler hemen uygulanır (NVS'ten yüklenmiş olabilir)
+  void setParams(EnicParams* p) {
+    params = p;
+    if (params) applyParams();
+  }
+  EnicParams* getParams() const { return params; }
+
+  // Açılış fazı damgaları (boot komutu raporu tekrar basar)
+  void setBoot(const EnicBoot* b) { boot = b; }
+
+  // Önbellek kopyalarını depodan güncelle: FSM eşikleri ve hızlar, governor, motor limitleri,
+  // sense (kuyruk üzerinden), güç. Sıcak yol sadece bu kopyaları okur.
+  void applyParams() {
+    const EnicConfig& c = params->get();
+    nav = c.nav;
+    for (int i = 0; i < GOV_PARAM_COUNT; i++) gov.set((uint8_t)i, c.gov[i]);
+    autoSpeedFixed = c.autoSpeed;
+    manualSpeed = c.manualSpeed;
+    turnSpeed = c.turnSpeed;
+    motor->setLimits(c.motorAccel, c.motorJerk);
+    sense->setPingInterval(c.pingMs);
+    sense->setFilter(c.filterAlpha, c.filterBeta, c.filterGateCm);
+    if (power) power->setEnabled(c.powerSave != 0);
   }
 
-  void update() {
-    now = millis();
+  // Ping aralığı (ping komutu ve ikili OP_PING): depodan geçer -> kırpılır, kalıcı, applyParams ile tutarlı.
+  // Depo yoksa aynı sınırlarla doğrudan sense'e.
+  void setPingInterval(unsigned long ms) {
+    if (tune("sense.ping_ms", (float)ms)) return;
+    const ParamDef* d = EnicParams::find("sense.ping_ms");
+    sense->setPingInterval((unsigned long)constrain((float)ms, d->lo, d->hi));
+  }
 
-    sense->update();
-    motor->update();
+  // ACTIVE gerektiren iş: IDLE dışı durum veya dönen teker
+  bool isBusy() const {
+    return currentState != IDLE || motor->getCurrentLeft() != 0 || motor->getCurrentRight() != 0;
+  }
 
-    float dist = sense->getDistance();
+  // IDLE'da bir sonraki işe (zamanlayıcı vadesi, yüz animasyonu) kalan süre, en fazla limit
+  uint32_t msUntilNextEvent(uint32_t limit) const {
+    uint32_t t = sched.nextDueIn(limit);
+    if (currentState == IDLE && !faceOverrideActive) t = min(t, face->msUntilIdleEvent());
+    return t;
+  }
 
-    // BOMB mode: ekran animasyonu 30s
-    if (currentState == BOMB) {
-      motor->drive(0, 0);
-      bool stillPlaying = bomb.update();
-      if (!stillPlaying) {
-        changeState(IDLE);
-      }
-      return;
-    }
+  // ---------------- Doğrudan girişler (metin + binary protokol ortak yolu) ----------------
+  // Mod olayları: EV_STOP / EV_AUTO / EV_DANCE / EV_BOMB
+  bool requestMode(AppEvent ev) { return fire(ev); }
 
-    // DANCE
-    if (currentState == DANCE) {
-      if (now - timerDance > 250) {
-        timerDance = now;
-        sense->playEffect(4);
-        face->drawDance(danceFrame++);
-        if (danceFrame > 3) danceFrame = 0;
-      }
-      return;
-    }
+  // MANUAL'e geç ve sür; ms > 0 ise süre dolunca IDLE
+  void driveManual(int left, int right, uint32_t ms) {
+    fire(EV_MANUAL);
+    if (currentState != MANUAL) return;
 
-    switch (currentState) {
-      case AUTO: {
-        if (!autoObstacleLatched) {
-          if (dist < AUTO_OBS_ENTER) { startAvoiding(); break; }
-        } else {
-          if (dist > AUTO_OBS_EXIT) autoObstacleLatched = false;
-        }
+    if (ms > 0) sched.startOnce(tmManual, ms);
+    else sched.cancel(tmManual);
+    manualLeft = left;
+    manualRight = right;
+    gov.drive(motor, left, right, sense->getRange());
+  }
+
+  // İfade göster (+ isteğe bağlı ses), IDLE'a dön
+  void showFace(FaceType t, uint32_t ms, int soundType) {
+    setFaceOverride(t, ms, soundType);
+    fire(EV_STOP);
+  }
 
-        if (now > timerAutoMove) {
-          isAutoMoving = !isAutoMoving;
-          if (isAutoMoving) timerAutoMove = now + (unsigned long)random(2500, 6500);
-          else { timerAutoMove = now + (unsigned long)random(1500, 4500); motor->drive(0, 0); }
+  // Durum/geçiş tablolarının derleme zamanı doğrulaması (aşağıdaki static_assert)
+  static constexpr bool tablesValid();
+
+  // Satır yerinde bölünür (heap yok). Bilinmeyen komut / hatalı argüman sessizce yok sayılır.
+  void handleCommand(char* line) {
+    ParsedCommand cmd;
+    if (!parseCommand(line, cmd)) return;
+    trace(LOG_CMD, cmd.id, cmd.argc > 0 ? cmd.argv[0] : 0, cmd.argc > 1 ? cmd.argv[1] : 0,
+          cmd.argc > 2 ? cmd.argv[2] : 0);
+
+    switch (cmd.id) {
+      case CMD_DUR:    requestMode(EV_STOP); return;
+      case CMD_OTONOM:
+      case CMD_GEZ:    requestMode(EV_AUTO); return;
+      case CMD_DANS:   requestMode(EV_DANCE); return;
+      case CMD_BOMB:   requestMode(EV_BOMB); return;
+
+      // expression commands
+      case CMD_KONUS:  showFace(SPEAK, 1200, 3); return;
+      case CMD_DINLE:  showFace(LISTEN, 1400, 3); return;
+      case CMD_SASIR:  showFace(SHOCK, 1000, 1); return;
+      case CMD_KORK:   showFace(FEAR, 1300, 1); return;
+      case CMD_AGLA:   showFace(CRY, 1600, 5); return;
+      case CMD_DIL:    showFace(TONGUE, 1400, 3); return;
+
+      // manual motion: [hız] [süre ms]
+      case CMD_ILERI:  manualCommand(cmd, manualSpeed, 1, 1);  return;
+      case CMD_GERI:   manualCommand(cmd, manualSpeed, -1, -1); return;
+      case CMD_SOL:    manualCommand(cmd, turnSpeed, -1, 1);    return;
+      case CMD_SAG:    manualCommand(cmd, turnSpeed, 1, -1);    return;
+
+      case CMD_PING:
+        if (cmd.argv[0] <= 0) return;
+        setPingInterval((unsigned long)cmd.argv[0]);
+        return;
+
+      // gov: parametreler + sayaçlar; gov <no> <değer>: store üzerinden ayarla (set gov.<ad> ile aynı yol)
+      case CMD_GOV:
+        if (cmd.argc == 1) { Serial.println("gov: usage: gov | gov <no> <value>"); return; }
+        if (cmd.argc == 2) {
+          if (cmd.argv[0] < 0 || cmd.argv[0] >= GOV_PARAM_COUNT) {
+            enicPrintf(Serial, "gov: bad index %ld (0..%d)\n", (long)cmd.argv[0], GOV_PARAM_COUNT - 1);
+            return;
+          }
+          char name[24];
+          snprintf(name, sizeof(name), "gov.%s", GOV_PARAMS[cmd.argv[0]].name);
+          if (!tune(name, cmd.argv[1])) Serial.println("gov: no param store");
+          return;
         }
+        gov.printStats(Serial);
+        gov.resetStats();
+        return;
+
+      // diagnostics
+      case CMD_OLED:   face->printFlushStats(Serial); face->resetFlushStats(); return;
+      case CMD_STATS:  ENIC_PROFILE_DUMP(Serial); return;
+      case CMD_QUEUES: EnicQueueRegistry::print(Serial); EnicQueueRegistry::resetAll(); return;
+      case CMD_SCHED:  sched.printStats(Serial); sched.resetStats(); return;
+
+      // pwr: mod süreleri, görev oranı, akım tahmini; pwr 0/1: yöneticiyi kapat / aç
+      case CMD_PWR:
+        if (!power) return;
+        if (cmd.argc == 1) {
+          if (!tune("power.enable", cmd.argv[0] != 0)) power->setEnabled(cmd.argv[0] != 0);
+          return;
+        }
+        power->printStats(Serial);
+        power->resetStats();
+        return;
+
+      // parametreler: get [ad|önek], set <ad> <değer> | {json} | defaults, dump
+      case CMD_GET:    if (params) params->printGet(Serial, cmd.text); return;
+      case CMD_SET:    if (params && params->handleSet(Serial, cmd.text, nowMs32())) applyParams(); return;
+      case CMD_DUMP:   if (params) params->printDump(Serial); return;
+      case CMD_BOOT:   if (boot) boot->printReport(Serial); return;
+      case CMD_MEM:    EnicMem::print(Serial); return;
+
+      // log: sayaçlar; log 1: dökümü log task'ı MSG_LOG çerçeveleriyle yollar; log 2: sil
+      case CMD_LOG:
+        if (!rec) return;
+        if (cmd.argc == 0) rec->printStats(Serial);
+        else if (cmd.argv[0] == 1) rec->requestDump();
+        else if (cmd.argv[0] == 2) rec->requestErase();
+        return;
+
+      default: return;
+    }
+  }
 
-        if (isAutoMoving) motor->drive(130, 130);
-        else face->updateIdle();
-        break;
-      }
+  // Sabit metin için kolaylık (bench / host scriptleri); yığında kopyalanır
+  void handleCommand(const char* text) {
+    char buf[CMD_LINE_MAX + 1];
+    strncpy(buf, text, CMD_LINE_MAX);
+    buf[CMD_LINE_MAX] = '\0';
+    handleCommand(buf);
+  }
 
-      case AVOIDING:
-        updateAvoiding(dist);
-        break;
+  void update() {
+    ENIC_PROFILE_SCOPE(PROF_FSM);
+    now = nowMs32();
+    sched.advance(now);   // vadesi gelen callback'ler; tick'ler pending() ile sorar
+
+    sense->receive();   // sense task'ının son örnekleri
+    pose.update(*motor, now);
+
+    // Yeni ping -> haritaya, filtresiz (dönerken medyan yönleri karıştırır); echo yoksa ışın boş
+    if (sense->getSampleCount() != lastSample) {
+      lastSample = sense->getSampleCount();
+      float raw = sense->getRawDistance();
+      occ.integrate(pose.get(), raw, raw < SONAR_NO_ECHO);
+
+      const RangeEstimate& r = sense->getRange();
+      bool echo = raw < SONAR_NO_ECHO;
+      trace(LOG_RANGE, (r.valid ? 1 : 0) | (echo ? 2 : 0), r.valid ? lroundf(r.distCm * 10.0f) : -1L,
+            lroundf(r.closingCmS * 10.0f), echo ? lroundf(raw * 10.0f) : -1L);
+    }
+    { ENIC_PROFILE_SCOPE(PROF_MOTOR); motor->update(); }
 
-      case MANUAL:
-        if (dist < MANUAL_OBS_LIMIT) changeState(MANUAL_OBSTACLE);
-        break;
+    float dist = sense->getDistance();
 
-      case MANUAL_OBSTACLE:
-        motor->drive(0, 0);
-        if (dist > MANUAL_CLEAR_LIMIT) changeState(IDLE);
-        break;
+    // Durum sayısından bağımsız: tek tablo indeksi + tek çağrı
+    (this->*STATES[currentState].tick)(dist);
+    if (rec) traceMotor();
+    if (power && power->isIdle()) motor->park();
+  }
+};
 
-      case IDLE:
-      default:
-        if (faceOverrideActive) {
-          if (now >= faceOverrideUntil) {
-            faceOverrideActive = false;
-            face->draw(NORMAL);
-          }
-        } else {
-          face->updateIdle();
-        }
-        break;
+// ---------------- Durum tablosu (AppState sırasıyla) ----------------
+inline constexpr EnicStateMachine::StateDesc EnicStateMachine::STATES[STATE_COUNT] = {
+  { IDLE,            &EnicStateMachine::enterIdle,          nullptr,                         &EnicStateMachine::tickIdle },
+  { MANUAL,          &EnicStateMachine::enterManual,        nullptr,                         &EnicStateMachine::tickManual },
+  { MANUAL_OBSTACLE, &EnicStateMachine::enterManualObstacle, nullptr,                        &EnicStateMachine::tickManualObstacle },
+  { AUTO,            &EnicStateMachine::enterAuto,          nullptr,                         &EnicStateMachine::tickAuto },
+  { AVOIDING,        &EnicStateMachine::enterAvoiding,      &EnicStateMachine::exitAvoiding, &EnicStateMachine::tickAvoiding },
+  { DANCE,           &EnicStateMachine::enterDance,         &EnicStateMachine::exitShow,     &EnicStateMachine::tickShow },
+  { BOMB,            &EnicStateMachine::enterBomb,          &EnicStateMachine::exitShow,     &EnicStateMachine::tickShow },
+};
+
+// ---------------- Geçiş tablosu ----------------
+// Aynı (durum, olay) için özel satır ANY_STATE satırını ezer.
+inline constexpr EnicStateMachine::Transition EnicStateMachine::TRANSITIONS[] = {
+  // komutlar: her durumdan
+  { ANY_STATE,       EV_STOP,     IDLE,            nullptr },
+  { ANY_STATE,       EV_AUTO,     AUTO,            nullptr },
+  { ANY_STATE,       EV_DANCE,    DANCE,           nullptr },
+  { ANY_STATE,       EV_BOMB,     BOMB,            nullptr },
+  { ANY_STATE,       EV_MANUAL,   MANUAL,          nullptr },
+
+  // sensör / akış olayları
+  { AUTO,            EV_OBSTACLE, AVOIDING,        &EnicStateMachine::obstacleNotLatched },
+  { AVOIDING,        EV_DONE,     AUTO,            nullptr },
+  { MANUAL,          EV_OBSTACLE, MANUAL_OBSTACLE, nullptr },
+  { MANUAL_OBSTACLE, EV_CLEAR,    IDLE,            nullptr },
+  { BOMB,            EV_DONE,     IDLE,            nullptr },
+};
+
+inline constexpr int EnicStateMachine::TRANSITION_COUNT =
+  (int)(sizeof(EnicStateMachine::TRANSITIONS) / sizeof(EnicStateMachine::TRANSITIONS[0]));
+
+constexpr EnicStateMachine::RouteTable EnicStateMachine::buildRoutes(const Transition* tr, int n) {
+  RouteTable r = {};
+  for (int s = 0; s < STATE_COUNT; s++)
+    for (int e = 0; e < EVENT_COUNT; e++) r.at[s][e] = -1;
+
+  // önce joker satırlar, sonra özel satırlar (üzerine yazar)
+  for (int pass = 0; pass < 2; pass++) {
+    for (int i = 0; i < n; i++) {
+      bool any = (tr[i].from == ANY_STATE);
+      if (any != (pass == 0)) continue;
+      for (int s = 0; s < STATE_COUNT; s++) {
+        if (any || tr[i].from == s) r.at[s][tr[i].event] = (int8_t)i;
+      }
     }
   }
-};
+  return r;
+}
+
+constexpr bool EnicStateMachine::statesInOrder(const StateDesc* st) {
+  for (int i = 0; i < STATE_COUNT; i++) {
+    if (st[i].id != i || st[i].tick == nullptr) return false;
+  }
+  return true;
+}
+
+inline constexpr EnicStateMachine::RouteTable EnicStateMachine::ROUTES =
+  EnicStateMachine::buildRoutes(EnicStateMachine::TRANSITIONS, EnicStateMachine::TRANSITION_COUNT);
+
+constexpr bool EnicStateMachine::tablesValid() {
+  if (!statesInOrder(STATES)) return false;
+  for (int i = 0; i < TRANSITION_COUNT; i++) {
+    if (TRANSITIONS[i].to >= STATE_COUNT || TRANSITIONS[i].event >= EVENT_COUNT) return false;
+  }
+  return TRANSITION_COUNT < 127; // RouteTable int8_t indeks
+}
+
+static_assert(EnicStateMachine::tablesValid(),
+              "STATES must list every AppState in enum order with a tick handler");
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,310 @@
+/**
+ * @file EnicTasks.h
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Dual-core task layout: sense + control on core 1, render + serial IO on core 0
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ *
+ * Task'lar arasında paylaşılan durum yok; sadece EnicQueue (SPSC, beklemesiz) kuyrukları:
+ *   sense   -> kontrol : sense.samples      kontrol -> sense  : sense.requests
+ *   kontrol -> io      : face.draw, link.status
+ *   io      -> kontrol : link.cmd
+ *   kontrol -> log     : log.ring (EnicRecorder; flash yazımı ve döküm log task'ında)
+ *   kontrol -> log     : EnicParams kalıcı kopyası (seqlock; NVS yazımı log task'ında)
+ * Kontrol task'ı hiçbir kuyrukta beklemez: yavaş bir OLED karesi sadece face.draw'ı doldurur.
+ * IDLE güç modunda (EnicPower) task'lar sabit periyot yerine bir sonraki işe kadar uyur;
+ * UART RX, bekleyen çizim ve mod değişimi task bildirimiyle uyandırır.
+ * Açılış (EnicBoot): beginDisplay() io task'ını setup'ın geri kalanından önce başlatır, panel
+ * init'i core 0'da paralel gider; LittleFS bağlama log task'ının ilk işi.
+ * Host build'de task yok: stepAll() adımları sırayla çalıştırır, stepDue() cihazdaki
+ * periyot / uyku kuralıyla (güç bench'i).
+ */
+#ifndef ENIC_TASKS_H
+#define ENIC_TASKS_H
+
+#include <Arduino.h>
+#include "EnicState.h"
+#include "EnicFace.h"
+#include "EnicSense.h"
+#include "EnicSerialLink.h"
+#include "EnicProfile.h"
+#include "EnicRecorder.h"
+#include "EnicPower.h"
+#include "EnicParams.h"
+#include "EnicBoot.h"
+#include "EnicMem.h"
+#include "EnicTime.h"
+
+#if defined(ARDUINO_ARCH_ESP32)
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#endif
+
+struct EnicTaskConfig {
+  const char* name;
+  uint8_t core;
+  uint8_t prio;
+  uint8_t periodMs;
+  uint32_t stack;
+};
+
+// OLED flush task'ı (EnicDisplayLink) core 0 / prio 2'de; io onunla paylaşır.
+// Yığınlar EnicTasks içinde statik (stack bayt); 'mem' en düşük boş kısmı gösterir.
+static constexpr EnicTaskConfig TASK_SENSE   = { "enic_sense",   1, 3, 2, 3072 };
+static constexpr EnicTaskConfig TASK_CONTROL = { "enic_control", 1, 4, 5, 4096 };
+static constexpr EnicTaskConfig TASK_IO      = { "enic_io",      0, 2, 5, 4096 };
+static constexpr EnicTaskConfig TASK_LOG     = { "enic_log",     0, 1, 50, 4096 };
+
+enum EnicTaskIndex : uint8_t { TI_SENSE, TI_CONTROL, TI_IO, TI_LOG, TI_COUNT };
+
+// Kontrol periyodu bunun (x periodMs) üstüne çıkarsa uçuş kaydına LOG_OVERRUN
+static const uint32_t CONTROL_OVERRUN_PCT = 150;
+
+class EnicTasks {
+private:
+  EnicStateMachine* brain;
+  EnicFace* face;
+  EnicSense* sense;
+  EnicSerialLink* serialLink;
+  EnicRecorder* recorder;
+  EnicPower* power = nullptr;
+  EnicParams* params = nullptr;
+  EnicBoot* boot = nullptr;
+
+  uint32_t lastControlUs = 0;
+  uint32_t overruns = 0;
+  bool controlPaced = true;   // bu turdan önceki bekleme sabit periyottu (IDLE uykusu değil)
+  uint32_t activations[TI_COUNT] = {};
+  bool displayStarted = false;
+
+  // Adım + güç muhasebesi (meşgul süre, uyanış sayısı)
+  void run(uint8_t i) {
+    uint32_t t0 = nowUs32();
+    switch (i) {
+      case TI_SENSE:   senseStep(); break;
+      case TI_CONTROL: controlStep(); break;
+      case TI_IO:      ioStep(); break;
+      default:         logStep(); break;
+    }
+    activations[i]++;
+    if (power) power->addBusy(nowUs32() - t0);
+  }
+
+  // Task'ın kendi çekirdeğinde, döngüden önce bir kez: yavaş init'ler setup'ı bekletmesin
+  void startup(uint8_t i) {
+    EnicMem::primeTask();
+    if (i == TI_IO) {
+      face->begin();                       // I2C + SSD1306 init + tek ilk kare
+      if (boot) boot->mark(BOOT_FIRST_FRAME);
+    } else if (i == TI_LOG) {
+      if (recorder && !recorder->mount()) Serial.println("LittleFS mount failed, flight log off");
+      if (boot) boot->mark(BOOT_LOG_READY);
+    }
+  }
+
+  // 0: ACTIVE, sabit periyot. >0: IDLE, bir sonraki işe kadar en fazla bu kadar uyu (bildirim erken uyandırır)
+  uint32_t idleWaitMs(uint8_t i) const {
+    if (!power || !power->isIdle()) return 0;
+    uint32_t ms;
+    switch (i) {
+      case TI_SENSE:   ms = POWER_SENSE_IDLE_MS; break;
+      case TI_CONTROL: ms = brain->msUntilNextEvent(POWER_IDLE_MAX_WAIT_MS); break;
+      case TI_IO:      ms = min(face->msUntilRender(), (uint32_t)POWER_IDLE_MAX_WAIT_MS); break;
+      default:         ms = POWER_LOG_IDLE_MS; break;
+    }
+    return ms ? ms : 1;
+  }
+
+  // Turdan sonra seçilen bekleme: kontrolün bir sonraki turu periyotla mı ölçülmeli
+  void noteWait(uint8_t i, uint32_t waitMs) {
+    if (i == TI_CONTROL) controlPaced = (waitMs == 0);
+  }
+
+#if defined(ARDUINO_ARCH_ESP32)
+  struct TaskArg {
+    EnicTasks* self;
+    uint8_t index;
+    uint8_t periodMs;
+  };
+
+  TaskArg args[TI_COUNT];
+  TaskHandle_t handles[TI_COUNT] = {};
+
+  // Heap'siz: TCB + yığın nesnenin içinde (xTaskCreateStaticPinnedToCore)
+  StaticTask_t tcbs[TI_COUNT];
+  StackType_t senseStack[TASK_SENSE.stack];
+  StackType_t controlStack[TASK_CONTROL.stack];
+  StackType_t ioStack[TASK_IO.stack];
+  StackType_t logStack[TASK_LOG.stack];
+  StackType_t* const stacks[TI_COUNT] = { senseStack, controlStack, ioStack, logStack };
+
+  // ACTIVE: sabit periyot, vTaskDelayUntil ile kayma birikmez. IDLE: bildirim veya olay zamanına kadar uyu
+  static void taskEntry(void* p) {
+    TaskArg* a = (TaskArg*)p;
+    a->self->startup(a->index);
+    TickType_t last = xTaskGetTickCount();
+    const TickType_t period = pdMS_TO_TICKS(a->periodMs) ? pdMS_TO_TICKS(a->periodMs) : 1;
+    for (;;) {
+      a->self->run(a->index);
+      uint32_t waitMs = a->self->idleWaitMs(a->index);
+      a->self->noteWait(a->index, waitMs);
+      if (!waitMs) {
+        vTaskDelayUntil(&last, period);
+      } else {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(waitMs) ? pdMS_TO_TICKS(waitMs) : 1);
+        last = xTaskGetTickCount();
+      }
+    }
+  }
+
+  void spawn(uint8_t i, const EnicTaskConfig& cfg) {
+    if (handles[i]) return;   // io beginDisplay() ile erken başlamış olabilir
+    args[i] = { this, i, cfg.periodMs };
+    handles[i] = xTaskCreateStaticPinnedToCore(&EnicTasks::taskEntry, cfg.name, cfg.stack, &args[i],
+                                               cfg.prio, stacks[i], &tcbs[i], cfg.core);
+    // Gerçek zamanlı çekirdek (sense + kontrol): ENIC_HEAP_GUARD=2'de açılış sonrası tahsis abort
+    EnicMem::addStack(cfg.name, handles[i], cfg.stack, cfg.core == 1);
+  }
+
+  void wake(uint8_t i) { if (handles[i]) xTaskNotifyGive(handles[i]); }
+#else
+  // Host: stepDue() için sıradaki çalışma zamanı; woken = task bildirimi
+  uint32_t nextUs[TI_COUNT] = {};
+  bool woken[TI_COUNT] = { true, true, true, true };
+
+  void wake(uint8_t i) { woken[i] = true; }
+#endif
+
+  void wakeAll() { for (uint8_t i = 0; i < TI_COUNT; i++) wake(i); }
+
+public:
+  EnicTasks(EnicStateMachine* b, EnicFace* f, EnicSense* s, EnicSerialLink* l, EnicRecorder* r)
+    : brain(b), face(f), sense(s), serialLink(l), recorder(r) {}
+
+  // Güç yöneticisi (nullptr: hep sabit periyot)
+  void setPower(EnicPower* p) { power = p; }
+
+  // Parametre deposu: değişiklikler log task'ında NVS'e yazılır
+  void setParams(EnicParams* p) { params = p; }
+
+  // Açılış fazları (nullptr: ölçüm yok)
+  void setBoot(EnicBoot* b) { boot = b; }
+
+  uint32_t getActivations(uint8_t i) const { return activations[i]; }
+  uint32_t getOverruns() const { return overruns; }
+
+  // Sense: echo ISR sonucunu filtrele, ses isteklerini uygula
+  void senseStep() {
+    ENIC_PROFILE_SCOPE(PROF_SENSE);
+    sense->update();
+    if (boot && sense->isWarm()) boot->mark(BOOT_RANGE_READY);
+  }
+
+  // Kontrol: komutlar -> FSM -> telemetri anlık görüntüsü
+  void controlStep() {
+    uint32_t t0 = nowUs32();
+    if (boot) boot->mark(BOOT_CONTROL_READY);
+    {
+      ENIC_PROFILE_LOOP_MARK(controlPaced);
+      ENIC_PROFILE_SCOPE(PROF_LOOP);
+      serialLink->drainCommands();
+      brain->update();
+      serialLink->publishStatus();
+    }
+
+    if (power) {
+      power->hold(PWR_HOLD_FSM, brain->isBusy());
+      power->hold(PWR_HOLD_LINK, serialLink->isStreaming());
+      if (power->update(nowMs32())) wakeAll();            // mod değişti: uyuyanlar yeni periyoda geçsin
+      else if (power->isIdle() && face->drawPending()) wake(TI_IO);
+    }
+
+    // Geç kalan tur: bir önceki başlangıçtan bu yana geçen süre + bu turun kendi süresi.
+    // IDLE uykusundan uyanış (msUntilNextEvent, 100 ms'ye kadar) gecikme değil: sadece sabit periyotta
+    if (lastControlUs != 0 && recorder && controlPaced) {
+      uint32_t period = t0 - lastControlUs;
+      if (period > TASK_CONTROL.periodMs * 10UL * CONTROL_OVERRUN_PCT) {
+        overruns++;
+        recorder->record(LOG_OVERRUN, 0, (long)(period / 100), (long)((nowUs32() - t0) / 100));
+      }
+    }
+    lastControlUs = t0;
+  }
+
+  // IO: bekleyen çizimleri render et, UART'ı işle
+  void ioStep() {
+    face->render();
+    if (boot && boot->takeReport()) {
+      boot->printReport(Serial);
+      EnicMem::arm();   // açılış bitti: bundan sonra heap'e dokunulmamalı
+    }
+    ENIC_PROFILE_SCOPE(PROF_SERIAL);
+    bool rx = Serial.available() > 0;
+    serialLink->poll();
+    // IDLE'da gelen bayt: kontrol komutu hemen işlesin, yönetici ACTIVE'e geçsin
+    if (rx && power) {
+      power->kick();
+      if (power->isIdle()) wake(TI_CONTROL);
+    }
+  }
+
+  // Log: kuyruğu flash bloklarına topla, istenirse dök (en düşük öncelik, bekleyebilir)
+  void logStep() {
+    if (recorder) recorder->drainStep();
+    if (params) params->saveIfDue(nowMs32());   // flash yazımı kontrol task'ını bekletmesin
+  }
+
+  // Host / tek task: aynı sırayla
+  void stepAll() {
+    for (uint8_t i = 0; i < TI_COUNT; i++) run(i);
+  }
+
+#if !defined(ARDUINO_ARCH_ESP32)
+  // Host: cihazdaki zamanlama kuralıyla sadece vakti gelen task'lar (sırayla); UART RX io'yu uyandırır
+  void stepDue() {
+    static const EnicTaskConfig* const CFG[TI_COUNT] = { &TASK_SENSE, &TASK_CONTROL, &TASK_IO, &TASK_LOG };
+    uint32_t now = nowUs32();
+    if (power && power->isIdle() && Serial.available() > 0) wake(TI_IO);
+    for (uint8_t i = 0; i < TI_COUNT; i++) {
+      if (!woken[i] && !timeReached(now, nextUs[i])) continue;
+      woken[i] = false;
+      run(i);
+      uint32_t waitMs = idleWaitMs(i);
+      noteWait(i, waitMs);
+      nextUs[i] = now + (waitMs ? waitMs : CFG[i]->periodMs) * 1000UL;
+    }
+  }
+#endif
+
+  // Sadece io task'ı: panel init'i core 0'da setup'ın geri kalanıyla paralel başlar.
+  // Kuyruklar ve face hazır olmalı; kontrol tarafı henüz çizim istemeden de başlayabilir.
+  void beginDisplay() {
+#if defined(ARDUINO_ARCH_ESP32)
+    spawn(TI_IO, TASK_IO);
+#else
+    if (!displayStarted) startup(TI_IO);
+#endif
+    displayStarted = true;
+  }
+
+  // Kalan task'lar (beginDisplay() çağrılmadıysa io da)
+  void begin() {
+#if defined(ARDUINO_ARCH_ESP32)
+    spawn(TI_SENSE,   TASK_SENSE);
+    spawn(TI_CONTROL, TASK_CONTROL);
+    spawn(TI_IO,      TASK_IO);
+    spawn(TI_LOG,     TASK_LOG);
+    // IDLE'da io uyurken gelen bayt (UART olay task'ından)
+    Serial.onReceive([this]() {
+      if (power) power->kick();
+      wake(TI_IO);
+    });
+#else
+    beginDisplay();
+    for (uint8_t i = 0; i < TI_COUNT; i++) if (i != TI_IO) startup(i);
+#endif
+  }
+};
+
+#endif
@@ -0,0 +1,28 @@
+/**
+ * @file EnicTime.h
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Wrap-safe millisecond / microsecond arithmetic
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ *
+ * ESP32'de millis() ~49.7 günde, micros() ~71.6 dakikada sarar (32 bit). Zaman damgaları
+ * uint32_t tutulur, "geldi mi" sorusu sadece işaretli farkla sorulur: now < deadline gibi
+ * mutlak karşılaştırmalar sarmada yanlış sonuç verir. Aralıklar 2^31'den (24.8 gün / 35 dk) kısa olmalı.
+ */
+#ifndef ENIC_TIME_H
+#define ENIC_TIME_H
+
+#include <Arduino.h>
+
+// Host'ta unsigned long 64 bit: cihazla aynı sarma için her zaman 32 bite indir
+inline uint32_t nowMs32() { return (uint32_t)millis(); }
+inline uint32_t nowUs32() { return (uint32_t)micros(); }
+
+// now, deadline'a ulaştı mı (deadline dahil)
+inline bool timeReached(uint32_t now, uint32_t deadline) { return (int32_t)(now - deadline) >= 0; }
+
+// deadline'a kalan süre; geçtiyse negatif
+inline int32_t timeUntil(uint32_t now, uint32_t deadline) { return (int32_t)(deadline - now); }
+
+#endif
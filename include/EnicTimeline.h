@@ -0,0 +1,109 @@
+/**
+ * @file EnicTimeline.cpp / .h
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Keyframe timeline player: scene, sound and motor tracks on one clock
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ *
+ * Gösteri = zamana göre sıralı anahtar listesi (flash) + toplam süre + döngü bayrağı.
+ * Oynatıcı tek bir sayaçla ilerler; yeni koreografi sadece veri ekler (EnicShows.h).
+ */
+#ifndef ENIC_TIMELINE_H
+#define ENIC_TIMELINE_H
+
+#include <Arduino.h>
+
+class EnicFace;
+class EnicSense;
+class EnicMotor;
+
+enum TimelineTrack : uint8_t {
+  TL_SCENE,       // arg: TimelineScene, v0: sahne parametresi, v1: kare periyodu ms (0: tek kare)
+  TL_SOUND,       // arg: SoundEffect
+  TL_MOTOR,       // v0: sol, v1: sağ (EnicMotor::drive hedefi); hareketi bitiren anahtar hareketin
+                  // gerçek başlangıcından sayılır -> geç tick'te de her hareket yazılan süre kadar sürer
+  TL_TRACK_COUNT
+};
+
+enum TimelineScene : uint8_t {
+  SCENE_FACE,     // v0: FaceType
+  SCENE_DANCE,    // v0: dans karesi (0..3)
+  SCENE_BOMB,     // v0: faz (0..3); progress sahne bölümü içinde 0..255
+  SCENE_COUNT
+};
+
+struct TimelineKey {
+  uint32_t atMs;        // gösteri başından
+  TimelineTrack track;
+  uint8_t arg;
+  int16_t v0;
+  int16_t v1;
+};
+
+struct Timeline {
+  const TimelineKey* keys;   // atMs'e göre sıralı
+  uint16_t count;
+  uint32_t durationMs;
+  bool loop;                 // süre sonunda baştan (faz kayması olmadan)
+};
+
+class EnicTimeline {
+public:
+  struct TimelineStats {
+    uint32_t keys = 0;        // tetiklenen anahtar
+    uint32_t frames = 0;      // çizilen sahne karesi
+    uint32_t skipped = 0;     // geç kalındığı için atlanan kare
+    uint32_t maxLateMs = 0;   // kare çizimi ile planlanan zaman arası en büyük fark
+    uint32_t loops = 0;
+  };
+
+  EnicTimeline() = default;
+
+  void begin(EnicMotor* m, EnicFace* f, EnicSense* s);
+  void start(const Timeline* tl, uint32_t now);
+  void stop();
+  bool isActive() const { return show != nullptr; }
+  bool update(uint32_t now);   // her tick'te çağır; bittiyse false döner
+
+  const TimelineStats& getStats() const { return stats; }
+  void resetStats() { stats = TimelineStats(); }
+
+private:
+  typedef void (EnicTimeline::*KeyFn)(const TimelineKey& k, uint32_t t);
+  static const KeyFn TRACKS[TL_TRACK_COUNT];
+
+  EnicMotor* motor = nullptr;
+  EnicFace*  face  = nullptr;
+  EnicSense* sense = nullptr;
+
+  const Timeline* show = nullptr;
+  uint32_t startMs = 0;
+  uint16_t next = 0;                 // sıradaki anahtar
+
+  // Etkin sahne bölümü
+  const TimelineKey* scene = nullptr;
+  uint32_t sceneStart = 0;
+  uint32_t sceneLen = 1;             // sonraki sahne anahtarına / gösteri sonuna kadar
+  uint32_t nextFrame = 0;            // mutlak kare ızgarası (gösteri zamanı)
+
+  // Motor parçası: süren hareketin gecikmesi, sonraki motor anahtarı o kadar ertelenir
+  bool motorMoving = false;
+  uint32_t motorLate = 0;
+  const TimelineKey* motorPending = nullptr;
+  uint32_t motorDue = 0;             // gösteri zamanı (döngüde süre kadar geri alınır)
+  uint32_t motorDueLate = 0;         // bekleyen anahtarın motorDue anındaki gecikmesi
+
+  TimelineStats stats;
+
+  void keyScene(const TimelineKey& k, uint32_t t);
+  void keySound(const TimelineKey& k, uint32_t t);
+  void keyMotor(const TimelineKey& k, uint32_t t);
+  void applyMotor(const TimelineKey& k, uint32_t late);
+  void applyPendingMotor(uint32_t t) { applyMotor(*motorPending, motorDueLate + t - motorDue); }
+
+  void renderScene(uint32_t t);
+  void rewind();
+};
+
+#endif
@@ -0,0 +1,140 @@
+/**
+ * @file Adafruit_GFX.h
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Host shim of the Adafruit_GFX primitives used by ENIC (native env only)
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ *
+ * Line/circle/rect algorithms follow Adafruit_GFX pixel-for-pixel. Text uses the
+ * same 6x8 cell and per-pixel cost as the classic 5x7 font, but glyph bitmaps
+ * are placeholders (the original font table is not vendored).
+ */
+#ifndef ENIC_HOST_ADAFRUIT_GFX_H
+#define ENIC_HOST_ADAFRUIT_GFX_H
+
+#include "Arduino.h"
+
+class Adafruit_GFX : public Print {
+public:
+  Adafruit_GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h), _width(w), _height(h) {}
+
+  virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+  void writePixel(int16_t x, int16_t y, uint16_t color) { drawPixel(x, y, color); }
+  void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) { drawFastVLine(x, y, h, color); }
+
+  virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    for (int16_t i = 0; i < h; i++) drawPixel(x, y + i, color);
+  }
+  virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    for (int16_t i = 0; i < w; i++) drawPixel(x + i, y, color);
+  }
+
+  void writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+    int16_t steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep) { std::swap(x0, y0); std::swap(x1, y1); }
+    if (x0 > x1) { std::swap(x0, x1); std::swap(y0, y1); }
+
+    int16_t dx = x1 - x0;
+    int16_t dy = abs(y1 - y0);
+    int16_t err = dx / 2;
+    int16_t ystep = (y0 < y1) ? 1 : -1;
+
+    for (; x0 <= x1; x0++) {
+      if (steep) writePixel(y0, x0, color);
+      else       writePixel(x0, y0, color);
+      err -= dy;
+      if (err < 0) { y0 += ystep; err += dx; }
+    }
+  }
+
+  void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+    if (x0 == x1) {
+      if (y0 > y1) std::swap(y0, y1);
+      drawFastVLine(x0, y0, y1 - y0 + 1, color);
+    } else if (y0 == y1) {
+      if (x0 > x1) std::swap(x0, x1);
+      drawFastHLine(x0, y0, x1 - x0 + 1, color);
+    } else {
+      writeLine(x0, y0, x1, y1, color);
+    }
+  }
+
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    for (int16_t i = x; i < x + w; i++) writeFastVLine(i, y, h, color);
+  }
+
+  void drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+    int16_t f = 1 - r, ddF_x = 1, ddF_y = -2 * r, x = 0, y = r;
+
+    writePixel(x0, y0 + r, color);
+    writePixel(x0, y0 - r, color);
+    writePixel(x0 + r, y0, color);
+    writePixel(x0 - r, y0, color);
+
+    while (x < y) {
+      if (f >= 0) { y--; ddF_y += 2; f += ddF_y; }
+      x++; ddF_x += 2; f += ddF_x;
+      writePixel(x0 + x, y0 + y, color); writePixel(x0 - x, y0 + y, color);
+      writePixel(x0 + x, y0 - y, color); writePixel(x0 - x, y0 - y, color);
+      writePixel(x0 + y, y0 + x, color); writePixel(x0 - y, y0 + x, color);
+      writePixel(x0 + y, y0 - x, color); writePixel(x0 - y, y0 - x, color);
+    }
+  }
+
+  void fillCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners, int16_t delta, uint16_t color) {
+    int16_t f = 1 - r, ddF_x = 1, ddF_y = -2 * r, x = 0, y = r, px = x, py = y;
+    delta++;
+    while (x < y) {
+      if (f >= 0) { y--; ddF_y += 2; f += ddF_y; }
+      x++; ddF_x += 2; f += ddF_x;
+      if (x < (y + 1)) {
+        if (corners & 1) writeFastVLine(x0 + x, y0 - y, 2 * y + delta, color);
+        if (corners & 2) writeFastVLine(x0 - x, y0 - y, 2 * y + delta, color);
+      }
+      if (y != py) {
+        if (corners & 1) writeFastVLine(x0 + py, y0 - px, 2 * px + delta, color);
+        if (corners & 2) writeFastVLine(x0 - py, y0 - px, 2 * px + delta, color);
+        py = y;
+      }
+      px = x;
+    }
+  }
+
+  void fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+    writeFastVLine(x0, y0 - r, 2 * r + 1, color);
+    fillCircleHelper(x0, y0, r, 3, 0, color);
+  }
+
+  void setCursor(int16_t x, int16_t y) { cursor_x = x; cursor_y = y; }
+  void setTextSize(uint8_t s) { textsize = s ? s : 1; }
+  void setTextColor(uint16_t c) { textcolor = c; }
+
+  using Print::write;
+  size_t write(uint8_t c) override {
+    if (c == '\n') { cursor_x = 0; cursor_y += 8 * textsize; return 1; }
+    if (c == '\r') return 1;
+    // 5x7 hücre; yer tutucu desen (karakter koduna göre)
+    for (int8_t i = 0; i < 5; i++) {
+      uint8_t line = (uint8_t)((c * 0x9Du) >> i);
+      for (int8_t j = 0; j < 8; j++, line >>= 1) {
+        if (line & 1) fillRect(cursor_x + i * textsize, cursor_y + j * textsize, textsize, textsize, textcolor);
+      }
+    }
+    cursor_x += 6 * textsize;
+    return 1;
+  }
+
+  int16_t width() const { return _width; }
+  int16_t height() const { return _height; }
+
+protected:
+  const int16_t WIDTH, HEIGHT;
+  int16_t _width, _height;
+  int16_t cursor_x = 0, cursor_y = 0;
+  uint16_t textcolor = 1;
+  uint8_t textsize = 1;
+};
+
+#endif
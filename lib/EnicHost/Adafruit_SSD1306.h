@@ -0,0 +1,78 @@
+/**
+ * @file Adafruit_SSD1306.h
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Headless SSD1306 for the native env: same framebuffer layout, no panel
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ */
+#ifndef ENIC_HOST_ADAFRUIT_SSD1306_H
+#define ENIC_HOST_ADAFRUIT_SSD1306_H
+
+#include "Adafruit_GFX.h"
+#include "Wire.h"
+
+#define SSD1306_BLACK   0
+#define SSD1306_WHITE   1
+#define SSD1306_INVERSE 2
+
+#define SSD1306_SWITCHCAPVCC 0x02
+#define SSD1306_COLUMNADDR   0x21
+#define SSD1306_PAGEADDR     0x22
+
+class Adafruit_SSD1306 : public Adafruit_GFX {
+public:
+  Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire* twi = &Wire, int8_t rst_pin = -1,
+                   uint32_t clkDuring = 400000UL, uint32_t clkAfter = 100000UL)
+    : Adafruit_GFX(w, h), wire(twi) { (void)rst_pin; (void)clkDuring; (void)clkAfter; }
+
+  ~Adafruit_SSD1306() { if (ownsBuffer) free(buffer); }
+
+  bool begin(uint8_t vcs = SSD1306_SWITCHCAPVCC, uint8_t addr = 0x3C,
+             bool reset = true, bool periphBegin = true) {
+    (void)vcs; (void)addr; (void)reset; (void)periphBegin;
+    if (!buffer) {
+      buffer = (uint8_t*)malloc((size_t)WIDTH * ((HEIGHT + 7) / 8));
+      if (!buffer) return false;
+      ownsBuffer = true;
+    }
+    clearDisplay();
+    return true;
+  }
+
+  // Tam frame gönderimi (bus trafiği sayılır)
+  void display() {
+    wire->beginTransmission(0x3C);
+    wire->write((uint8_t)0x40);
+    wire->write(buffer, (size_t)WIDTH * ((HEIGHT + 7) / 8));
+    wire->endTransmission();
+  }
+
+  void clearDisplay() { memset(buffer, 0, (size_t)WIDTH * ((HEIGHT + 7) / 8)); }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+    if (x < 0 || x >= width() || y < 0 || y >= height()) return;
+    uint8_t& b = buffer[x + (y / 8) * WIDTH];
+    uint8_t m = (uint8_t)(1 << (y & 7));
+    switch (color) {
+      case SSD1306_WHITE:   b |= m;  break;
+      case SSD1306_BLACK:   b &= ~m; break;
+      case SSD1306_INVERSE: b ^= m;  break;
+    }
+  }
+
+  bool getPixel(int16_t x, int16_t y) const {
+    if (x < 0 || x >= width() || y < 0 || y >= height()) return false;
+    return (buffer[x + (y / 8) * WIDTH] >> (y & 7)) & 1;
+  }
+
+  void ssd1306_command(uint8_t) {}
+  uint8_t* getBuffer() { return buffer; }
+
+protected:
+  TwoWire* wire;
+  uint8_t* buffer = nullptr;
+  bool ownsBuffer = false;
+};
+
+#endif
@@ -0,0 +1,216 @@
+/**
+ * @file Arduino.h
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Host shim of the Arduino-ESP32 core API used by ENIC (native env only)
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ */
+#ifndef ENIC_HOST_ARDUINO_H
+#define ENIC_HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+#include "EnicHost.h"
+
+using std::min;
+using std::max;
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define LOW     0x0
+#define HIGH    0x1
+#define INPUT   0x01
+#define OUTPUT  0x03
+#define INPUT_PULLUP 0x05
+
+#define RISING  0x01
+#define FALLING 0x02
+#define CHANGE  0x03
+
+#define IRAM_ATTR
+
+#define constrain(amt,low,high) ((amt)<(low)?(low):((amt)>(high)?(high):(amt)))
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+// ---------------- Time (sanal saat) ----------------
+// ESP32 gibi 32 bitte sarar (millis ~49.7 gün, micros ~71.6 dk); esp_timer 64 bit, sarmaz
+inline unsigned long millis() { return (unsigned long)(uint32_t)(hostBoard().nowUs / 1000ULL); }
+inline unsigned long micros() { return (unsigned long)(uint32_t)hostBoard().nowUs; }
+inline int64_t esp_timer_get_time() { return (int64_t)hostBoard().nowUs; }
+inline void delay(unsigned long ms) { hostAdvanceUs((uint64_t)ms * 1000ULL); }
+inline void delayMicroseconds(unsigned int us) { hostAdvanceUs(us); }
+
+// ---------------- Random (thread başına deterministik) ----------------
+inline void randomSeed(unsigned long seed) { hostBoard().rng = seed ? (uint32_t)seed : 1UL; }
+inline long random(long howbig) {
+  if (howbig <= 0) return 0;
+  uint32_t& x = hostBoard().rng;
+  x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+  return (long)(x % (uint32_t)howbig);
+}
+inline long random(long howsmall, long howbig) {
+  if (howsmall >= howbig) return howsmall;
+  return howsmall + random(howbig - howsmall);
+}
+inline uint32_t esp_random() { return (uint32_t)random(0x7FFFFFFFL); }
+
+// ---------------- GPIO ----------------
+inline void pinMode(uint8_t pin, uint8_t mode) {
+  if (pin < HOST_PIN_COUNT) hostBoard().pinMode[pin] = mode;
+}
+inline int digitalRead(uint8_t pin) {
+  return pin < HOST_PIN_COUNT ? hostBoard().pinLevel[pin] : 0;
+}
+inline void digitalWrite(uint8_t pin, uint8_t val) {
+  if (pin >= HOST_PIN_COUNT) return;
+  HostBoard& b = hostBoard();
+  bool fell = b.pinLevel[pin] && !val;
+  hostSetPin(pin, val);
+  if (fell && pin == b.sonarTrigPin) hostSonarTriggered();
+}
+inline void attachInterruptArg(uint8_t pin, void (*fn)(void*), void* arg, int mode) {
+  if (pin >= HOST_PIN_COUNT) return;
+  HostBoard& b = hostBoard();
+  b.isr[pin] = fn; b.isrArg[pin] = arg; b.isrMode[pin] = mode;
+}
+inline void detachInterrupt(uint8_t pin) {
+  if (pin < HOST_PIN_COUNT) hostBoard().isr[pin] = nullptr;
+}
+inline unsigned long pulseIn(uint8_t, uint8_t, unsigned long = 1000000UL) { return 0; }
+
+// ---------------- LEDC ----------------
+inline double ledcSetup(uint8_t ch, double freq, uint8_t) {
+  if (ch < HOST_LEDC_COUNT) hostBoard().ledcFreq[ch] = freq;
+  return freq;
+}
+inline void ledcAttachPin(uint8_t pin, uint8_t ch) {
+  if (ch < HOST_LEDC_COUNT) hostBoard().ledcPin[ch] = (int8_t)pin;
+}
+inline void ledcWrite(uint8_t ch, uint32_t duty) {
+  if (ch < HOST_LEDC_COUNT) hostBoard().ledcDuty[ch] = duty;
+}
+inline double ledcWriteTone(uint8_t ch, double freq) {
+  if (ch < HOST_LEDC_COUNT) hostBoard().ledcFreq[ch] = freq;
+  return freq;
+}
+
+// ---------------- String (komut yolu için yeterli alt küme) ----------------
+class String {
+public:
+  String() {}
+  String(const char* c) : s(c ? c : "") {}
+  String(const std::string& v) : s(v) {}
+
+  void trim() {
+    size_t a = s.find_first_not_of(" \t\r\n");
+    if (a == std::string::npos) { s.clear(); return; }
+    size_t b = s.find_last_not_of(" \t\r\n");
+    s = s.substr(a, b - a + 1);
+  }
+  void toLowerCase() { for (char& c : s) c = (char)tolower((unsigned char)c); }
+
+  bool operator==(const char* c) const { return s == c; }
+  bool operator==(const String& o) const { return s == o.s; }
+  bool operator!=(const char* c) const { return s != c; }
+  String& operator+=(char c) { s += c; return *this; }
+  String& operator=(const char* c) { s = c ? c : ""; return *this; }
+
+  unsigned int length() const { return (unsigned int)s.size(); }
+  const char* c_str() const { return s.c_str(); }
+  char operator[](unsigned int i) const { return i < s.size() ? s[i] : 0; }
+
+private:
+  std::string s;
+};
+
+// ---------------- Print / Serial ----------------
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buf, size_t n) {
+    for (size_t i = 0; i < n; i++) write(buf[i]);
+    return n;
+  }
+
+  size_t print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+  size_t print(const String& s) { return print(s.c_str()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int v) { return printf("%d", v); }
+  size_t print(unsigned int v) { return printf("%u", v); }
+  size_t print(long v) { return printf("%ld", v); }
+  size_t print(unsigned long v) { return printf("%lu", v); }
+  size_t print(double v, int digits = 2) { return printf("%.*f", digits, v); }
+
+  size_t println() { return print("\r\n"); }
+  template <typename T> size_t println(T v) { size_t n = print(v); return n + println(); }
+  size_t println(double v, int digits) { size_t n = print(v, digits); return n + println(); }
+
+  size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+    char buf[256];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    if (n < 0) return 0;
+    if (n >= (int)sizeof(buf)) n = sizeof(buf) - 1;
+    return write((const uint8_t*)buf, (size_t)n);
+  }
+};
+
+class HardwareSerial : public Print {
+public:
+  void begin(unsigned long) {}
+  size_t setRxBufferSize(size_t n) { return n; }
+  size_t setTxBufferSize(size_t n) { return n; }
+  int available() {
+    hostSerialPump();
+    HostBoard& b = hostBoard();
+    return (int)(b.serialIn.size() - b.serialInPos);
+  }
+  int read() {
+    HostBoard& b = hostBoard();
+    if (b.serialInPos >= b.serialIn.size()) return -1;
+    int c = (unsigned char)b.serialIn[b.serialInPos++];
+    if (b.serialInPos == b.serialIn.size()) { b.serialIn.clear(); b.serialInPos = 0; }
+    return c;
+  }
+  size_t write(uint8_t c) override {
+    hostSerialWrite(&c, 1);
+    return 1;
+  }
+  size_t write(const uint8_t* buf, size_t n) override {
+    hostSerialWrite(buf, n);
+    return n;
+  }
+};
+
+extern HardwareSerial Serial;
+
+// ---------------- ESP ----------------
+// Host'ta "cycle" = gerçek ns (1 GHz eşdeğeri); profiler çıktısı µs olarak doğru kalır
+class EspClass {
+public:
+  uint32_t getCycleCount() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+  }
+  uint32_t getCpuFreqMHz() { return 1000; }
+};
+
+extern EspClass ESP;
+
+#endif
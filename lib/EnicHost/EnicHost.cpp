@@ -0,0 +1,162 @@
+/**
+ * @file EnicHost.cpp
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Virtual ESP32 board for the native (host) build: clock, GPIO, LEDC, sonar
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ */
+#include "EnicHost.h"
+#include "Arduino.h"
+#include "Wire.h"
+#include "LittleFS.h"
+
+#include <math.h>
+#include <unistd.h>
+
+static thread_local HostBoard board;
+
+HostBoard& hostBoard() { return board; }
+
+// Sonar modeli ve Serial bağlantısı senaryolar arasında korunur
+void hostReset() {
+  std::function<float()> sonar = board.sonarRangeCm;
+  bool echo = board.serialEcho;
+  int fd = board.serialFd;
+  board = HostBoard();
+  board.sonarRangeCm = sonar;
+  board.serialEcho = echo;
+  board.serialFd = fd;
+}
+
+static void firePinChange(uint8_t pin, uint8_t level) {
+  uint8_t old = board.pinLevel[pin];
+  board.pinLevel[pin] = level;
+  if (old == level || !board.isr[pin]) return;
+
+  int mode = board.isrMode[pin];
+  bool rising = level && !old;
+  if (mode == CHANGE || (mode == RISING && rising) || (mode == FALLING && !rising)) {
+    board.isr[pin](board.isrArg[pin]);
+  }
+}
+
+void hostSetPin(uint8_t pin, uint8_t level) {
+  if (pin >= HOST_PIN_COUNT) return;
+  firePinChange(pin, level ? 1 : 0);
+}
+
+bool hostSchedulePin(uint64_t atUs, uint8_t pin, uint8_t level) {
+  for (int i = 0; i < HOST_EVENT_CAP; i++) {
+    HostBoard::PinEvent& e = board.events[i];
+    if (e.used) continue;
+    e.atUs = atUs; e.pin = pin; e.level = level; e.used = true;
+    return true;
+  }
+  return false;
+}
+
+void hostMotorPlantEnable(int wheel, uint8_t chFwd, uint8_t chRev) {
+  HostBoard::MotorPlant& p = board.wheel[wheel];
+  p.enabled = true;
+  p.chFwd = chFwd;
+  p.chRev = chRev;
+}
+
+// Birinci dereceden DC motor: hız -> (duty - deadband) * kazanç, tau ile; 1 ms alt adımlar
+static void stepMotorPlants(uint64_t us) {
+  for (HostBoard::MotorPlant& p : board.wheel) {
+    if (!p.enabled) continue;
+    float duty = (float)board.ledcDuty[p.chFwd] - (float)board.ledcDuty[p.chRev];
+    float mag = fabsf(duty) - p.deadband;
+    float ss = mag > 0.0f ? (duty > 0 ? 1.0f : -1.0f) * mag * p.cpsPerDuty * p.supply : 0.0f;
+
+    uint64_t left = us;
+    while (left > 0) {
+      uint64_t stepUs = left > 1000 ? 1000 : left;
+      float dt = stepUs * 1e-6f;
+      p.cps += (ss - p.cps) * (dt / (p.tauS + dt));
+      p.counts += p.cps * dt;
+      left -= stepUs;
+    }
+  }
+}
+
+void hostAdvanceUs(uint64_t us) {
+  stepMotorPlants(us);
+  const uint64_t target = board.nowUs + us;
+  for (;;) {
+    int next = -1;
+    for (int i = 0; i < HOST_EVENT_CAP; i++) {
+      const HostBoard::PinEvent& e = board.events[i];
+      if (!e.used || e.atUs > target) continue;
+      if (next < 0 || e.atUs < board.events[next].atUs) next = i;
+    }
+    if (next < 0) break;
+
+    HostBoard::PinEvent e = board.events[next];
+    board.events[next].used = false;
+    if (e.atUs > board.nowUs) board.nowUs = e.atUs;
+    hostSetPin(e.pin, e.level);
+  }
+  board.nowUs = target;
+}
+
+void hostSerialFeed(const char* data) {
+  board.serialIn += data;
+}
+
+// fd O_NONBLOCK açılmış olmalı
+void hostSerialPump() {
+  if (board.serialFd < 0) return;
+  char buf[512];
+  ssize_t n;
+  while ((n = read(board.serialFd, buf, sizeof(buf))) > 0) board.serialIn.append(buf, (size_t)n);
+}
+
+void hostSerialWrite(const uint8_t* data, size_t n) {
+  if (board.serialFd >= 0) {
+    while (n > 0) {
+      ssize_t w = write(board.serialFd, data, n);
+      if (w <= 0) { usleep(100); continue; }   // pty tamponu dolu: UART gibi bekle
+      data += w; n -= (size_t)w;
+    }
+    return;
+  }
+  if (board.serialEcho) fwrite(data, 1, n, stdout);
+}
+
+// HC-SR04: trigger düşen kenarından ~450 µs sonra echo yükselir,
+// genişlik = cm * 58 µs. Echo yoksa hat düşük kalır (sonar timeout'a düşer).
+void hostSonarTriggered() {
+  if (!board.sonarRangeCm) return;
+  float cm = board.sonarRangeCm();
+  if (cm < 0.0f) return;
+
+  uint64_t rise = board.nowUs + 450;
+  uint64_t width = (uint64_t)(cm * 58.3f);
+  hostSchedulePin(rise, board.sonarEchoPin, 1);
+  hostSchedulePin(rise + width, board.sonarEchoPin, 0);
+}
+
+// Heap sayacı: HostBoard'dan ayrı ve kurucusuz (sarmalayıcı thread_local ilklendirmede
+// kendini çağırmasın). Bağlayıcı --wrap vermezse __wrap_* hiç kullanılmaz.
+static thread_local uint64_t heapAllocs = 0;
+
+uint64_t hostHeapAllocs() { return heapAllocs; }
+
+extern "C" {
+// weak: --wrap'sız bağlamada tanımsız kalır (o durumda __wrap_* de çağrılmaz)
+void* __real_malloc(size_t n) __attribute__((weak));
+void* __real_calloc(size_t n, size_t size) __attribute__((weak));
+void* __real_realloc(void* p, size_t n) __attribute__((weak));
+
+void* __wrap_malloc(size_t n) { heapAllocs++; return __real_malloc(n); }
+void* __wrap_calloc(size_t n, size_t size) { heapAllocs++; return __real_calloc(n, size); }
+void* __wrap_realloc(void* p, size_t n) { heapAllocs++; return __real_realloc(p, n); }
+}
+
+HardwareSerial Serial;
+EspClass ESP;
+TwoWire Wire;
+fs::LittleFSFS LittleFS;
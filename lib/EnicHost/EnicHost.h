@@ -0,0 +1,112 @@
+/**
+ * @file EnicHost.h
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Virtual ESP32 board for the native (host) build: clock, GPIO, LEDC, sonar
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ */
+#ifndef ENIC_HOST_H
+#define ENIC_HOST_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <functional>
+#include <map>
+#include <string>
+
+static const int HOST_PIN_COUNT  = 40;
+static const int HOST_LEDC_COUNT = 16;
+static const int HOST_EVENT_CAP  = 16;
+
+typedef void (*HostIsr)(void*);
+
+// Her thread kendi kartını görür (paralel simülasyon için thread_local)
+struct HostBoard {
+  uint64_t nowUs = 1;
+
+  uint8_t pinMode[HOST_PIN_COUNT] = {};
+  uint8_t pinLevel[HOST_PIN_COUNT] = {};
+  HostIsr isr[HOST_PIN_COUNT] = {};
+  void*   isrArg[HOST_PIN_COUNT] = {};
+  int     isrMode[HOST_PIN_COUNT] = {};
+
+  uint32_t ledcDuty[HOST_LEDC_COUNT] = {};
+  double   ledcFreq[HOST_LEDC_COUNT] = {};
+  int8_t   ledcPin[HOST_LEDC_COUNT] = {};
+
+  // Zamanlanmış pin değişimleri (echo kenarları vb.), zaman sıralı değil; küçük
+  struct PinEvent { uint64_t atUs; uint8_t pin; uint8_t level; bool used; };
+  PinEvent events[HOST_EVENT_CAP] = {};
+
+  // HC-SR04 modeli: trigger düşen kenarında çağrılır, cm döner (<0: echo yok)
+  std::function<float()> sonarRangeCm;
+  uint8_t sonarTrigPin = 5;
+  uint8_t sonarEchoPin = 18;
+
+  // Serial: okunacak byte'lar; yazılanlar serialEcho ise stdout'a
+  std::string serialIn;
+  size_t serialInPos = 0;
+  bool serialEcho = true;
+  int serialFd = -1;          // >=0: Serial gerçek bir tty/pty'ye bağlı (serve modu)
+
+  uint32_t rng = 0x12345678UL;
+
+  // DC motor + enkoder modeli (EnicMotor LEDC çıkışından beslenir, hostAdvanceUs'de entegre edilir)
+  struct MotorPlant {
+    bool enabled = false;
+    uint8_t chFwd = 0, chRev = 0;   // LEDC kanalları (duty = fwd - rev)
+    float cpsPerDuty = 9.4f;        // kararlı hız (count/s) / duty, deadband üstünde
+    float deadband = 25.0f;         // bu duty altında tekerlek dönmez (sürtünme)
+    float tauS = 0.06f;             // mekanik zaman sabiti
+    float supply = 1.0f;            // batarya / zemin çarpanı
+    float cps = 0.0f;               // anlık hız
+    double counts = 0.0;
+  };
+  MotorPlant wheel[2];
+
+  uint64_t i2cBytes = 0;
+  uint32_t i2cTransactions = 0;
+
+  // LittleFS: bellekte dosyalar (yol -> içerik); hostReset siler, "yeniden başlatma" için korunur
+  std::map<std::string, std::string> files;
+  size_t fsBytes = 1408 * 1024;   // esp32dev varsayılan bölümü
+
+  // NVS (Preferences): "isim/anahtar" -> bayt; LittleFS gibi Rig yeniden kurulunca korunur
+  std::map<std::string, std::string> nvs;
+};
+
+HostBoard& hostBoard();
+
+// Kartı sıfırla (yeni senaryo)
+void hostReset();
+
+// Sanal saati ilerlet; aradaki pin olaylarını sırayla işler (ISR'ler çağrılır)
+void hostAdvanceUs(uint64_t us);
+
+// Pin seviyesini şimdi değiştir (ISR tetiklenir)
+void hostSetPin(uint8_t pin, uint8_t level);
+
+// atUs anında pin seviyesi değişecek
+bool hostSchedulePin(uint64_t atUs, uint8_t pin, uint8_t level);
+
+// Arduino Serial'e host tarafından satır/byte gönder
+void hostSerialFeed(const char* data);
+
+// serialFd açıksa bekleyen baytları serialIn'e çek (bloklamaz)
+void hostSerialPump();
+
+// Serial çıkışı: serialFd'ye veya (serialEcho ise) stdout'a
+void hostSerialWrite(const uint8_t* data, size_t n);
+
+// Tekerlek modelini iki motor kanalına bağla (0: sol, 1: sağ)
+void hostMotorPlantEnable(int wheel, uint8_t chFwd, uint8_t chRev);
+
+// digitalWrite(trig, LOW) tarafından çağrılır; sonarRangeCm varsa echo kenarlarını planlar
+void hostSonarTriggered();
+
+// Bu iş parçacığındaki malloc/calloc/realloc sayısı (-Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc
+// ile bağlandıysa; yoksa hep 0). EnicMem açılış sonrası tahsisleri bununla sayar.
+uint64_t hostHeapAllocs();
+
+#endif
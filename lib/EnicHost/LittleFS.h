@@ -0,0 +1,125 @@
+/**
+ * @file LittleFS.h
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Host shim of the Arduino-ESP32 LittleFS / fs::File API (in-memory, native env only)
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ *
+ * Dosyalar HostBoard::files'ta tutulur. Kip: "r" okuma, "r+" okuma/yazma (dosya olmalı),
+ * "w"/"w+" kırp veya oluştur, "a" sona ekle. seek() dosya sonunu geçebilir (yazınca sıfırla dolar).
+ */
+#ifndef ENIC_HOST_LITTLEFS_H
+#define ENIC_HOST_LITTLEFS_H
+
+#include <Arduino.h>
+
+#define FILE_READ   "r"
+#define FILE_WRITE  "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+class File {
+private:
+  std::string* data = nullptr;   // map düğümü: silinmedikçe sabit adres
+  size_t pos = 0;
+  bool writable = false;
+
+public:
+  File() {}
+  File(std::string* d, size_t p, bool w) : data(d), pos(p), writable(w) {}
+
+  operator bool() const { return data != nullptr; }
+
+  size_t write(const uint8_t* buf, size_t n) {
+    if (!data || !writable) return 0;
+    if (pos + n > data->size()) data->resize(pos + n, '\0');
+    memcpy(&(*data)[pos], buf, n);
+    pos += n;
+    return n;
+  }
+  size_t write(uint8_t c) { return write(&c, 1); }
+
+  size_t read(uint8_t* buf, size_t n) {
+    if (!data || pos >= data->size()) return 0;
+    if (n > data->size() - pos) n = data->size() - pos;
+    memcpy(buf, data->data() + pos, n);
+    pos += n;
+    return n;
+  }
+
+  bool seek(uint32_t p, SeekMode mode = SeekSet) {
+    if (!data) return false;
+    long base = mode == SeekCur ? (long)pos : (mode == SeekEnd ? (long)data->size() : 0L);
+    if (base + (long)p < 0) return false;
+    pos = (size_t)(base + (long)p);
+    return true;
+  }
+
+  size_t position() const { return pos; }
+  size_t size() const { return data ? data->size() : 0; }
+  void flush() {}
+  void close() { data = nullptr; }
+};
+
+class LittleFSFS {
+public:
+  bool begin(bool formatOnFail = false, const char* basePath = "/littlefs",
+             uint8_t maxOpenFiles = 10, const char* partitionLabel = "spiffs") {
+    (void)formatOnFail; (void)basePath; (void)maxOpenFiles; (void)partitionLabel;
+    return true;
+  }
+  void end() {}
+  bool format() { hostBoard().files.clear(); return true; }
+
+  File open(const char* path, const char* mode = FILE_READ, bool create = false) {
+    std::map<std::string, std::string>& files = hostBoard().files;
+    auto it = files.find(path);
+    bool plus = strchr(mode, '+') != nullptr;
+
+    switch (mode[0]) {
+      case 'r':
+        if (it == files.end()) {
+          if (!create) return File();
+          it = files.emplace(path, std::string()).first;
+        }
+        return File(&it->second, 0, plus);
+      case 'w':
+        it = files.insert_or_assign(path, std::string()).first;
+        return File(&it->second, 0, true);
+      case 'a':
+        if (it == files.end()) it = files.emplace(path, std::string()).first;
+        return File(&it->second, it->second.size(), true);
+      default:
+        return File();
+    }
+  }
+  File open(const String& path, const char* mode = FILE_READ, bool create = false) {
+    return open(path.c_str(), mode, create);
+  }
+
+  bool exists(const char* path) { return hostBoard().files.count(path) != 0; }
+  bool remove(const char* path) { return hostBoard().files.erase(path) != 0; }
+
+  size_t totalBytes() { return hostBoard().fsBytes; }
+  size_t usedBytes() {
+    size_t n = 0;
+    for (const auto& f : hostBoard().files) n += (f.second.size() + 4095) / 4096 * 4096;
+    return n;
+  }
+};
+
+}  // namespace fs
+
+using fs::File;
+using fs::SeekMode;
+using fs::SeekSet;
+using fs::SeekCur;
+using fs::SeekEnd;
+
+extern fs::LittleFSFS LittleFS;
+
+#endif
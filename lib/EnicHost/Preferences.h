@@ -0,0 +1,74 @@
+/**
+ * @file Preferences.h
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Host shim of the Arduino-ESP32 Preferences (NVS) API, bytes only (native env only)
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ *
+ * Anahtarlar HostBoard::nvs'te "isim/anahtar" olarak tutulur; hostReset siler.
+ * Cihazdaki gibi getBytes, tampon küçükse 0 döner.
+ */
+#ifndef ENIC_HOST_PREFERENCES_H
+#define ENIC_HOST_PREFERENCES_H
+
+#include <Arduino.h>
+
+class Preferences {
+private:
+  std::string ns;
+  bool open = false;
+  bool readOnly = false;
+
+  std::string path(const char* key) const { return ns + "/" + key; }
+
+public:
+  bool begin(const char* name, bool ro = false, const char* partitionLabel = nullptr) {
+    (void)partitionLabel;
+    ns = name;
+    readOnly = ro;
+    open = true;
+    return true;
+  }
+  void end() { open = false; }
+
+  bool isKey(const char* key) const { return open && hostBoard().nvs.count(path(key)) != 0; }
+
+  size_t putBytes(const char* key, const void* value, size_t len) {
+    if (!open || readOnly) return 0;
+    hostBoard().nvs[path(key)].assign((const char*)value, len);
+    return len;
+  }
+
+  size_t getBytesLength(const char* key) const {
+    if (!open) return 0;
+    auto it = hostBoard().nvs.find(path(key));
+    return it == hostBoard().nvs.end() ? 0 : it->second.size();
+  }
+
+  size_t getBytes(const char* key, void* buf, size_t maxLen) const {
+    if (!open) return 0;
+    auto it = hostBoard().nvs.find(path(key));
+    if (it == hostBoard().nvs.end() || it->second.size() > maxLen) return 0;
+    memcpy(buf, it->second.data(), it->second.size());
+    return it->second.size();
+  }
+
+  bool remove(const char* key) {
+    if (!open || readOnly) return false;
+    return hostBoard().nvs.erase(path(key)) != 0;
+  }
+
+  bool clear() {
+    if (!open || readOnly) return false;
+    std::map<std::string, std::string>& nvs = hostBoard().nvs;
+    std::string prefix = ns + "/";
+    for (auto it = nvs.begin(); it != nvs.end();) {
+      if (it->first.compare(0, prefix.size(), prefix) == 0) it = nvs.erase(it);
+      else ++it;
+    }
+    return true;
+  }
+};
+
+#endif
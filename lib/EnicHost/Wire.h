@@ -0,0 +1,47 @@
+/**
+ * @file Wire.h
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Host shim of the Arduino Wire (I2C) API; counts bus traffic only
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ */
+#ifndef ENIC_HOST_WIRE_H
+#define ENIC_HOST_WIRE_H
+
+#include "Arduino.h"
+
+#define I2C_BUFFER_LENGTH 128
+
+class TwoWire {
+public:
+  bool begin(int = -1, int = -1, uint32_t = 0) { return true; }
+  bool end() { return true; }
+  void setClock(uint32_t) {}
+
+  // Adres byte'ı da bus trafiğine dahil
+  void beginTransmission(uint8_t) { hostBoard().i2cBytes++; txLen = 0; overflow = false; }
+
+  // Arduino gibi: tampon dolunca write 0 döner, endTransmission 1 (data too long) ile reddeder
+  size_t write(uint8_t b) { return write(&b, 1); }
+  size_t write(const uint8_t*, size_t n) {
+    size_t room = I2C_BUFFER_LENGTH - txLen;
+    if (n > room) { n = room; overflow = true; }
+    txLen += n;
+    hostBoard().i2cBytes += n;
+    return n;
+  }
+
+  uint8_t endTransmission(bool = true) {
+    hostBoard().i2cTransactions++;
+    return overflow ? 1 : 0;
+  }
+
+private:
+  size_t txLen = 0;
+  bool overflow = false;
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,140 @@
+/**
+ * @file EnicTimeline.cpp / .h
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Keyframe timeline player: scene, sound and motor tracks on one clock
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ */
+#include "EnicTimeline.h"
+#include "EnicMotor.h"
+#include "EnicFace.h"
+#include "EnicSense.h"
+
+// TimelineTrack sırasıyla
+const EnicTimeline::KeyFn EnicTimeline::TRACKS[TL_TRACK_COUNT] = {
+  &EnicTimeline::keyScene,
+  &EnicTimeline::keySound,
+  &EnicTimeline::keyMotor,
+};
+
+void EnicTimeline::begin(EnicMotor* m, EnicFace* f, EnicSense* s) {
+  motor = m;
+  face  = f;
+  sense = s;
+}
+
+void EnicTimeline::start(const Timeline* tl, uint32_t now) {
+  if (!motor || !face || !sense || !tl) return;
+  show = tl;
+  startMs = now;
+  motorMoving = false;
+  motorLate = 0;
+  motorPending = nullptr;
+  rewind();
+  update(now);   // t=0 anahtarları hemen
+}
+
+void EnicTimeline::stop() {
+  show = nullptr;
+  scene = nullptr;
+  motorPending = nullptr;
+}
+
+void EnicTimeline::rewind() {
+  next = 0;
+  scene = nullptr;
+}
+
+// true: devam ediyor, false: bitti
+bool EnicTimeline::update(uint32_t now) {
+  if (!show) return false;
+
+  uint32_t t = now - startMs;
+  for (;;) {
+    if (motorPending && t >= motorDue) applyPendingMotor(t);
+
+    // Zamanı gelen (ve geç kalınmış) anahtarlar sırayla; parça türü tablo ile
+    while (next < show->count && show->keys[next].atMs <= t) {
+      const TimelineKey& k = show->keys[next++];
+      (this->*TRACKS[k.track])(k, t);
+      stats.keys++;
+    }
+    if (t < show->durationMs) break;
+
+    if (!show->loop) { stop(); return false; }
+    // Döngü: başlangıcı süre kadar ileri al -> tempo kaymaz
+    startMs += show->durationMs;
+    t -= show->durationMs;
+    if (motorPending) motorDue -= show->durationMs;   // bekleyen bitiş süreden sonra (> t)
+    rewind();
+    stats.loops++;
+  }
+
+  renderScene(t);
+  return true;
+}
+
+void EnicTimeline::keyScene(const TimelineKey& k, uint32_t) {
+  scene = &k;
+  sceneStart = k.atMs;
+
+  // Bölüm uzunluğu: sonraki sahne anahtarına ya da gösteri sonuna kadar
+  uint32_t end = show->durationMs;
+  for (uint16_t i = (uint16_t)(&k - show->keys) + 1; i < show->count; i++) {
+    if (show->keys[i].track == TL_SCENE) { end = show->keys[i].atMs; break; }
+  }
+  sceneLen = end > sceneStart ? end - sceneStart : 1;
+  nextFrame = sceneStart;
+}
+
+void EnicTimeline::keySound(const TimelineKey& k, uint32_t) {
+  sense->playEffect(k.arg);
+}
+
+// Anahtar tick ızgarasında geç tetiklenir (en çok bir kontrol periyodu). Hareket sürerken sonraki
+// motor anahtarı da aynı gecikmeyle: başlangıç ve bitiş aynı ızgarada -> zıt hareketler eşit uzunlukta.
+// Duruştan başlayan hareket kendi zamanında; gecikme birikmez.
+void EnicTimeline::keyMotor(const TimelineKey& k, uint32_t t) {
+  if (motorPending) applyPendingMotor(t);   // üst üste binen anahtar: bekleyeni hemen uygula
+  uint32_t due = k.atMs + (motorMoving ? motorLate : 0);
+  if (t < due) {
+    motorPending = &k;
+    motorDue = due;
+    motorDueLate = due - k.atMs;
+    return;
+  }
+  applyMotor(k, t - k.atMs);
+}
+
+void EnicTimeline::applyMotor(const TimelineKey& k, uint32_t late) {
+  motor->drive(k.v0, k.v1);
+  motorMoving = k.v0 != 0 || k.v1 != 0;
+  motorLate = late;
+  motorPending = nullptr;
+}
+
+void EnicTimeline::renderScene(uint32_t t) {
+  if (!scene || t < nextFrame) return;
+
+  uint32_t late = t - nextFrame;
+  if (late > stats.maxLateMs) stats.maxLateMs = late;
+  stats.frames++;
+
+  uint32_t p = t - sceneStart;
+  uint8_t progress = (uint8_t)min(255UL, (unsigned long)(((uint64_t)p * 255UL) / sceneLen));
+
+  switch (scene->arg) {
+    case SCENE_FACE:  face->draw((FaceType)scene->v0); break;
+    case SCENE_DANCE: face->drawDance(scene->v0); break;
+    case SCENE_BOMB:  face->drawBombScene((uint8_t)scene->v0, progress, t); break;
+    default: break;
+  }
+
+  // Kare ızgarası sahne başına sabit; geç kalındıysa aradaki kareler atlanır
+  uint32_t period = (uint32_t)scene->v1;
+  if (period == 0) { scene = nullptr; return; }   // tek kare
+  uint32_t steps = (t - nextFrame) / period + 1;
+  stats.skipped += steps - 1;
+  nextFrame += steps * period;
+}
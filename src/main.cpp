@@ -11,6 +11,14 @@
 #include "EnicFace.h"
 #include "EnicSense.h"
 #include "EnicState.h"
+#include "EnicProfile.h"
+#include "EnicSerialLink.h"
+#include "EnicTasks.h"
+#include "EnicRecorder.h"
+#include "EnicPower.h"
+#include "EnicParams.h"
+#include "EnicBoot.h"
+#include "EnicMem.h"
 #include "esp_system.h"
 
 EnicMotor motor;
@@ -18,38 +26,100 @@ EnicFace  face;
 EnicSense sense;
 
 EnicStateMachine brain(&motor, &face, &sense);
+EnicSerialLink   serialLink(&brain, &motor, &sense);
+EnicRecorder     recorder;
+EnicPower        power;
+EnicParams       params;
+EnicBoot         boot;
+EnicTasks        tasks(&brain, &face, &sense, &serialLink, &recorder);
 
+#if ENIC_HEAP_GUARD
+// -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc (platformio.ini esp32dev_static): açılıştan sonra
+// her tahsis EnicMem'e gider; mod 2'de gerçek zamanlı task'larda abort. free serbest.
+extern "C" {
+void* __real_malloc(size_t n);
+void* __real_calloc(size_t n, size_t size);
+void* __real_realloc(void* p, size_t n);
+
+void* __wrap_malloc(size_t n) {
+  EnicMem::onAlloc(n, __builtin_return_address(0));
+  return __real_malloc(n);
+}
+void* __wrap_calloc(size_t n, size_t size) {
+  EnicMem::onAlloc(n * size, __builtin_return_address(0));
+  return __real_calloc(n, size);
+}
+void* __wrap_realloc(void* p, size_t n) {
+  EnicMem::onAlloc(n, __builtin_return_address(0));
+  return __real_realloc(p, n);
+}
+}
+#endif
+
+// Açılış sırası: önce motorlar güvenli, sonra UART; panel init'i io task'ında (core 0) setup'ın
+// geri kalanıyla paralel, LittleFS bağlama log task'ında. Fazlar EnicBoot'ta, rapor tek JSON satırı.
 void setup() {
-  Serial.begin(115200);
+  boot.mark(BOOT_SETUP);
+  motor.begin();                  // LEDC 0 duty: reset sonrası tekerlek oynamasın
+  boot.mark(BOOT_MOTORS_SAFE);
+
+  // Binary çerçeve / telemetri patlamaları için (varsayılan 256 / 0)
+  Serial.setRxBufferSize(1024);
+  Serial.setTxBufferSize(512);
+  Serial.begin(ENIC_SERIAL_BAUD);
+  boot.mark(BOOT_SERIAL);
 
-  motor.begin();
-  face.begin();
-  sense.begin();
+  // IDLE'da 80 MHz + light sleep, task'lar olay gelene kadar uyur; "pwr" ile rapor
+  power.begin();
+  brain.setPower(&power);
+  sense.setPower(&power);
+  tasks.setPower(&power);
 
+  // I2C + SSD1306 init + ilk kare core 0'da başlasın; aşağıdakiler paralel
+  tasks.setBoot(&boot);
+  tasks.beginDisplay();
+
+  sense.begin();                  // ilk pingler kısa aralıkla: medyan penceresi çabuk dolsun
   brain.begin();
 
+  // Uçuş kaydı: kayıtlar hemen halkaya; LittleFS log task'ında bağlanır, "log 1" ile dökülür
+  recorder.begin();
+  brain.setRecorder(&recorder);
+
+  // Ayarlar: NVS'ten tek okuma, sonra uygulanır; get/set/dump ile değişir, log task'ı kaydeder
+  EnicParams::LoadResult loaded = params.begin();
+  if (loaded == EnicParams::LOAD_STALE || loaded == EnicParams::LOAD_CORRUPT) Serial.println("NVS params ignored, defaults");
+  brain.setParams(&params);
+  tasks.setParams(&params);
+  brain.setBoot(&boot);
+
+  // Statik RAM bütçesi ("mem"); heap açılış raporundan sonra kilitlenir (EnicMem::arm)
+  EnicMem::add("motor",    sizeof(motor));
+  EnicMem::add("face",     sizeof(face));
+  EnicMem::add("sense",    sizeof(sense));
+  EnicMem::add("brain",    sizeof(brain));
+  EnicMem::add("link",     sizeof(serialLink));
+  EnicMem::add("recorder", sizeof(recorder));
+  EnicMem::add("power",    sizeof(power));
+  EnicMem::add("params",   sizeof(params));
+  EnicMem::add("tasks",    sizeof(tasks));
+  EnicMem::add("boot",     sizeof(boot));
+  EnicMem::addStack("esp_timer", xTaskGetHandle("esp_timer"), CONFIG_ESP_TIMER_TASK_STACK_SIZE);
+
   randomSeed(esp_random() ^ micros());
 
   Serial.println("ENIC V1");
-  Serial.println("Komutlar: ileri/geri/sol/sag | dur | otonom | dans | konus | dinle | sasir | kork | agla | dil");
+  Serial.println("Komutlar: ileri/geri/sol/sag [hiz] [ms] | ping <ms> | get/set/dump | boot | mem | dur | otonom | dans | konus | dinle | sasir | kork | agla | dil");
+
+  // IDLE ifade / blink zamanlayıcıları kontrol tarafının; kontrol task'ı başlamadan
+  face.beginIdle();
+
+  // sense + kontrol core 1, log core 0 (io zaten çalışıyor); "boot" ile faz raporu
+  boot.mark(BOOT_CORE_READY);
+  tasks.begin();
 }
 
 void loop() {
-  brain.update();
-
-  // Non-blocking serial line buffer
-  static String line;
-  while (Serial.available()) {
-    char c = (char)Serial.read();
-    if (c == '\r') continue;
-
-    if (c == '\n') {
-      if (line.length() > 0) {
-        brain.handleCommand(line);
-        line = "";
-      }
-    } else {
-      if (line.length() < 64) line += c;
-    }
-  }
-}
\ No newline at end of file
+  // Tüm iş EnicTasks'ta; Arduino loop task'ına gerek yok
+  vTaskDelete(nullptr);
+}
@@ -0,0 +1,88 @@
+/**
+ * @file EnicRig.h
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Whole firmware object graph on the host board (bench + simulator)
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ *
+ * main.cpp'deki nesnelerin aynısı; task'lar gerçek zamanlı değil stepAll() ile sırayla döner.
+ * HostBoard thread_local: her iş parçacığı kendi Rig'ini (hostReset sonrası) kurar.
+ */
+#ifndef ENIC_RIG_H
+#define ENIC_RIG_H
+
+#include <Arduino.h>
+#include <EnicHost.h>
+
+#include "EnicMotor.h"
+#include "EnicFace.h"
+#include "EnicSense.h"
+#include "EnicState.h"
+#include "EnicSerialLink.h"
+#include "EnicRecorder.h"
+#include "EnicPower.h"
+#include "EnicParams.h"
+#include "EnicBoot.h"
+#include "EnicMem.h"
+#include "EnicTasks.h"
+
+struct Rig {
+  EnicMotor motor;
+  EnicFace  face;
+  EnicSense sense;
+  EnicStateMachine brain;
+  EnicSerialLink link;
+  EnicRecorder recorder;
+  EnicPower power;
+  EnicParams params;
+  EnicBoot boot;
+  EnicTasks tasks;
+
+  Rig() : brain(&motor, &face, &sense), link(&brain, &motor, &sense),
+          tasks(&brain, &face, &sense, &link, &recorder) {
+    hostMotorPlantEnable(0, M1_IN1_CH, M1_IN2_CH);
+    hostMotorPlantEnable(1, M2_IN3_CH, M2_IN4_CH);
+    // main.cpp setup() sırası; host'ta io / log startup'ı beginDisplay() / begin() içinde hemen
+    boot.mark(BOOT_SETUP);
+    motor.begin();
+    boot.mark(BOOT_MOTORS_SAFE);
+    boot.mark(BOOT_SERIAL);
+    power.begin();
+    brain.setPower(&power);
+    sense.setPower(&power);
+    tasks.setPower(&power);
+    tasks.setBoot(&boot);
+    tasks.beginDisplay();
+    sense.begin();
+    brain.begin();
+    recorder.begin();
+    brain.setRecorder(&recorder);
+    params.begin();               // HostBoard::nvs: hostReset'e kadar "yeniden başlatmada" korunur
+    brain.setParams(&params);
+    tasks.setParams(&params);
+    brain.setBoot(&boot);
+    EnicMem::clear();
+    EnicMem::add("motor",    sizeof(motor));
+    EnicMem::add("face",     sizeof(face));
+    EnicMem::add("sense",    sizeof(sense));
+    EnicMem::add("brain",    sizeof(brain));
+    EnicMem::add("link",     sizeof(link));
+    EnicMem::add("recorder", sizeof(recorder));
+    EnicMem::add("power",    sizeof(power));
+    EnicMem::add("params",   sizeof(params));
+    EnicMem::add("tasks",    sizeof(tasks));
+    EnicMem::add("boot",     sizeof(boot));
+    face.beginIdle();
+    boot.mark(BOOT_CORE_READY);
+    tasks.begin();
+  }
+
+  // Firmware'deki task'ların bir turu (sense -> kontrol -> io -> log)
+  void step() { tasks.stepAll(); }
+
+  // Sadece vakti gelen task'lar, cihazdaki periyot / IDLE uyku kuralıyla
+  void stepDue() { tasks.stepDue(); }
+};
+
+#endif
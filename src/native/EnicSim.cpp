@@ -0,0 +1,548 @@
+/**
+ * @file EnicSim.cpp / .h
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Closed-loop virtual world: diff-drive plant, ray-cast sonar, map files, parallel sweeps
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ *
+ * Çıktı: harita x parametre kombinasyonu başına bir JSON satırı, ör.
+ *   {"suite":"sim","map":"living","case":"auto_obs_enter=25","runs":8,"collisions_per_hour":4.5,...}
+ */
+#include "EnicSim.h"
+#include "EnicRig.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <thread>
+
+#include <dirent.h>
+
+const char* const SIM_COURSE_MAP =
+  "# 4 x 3 m oda, beş kutu (avoid_sim parkuru)\n"
+  "room 400 300\n"
+  "box 120 80 160 120\n"
+  "box 250 180 300 220\n"
+  "box 280 40 320 90\n"
+  "box 70 200 120 240\n"
+  "box 190 130 215 155\n"
+  "start 40 40 17.19\n";
+
+static const float SIM_ROBOT_R_CM = 9.0f;      // gövde yarıçapı = sonarın poz merkezine uzaklığı
+static const float SIM_WALL_CM = 10.0f;
+static const float SIM_AREA_CELL_CM = 5.0f;
+static const long  SIM_STEP_US = 2000;
+static const long  SIM_CONTACT_GAP_STEPS = 250;  // 0.5 s
+static const long  SIM_REPEAT_STEPS = 1000;      // 2 s
+
+// ---------------- World ----------------
+bool SimWorld::rayCast(float x, float y, float a, float maxCm, float& dist, float& cosInc) const {
+  const float dx = cosf(a), dy = sinf(a);
+  float best = maxCm;
+  bool found = false;
+
+  for (const SimBox& b : boxes) {
+    float t0 = 0.0f, t1 = best;
+    int axis = -1;
+    const float o[2] = { x, y }, d[2] = { dx, dy }, lo[2] = { b.x0, b.y0 }, hi[2] = { b.x1, b.y1 };
+    bool hit = true;
+    for (int k = 0; k < 2 && hit; k++) {
+      if (fabsf(d[k]) < 1e-6f) { if (o[k] < lo[k] || o[k] > hi[k]) hit = false; continue; }
+      float ta = (lo[k] - o[k]) / d[k], tb = (hi[k] - o[k]) / d[k];
+      if (ta > tb) std::swap(ta, tb);
+      if (ta > t0) { t0 = ta; axis = k; }
+      if (tb < t1) t1 = tb;
+      if (t0 > t1) hit = false;
+    }
+    if (!hit || t0 >= best) continue;
+    best = t0;
+    found = true;
+    cosInc = axis < 0 ? 1.0f : fabsf(d[axis]);   // giriş yüzünün normali o eksende
+  }
+
+  for (const SimPost& p : posts) {
+    float ox = x - p.cx, oy = y - p.cy;
+    float b = ox * dx + oy * dy, c = ox * ox + oy * oy - p.r * p.r;
+    float disc = b * b - c;
+    if (disc < 0.0f) continue;
+    float t = -b - sqrtf(disc);
+    if (t < 0.0f) t = 0.0f;
+    if (t >= best) continue;
+    best = t;
+    found = true;
+    float nx = (ox + t * dx) / p.r, ny = (oy + t * dy) / p.r;
+    cosInc = fabsf(nx * dx + ny * dy);
+  }
+
+  dist = best;
+  return found;
+}
+
+bool SimWorld::resolve(float& x, float& y, float r) const {
+  bool hit = false;
+  for (const SimBox& b : boxes) {
+    float cx = x < b.x0 ? b.x0 : (x > b.x1 ? b.x1 : x);
+    float cy = y < b.y0 ? b.y0 : (y > b.y1 ? b.y1 : y);
+    float dx = x - cx, dy = y - cy, d2 = dx * dx + dy * dy;
+    if (d2 >= r * r) continue;
+    hit = true;
+    float d = sqrtf(d2);
+    if (d < 1e-4f) continue;   // merkez kutu içinde: olmamalı
+    x = cx + dx / d * r;
+    y = cy + dy / d * r;
+  }
+  for (const SimPost& p : posts) {
+    float dx = x - p.cx, dy = y - p.cy, rr = r + p.r, d2 = dx * dx + dy * dy;
+    if (d2 >= rr * rr) continue;
+    hit = true;
+    float d = sqrtf(d2);
+    if (d < 1e-4f) continue;
+    x = p.cx + dx / d * rr;
+    y = p.cy + dy / d * rr;
+  }
+  return hit;
+}
+
+bool SimWorld::inside(float x, float y) const {
+  for (const SimBox& b : boxes) if (x >= b.x0 && x <= b.x1 && y >= b.y0 && y <= b.y1) return true;
+  for (const SimPost& p : posts) if ((x - p.cx) * (x - p.cx) + (y - p.cy) * (y - p.cy) <= p.r * p.r) return true;
+  return false;
+}
+
+bool SimWorld::parse(const std::string& text, std::string& err) {
+  std::istringstream in(text);
+  std::string line;
+  int lineNo = 0;
+  bool haveRoom = false;
+
+  while (std::getline(in, line)) {
+    lineNo++;
+    size_t hash = line.find('#');
+    if (hash != std::string::npos) line.erase(hash);
+    std::istringstream ls(line);
+    std::string kw;
+    if (!(ls >> kw)) continue;
+
+    float v[4];
+    int need = kw == "room" ? 2 : (kw == "post" || kw == "start") ? 3 : kw == "box" ? 4 : -1;
+    if (need < 0) { err = std::to_string(lineNo) + ": unknown '" + kw + "'"; return false; }
+    for (int i = 0; i < need; i++) {
+      if (!(ls >> v[i])) { err = std::to_string(lineNo) + ": " + kw + " needs " + std::to_string(need) + " numbers"; return false; }
+    }
+
+    if (kw == "room") {
+      widthCm = v[0];
+      heightCm = v[1];
+      const float w = SIM_WALL_CM;
+      boxes.push_back({ -w, -w, widthCm + w, 0.0f });
+      boxes.push_back({ -w, heightCm, widthCm + w, heightCm + w });
+      boxes.push_back({ -w, 0.0f, 0.0f, heightCm });
+      boxes.push_back({ widthCm, 0.0f, widthCm + w, heightCm });
+      haveRoom = true;
+    } else if (kw == "box") {
+      boxes.push_back({ std::min(v[0], v[2]), std::min(v[1], v[3]), std::max(v[0], v[2]), std::max(v[1], v[3]) });
+    } else if (kw == "post") {
+      posts.push_back({ v[0], v[1], v[2] });
+    } else {
+      startX = v[0];
+      startY = v[1];
+      startDeg = v[2];
+    }
+  }
+
+  if (!haveRoom) { err = "missing 'room'"; return false; }
+  float sx = startX, sy = startY;
+  if (resolve(sx, sy, SIM_ROBOT_R_CM)) { err = "start overlaps an obstacle"; return false; }
+  return true;
+}
+
+bool SimWorld::load(const char* path, std::string& err) {
+  std::ifstream f(path);
+  if (!f) { err = "cannot open"; return false; }
+  std::stringstream ss;
+  ss << f.rdbuf();
+
+  std::string base = path;
+  size_t slash = base.find_last_of('/');
+  if (slash != std::string::npos) base.erase(0, slash + 1);
+  size_t dot = base.find_last_of('.');
+  if (dot != std::string::npos) base.erase(dot);
+  name = base;
+  return parse(ss.str(), err);
+}
+
+// ---------------- Metrics ----------------
+void SimMetrics::add(const SimMetrics& o) {
+  runs += o.runs;
+  seconds += o.seconds;
+  avoids += o.avoids;
+  repeats += o.repeats;
+  collisions += o.collisions;
+  stops += o.stops;
+  emergencies += o.emergencies;
+  schedMissed += o.schedMissed;
+  schedFired += o.schedFired;
+  contactS += o.contactS;
+  fwdCm += o.fwdCm;
+  entryDutySum += o.entryDutySum;
+  areaM2 += o.areaM2;
+  freeAreaM2 += o.freeAreaM2;
+  drErrCm += o.drErrCm;
+}
+
+// Gövdenin süpürdüğü 5 cm hücreler
+class SimAreaGrid {
+private:
+  int nx, ny;
+  std::vector<uint8_t> seen;
+  uint32_t count = 0, freeCount = 0;
+
+public:
+  explicit SimAreaGrid(const SimWorld& w)
+    : nx((int)ceilf(w.widthCm / SIM_AREA_CELL_CM)), ny((int)ceilf(w.heightCm / SIM_AREA_CELL_CM)),
+      seen((size_t)nx * ny, 0) {
+    for (int j = 0; j < ny; j++)
+      for (int i = 0; i < nx; i++)
+        if (!w.inside((i + 0.5f) * SIM_AREA_CELL_CM, (j + 0.5f) * SIM_AREA_CELL_CM)) freeCount++;
+  }
+
+  void mark(float x, float y, float r) {
+    int i0 = std::max(0, (int)((x - r) / SIM_AREA_CELL_CM)), i1 = std::min(nx - 1, (int)((x + r) / SIM_AREA_CELL_CM));
+    int j0 = std::max(0, (int)((y - r) / SIM_AREA_CELL_CM)), j1 = std::min(ny - 1, (int)((y + r) / SIM_AREA_CELL_CM));
+    for (int j = j0; j <= j1; j++) {
+      for (int i = i0; i <= i1; i++) {
+        float cx = (i + 0.5f) * SIM_AREA_CELL_CM - x, cy = (j + 0.5f) * SIM_AREA_CELL_CM - y;
+        if (cx * cx + cy * cy > r * r) continue;
+        uint8_t& s = seen[(size_t)j * nx + i];
+        if (!s) { s = 1; count++; }
+      }
+    }
+  }
+
+  double areaM2() const { return count * (double)SIM_AREA_CELL_CM * SIM_AREA_CELL_CM * 1e-4; }
+  double freeM2() const { return freeCount * (double)SIM_AREA_CELL_CM * SIM_AREA_CELL_CM * 1e-4; }
+};
+
+// ---------------- Run ----------------
+SimMetrics simRun(const SimWorld& world, const SimConfig& cfg) {
+  hostReset();
+  hostBoard().nowUs = cfg.startMs * 1000ULL + 1;
+  randomSeed(cfg.seed);
+
+  struct Truth { float x, y, th; };
+  Truth truth = { world.startX, world.startY, wrapAngle(world.startDeg * (float)DEG_TO_RAD) };
+  const Truth start = truth;
+
+  // Sensör gürültüsü firmware'in random()'undan ayrı: aynı tohumda davranış farkı sadece modelden
+  std::mt19937 noise(cfg.seed * 2654435761u + 1u);
+  std::normal_distribution<float> gauss(0.0f, 1.0f);
+  std::uniform_real_distribution<float> uni(0.0f, 1.0f);
+  const SimSonar& so = cfg.sonar;
+  const float cosSpecular = cosf(so.specularDeg * (float)DEG_TO_RAD);
+
+  hostBoard().sonarRangeCm = [&]() {
+    float sx = truth.x + SIM_ROBOT_R_CM * cosf(truth.th), sy = truth.y + SIM_ROBOT_R_CM * sinf(truth.th);
+    float d = so.maxCm;
+    for (int k = -2; k <= 2; k++) {
+      float hd, ci;
+      if (!world.rayCast(sx, sy, truth.th + k * 0.5f * so.beamHalf, so.maxCm, hd, ci)) continue;
+      if (so.specularDeg < 90.0f && ci < cosSpecular) continue;   // yankı başka yöne
+      d = std::min(d, hd);
+    }
+    if (d >= so.maxCm) return -1.0f;   // zaman aşımı
+    if (so.dropout > 0.0f && uni(noise) < so.dropout) return -1.0f;
+    if (so.noiseCm > 0.0f || so.noisePct > 0.0f) d += gauss(noise) * (so.noiseCm + 0.01f * so.noisePct * d);
+    return std::max(2.0f, d);
+  };
+
+  Rig rig;
+  rig.brain.setNavTuning(cfg.nav);
+  rig.brain.setAvoidPlanner(cfg.planner);
+  rig.brain.getGovernor().set(GOV_ENABLE, cfg.governor ? 1 : 0);
+  rig.brain.handleCommand("otonom");
+
+  SimAreaGrid area(world);
+  area.mark(truth.x, truth.y, SIM_ROBOT_R_CM);
+  float markX = truth.x, markY = truth.y;
+
+  SimMetrics m;
+  double lastL = hostBoard().wheel[0].counts, lastR = hostBoard().wheel[1].counts;
+  long lastAvoidEnd = -100000, freeSteps = SIM_CONTACT_GAP_STEPS, contactSteps = 0;
+  bool wasAvoid = false, moving = false;
+  int prevDutyL = 0, prevDutyR = 0;
+
+  const long steps = (long)(cfg.seconds * 1e6 / SIM_STEP_US);
+  for (long i = 0; i < steps; i++) {
+    hostAdvanceUs(SIM_STEP_US);
+    rig.step();
+
+    // Plant: tekerlek sayımlarından diferansiyel sürüş kinematiği
+    double l = hostBoard().wheel[0].counts, r = hostBoard().wheel[1].counts;
+    float dl = (float)(l - lastL) * POSE_MM_PER_COUNT * 0.1f, dr = (float)(r - lastR) * POSE_MM_PER_COUNT * 0.1f;
+    lastL = l; lastR = r;
+
+    float ds = 0.5f * (dl + dr), dth = (dr - dl) / (POSE_WHEEL_BASE_MM * 0.1f);
+    float nx = truth.x + ds * cosf(truth.th + 0.5f * dth), ny = truth.y + ds * sinf(truth.th + 0.5f * dth);
+    truth.th = wrapAngle(truth.th + dth);
+    float ox = truth.x, oy = truth.y;
+    bool blocked = world.resolve(nx, ny, SIM_ROBOT_R_CM);
+    truth.x = nx;
+    truth.y = ny;
+    if (ds > 0) m.fwdCm += (truth.x - ox) * cosf(truth.th) + (truth.y - oy) * sinf(truth.th);
+
+    // Sürtünme titremesi tek temas sayılsın: 0.5 s temassız kalınca temas biter
+    if (blocked) {
+      if (freeSteps >= SIM_CONTACT_GAP_STEPS) m.collisions++;
+      freeSteps = 0;
+      contactSteps++;
+    } else if (freeSteps < SIM_CONTACT_GAP_STEPS) {
+      freeSteps++;
+    }
+
+    bool avoid = rig.brain.getState() == AVOIDING;
+    if (avoid && !wasAvoid) {
+      m.avoids++;
+      m.entryDutySum += 0.5 * (prevDutyL + prevDutyR);   // kaçışa hangi hızla girildi
+      if (i - lastAvoidEnd < SIM_REPEAT_STEPS) m.repeats++;
+    }
+    if (!avoid && wasAvoid) lastAvoidEnd = i;
+    wasAvoid = avoid;
+
+    // Dur-kalk: ileri/geri hareketten (>40 duty) tam duruşa
+    int dutyL = rig.motor.getCurrentLeft(), dutyR = rig.motor.getCurrentRight();
+    if (!moving && (abs(dutyL) > 40 || abs(dutyR) > 40)) moving = true;
+    if (moving && dutyL == 0 && dutyR == 0) { moving = false; m.stops++; }
+    prevDutyL = dutyL;
+    prevDutyR = dutyR;
+
+    if (fabsf(truth.x - markX) + fabsf(truth.y - markY) >= 1.0f) {
+      area.mark(truth.x, truth.y, SIM_ROBOT_R_CM);
+      markX = truth.x;
+      markY = truth.y;
+    }
+  }
+
+  // Dead-reckoning pozunu dünya çerçevesine taşı, gerçek ile karşılaştır
+  const Pose& p = rig.brain.getPose();
+  float wx = start.x + p.xCm * cosf(start.th) - p.yCm * sinf(start.th);
+  float wy = start.y + p.xCm * sinf(start.th) + p.yCm * cosf(start.th);
+
+  m.runs = 1;
+  m.seconds = steps * (SIM_STEP_US * 1e-6);
+  m.contactS = contactSteps * (SIM_STEP_US * 1e-6);
+  m.emergencies = rig.brain.getGovernor().getStats().emergencies;
+  m.schedMissed = rig.brain.getScheduler().getMissedTotal();
+  m.schedFired = rig.brain.getScheduler().getWheelStats().fired;
+  m.areaM2 = area.areaM2();
+  m.freeAreaM2 = area.freeM2();
+  m.drErrCm = sqrtf((wx - truth.x) * (wx - truth.x) + (wy - truth.y) * (wy - truth.y));
+  hostBoard().sonarRangeCm = nullptr;
+  return m;
+}
+
+std::vector<SimMetrics> simRunAll(const std::vector<SimJob>& jobs, unsigned threads) {
+  std::vector<SimMetrics> out(jobs.size());
+  if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+  threads = std::min<unsigned>(threads, std::max<size_t>(1, jobs.size()));
+
+  // HostBoard thread_local: her işçi kendi sanal kartında, sırayla iş çeker
+  std::atomic<size_t> next{0};
+  auto worker = [&]() {
+    hostBoard().serialEcho = false;
+    for (size_t i = next++; i < jobs.size(); i = next++) out[i] = simRun(*jobs[i].world, jobs[i].cfg);
+  };
+
+  std::vector<std::thread> pool;
+  for (unsigned t = 1; t < threads; t++) pool.emplace_back(worker);
+  worker();
+  for (std::thread& t : pool) t.join();
+  return out;
+}
+
+// ---------------- Parameters ----------------
+struct SimParam {
+  const char* name;
+  void (*set)(SimConfig&, float);
+};
+
+static const SimParam SIM_PARAMS[] = {
+  { "planner",             [](SimConfig& c, float v) { c.planner = v != 0.0f; } },
+  { "governor",            [](SimConfig& c, float v) { c.governor = v != 0.0f; } },
+  { "auto_obs_enter",      [](SimConfig& c, float v) { c.nav.autoObsEnter = v; } },
+  { "auto_obs_exit",       [](SimConfig& c, float v) { c.nav.autoObsExit = v; } },
+  { "avoid_early_clear",   [](SimConfig& c, float v) { c.nav.avoidEarlyClear = v; } },
+  { "avoid_turn_lead",     [](SimConfig& c, float v) { c.nav.avoidTurnLead = v; } },
+  { "avoid_pause_ms",      [](SimConfig& c, float v) { c.nav.avoidPauseMs = (uint16_t)v; } },
+  { "avoid_back_ms",       [](SimConfig& c, float v) { c.nav.avoidBackMs = (uint16_t)v; } },
+  { "avoid_back_short_ms", [](SimConfig& c, float v) { c.nav.avoidBackShortMs = (uint16_t)v; } },
+  { "avoid_turn_min_ms",   [](SimConfig& c, float v) { c.nav.avoidTurnMinMs = (uint16_t)v; } },
+  { "avoid_turn_max_ms",   [](SimConfig& c, float v) { c.nav.avoidTurnMaxMs = (uint16_t)v; } },
+  { "avoid_scan_max_ms",   [](SimConfig& c, float v) { c.nav.avoidScanMaxMs = (uint16_t)v; } },
+  { "avoid_settle_ms",     [](SimConfig& c, float v) { c.nav.avoidSettleMs = (uint16_t)v; } },
+  { "avoid_duty",          [](SimConfig& c, float v) { c.nav.avoidDuty = (int16_t)v; } },
+  { "sonar_max_cm",        [](SimConfig& c, float v) { c.sonar.maxCm = v; } },
+  { "sonar_noise_cm",      [](SimConfig& c, float v) { c.sonar.noiseCm = v; } },
+  { "sonar_noise_pct",     [](SimConfig& c, float v) { c.sonar.noisePct = v; } },
+  { "sonar_dropout",       [](SimConfig& c, float v) { c.sonar.dropout = v; } },
+  { "sonar_specular_deg",  [](SimConfig& c, float v) { c.sonar.specularDeg = v; } },
+};
+
+bool simSetParam(SimConfig& cfg, const char* name, float value) {
+  for (const SimParam& p : SIM_PARAMS) {
+    if (strcmp(p.name, name) == 0) { p.set(cfg, value); return true; }
+  }
+  return false;
+}
+
+// ---------------- CLI ----------------
+struct SimSetting { std::string name; float value; };
+
+struct SimVariant {
+  std::string label;
+  std::vector<SimSetting> settings;
+};
+
+static void simUsage() {
+  fprintf(stderr,
+    "usage: program sim [--seeds N] [--minutes M] [--threads T] [--start-ms MS]\n"
+    "                   [--set name=value]... [--sweep name=v1,v2,...]... [map.map ...]\n"
+    "maps default to sim/maps/*.map; --sweep lists are crossed;\n"
+    "--start-ms sets the host clock (4294907296: millis() wraps 60 s in); parameters:\n");
+  for (const SimParam& p : SIM_PARAMS) fprintf(stderr, "  %s\n", p.name);
+}
+
+// "name=v1,v2" -> ayarlar; ad bilinmiyorsa false
+static bool simParseSetting(const char* arg, std::string& name, std::vector<float>& values) {
+  const char* eq = strchr(arg, '=');
+  if (!eq) return false;
+  name.assign(arg, eq - arg);
+  SimConfig probe;
+  if (!simSetParam(probe, name.c_str(), 0.0f)) return false;
+  std::stringstream ss(eq + 1);
+  std::string item;
+  while (std::getline(ss, item, ',')) values.push_back(strtof(item.c_str(), nullptr));
+  return !values.empty();
+}
+
+static std::vector<std::string> simDefaultMaps() {
+  std::vector<std::string> paths;
+  if (DIR* d = opendir("sim/maps")) {
+    while (dirent* e = readdir(d)) {
+      std::string n = e->d_name;
+      if (n.size() > 4 && n.compare(n.size() - 4, 4, ".map") == 0) paths.push_back("sim/maps/" + n);
+    }
+    closedir(d);
+  }
+  std::sort(paths.begin(), paths.end());
+  return paths;
+}
+
+static std::string simFormatValue(float v) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "%g", v);
+  return buf;
+}
+
+int simMain(int argc, char** argv) {
+  int seeds = 8;
+  double minutes = 5.0;
+  unsigned threads = 0;
+  uint64_t startMs = 0;
+  SimVariant base;
+  std::vector<SimVariant> variants(1);
+  std::vector<std::string> mapPaths;
+
+  for (int i = 0; i < argc; i++) {
+    std::string a = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (a == "--seeds" && hasValue) seeds = std::max(1, atoi(argv[++i]));
+    else if (a == "--minutes" && hasValue) minutes = std::max(0.1, atof(argv[++i]));
+    else if (a == "--threads" && hasValue) threads = (unsigned)std::max(0, atoi(argv[++i]));
+    else if (a == "--start-ms" && hasValue) startMs = strtoull(argv[++i], nullptr, 0);
+    else if ((a == "--set" || a == "--sweep") && hasValue) {
+      std::string name;
+      std::vector<float> values;
+      if (!simParseSetting(argv[++i], name, values) || (a == "--set" && values.size() != 1)) {
+        fprintf(stderr, "sim: bad %s '%s'\n", a.c_str(), argv[i]);
+        simUsage();
+        return 2;
+      }
+      if (a == "--set") { base.settings.push_back({ name, values[0] }); continue; }
+      // Çapraz çarpım: mevcut her varyant x bu listenin her değeri
+      std::vector<SimVariant> crossed;
+      for (const SimVariant& v : variants) {
+        for (float x : values) {
+          SimVariant n = v;
+          n.label += (n.label.empty() ? "" : ",") + name + "=" + simFormatValue(x);
+          n.settings.push_back({ name, x });
+          crossed.push_back(n);
+        }
+      }
+      variants.swap(crossed);
+    }
+    else if (a == "-h" || a == "--help") { simUsage(); return 0; }
+    else if (a.compare(0, 2, "--") == 0) { fprintf(stderr, "sim: unknown option '%s'\n", a.c_str()); simUsage(); return 2; }
+    else mapPaths.push_back(a);
+  }
+  if (mapPaths.empty()) mapPaths = simDefaultMaps();
+  if (mapPaths.empty()) { fprintf(stderr, "sim: no maps (run from the project root or pass .map files)\n"); return 2; }
+
+  std::vector<SimWorld> worlds(mapPaths.size());
+  for (size_t m = 0; m < mapPaths.size(); m++) {
+    std::string err;
+    if (!worlds[m].load(mapPaths[m].c_str(), err)) {
+      fprintf(stderr, "sim: %s: %s\n", mapPaths[m].c_str(), err.c_str());
+      return 2;
+    }
+  }
+
+  // Aynı tohumlar her varyantta: farklar eşleştirilmiş kıyas
+  std::vector<SimJob> jobs;
+  for (const SimWorld& w : worlds) {
+    for (const SimVariant& v : variants) {
+      for (int k = 0; k < seeds; k++) {
+        SimJob j = { &w, SimConfig() };
+        j.cfg.seconds = minutes * 60.0;
+        j.cfg.seed = 1000u + (uint32_t)k;
+        j.cfg.startMs = startMs;
+        for (const SimSetting& s : base.settings) simSetParam(j.cfg, s.name.c_str(), s.value);
+        for (const SimSetting& s : v.settings) simSetParam(j.cfg, s.name.c_str(), s.value);
+        jobs.push_back(j);
+      }
+    }
+  }
+
+  if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+  auto t0 = std::chrono::steady_clock::now();
+  std::vector<SimMetrics> results = simRunAll(jobs, threads);
+  double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  double simS = 0.0;
+  size_t idx = 0;
+  for (const SimWorld& w : worlds) {
+    for (const SimVariant& v : variants) {
+      SimMetrics s;
+      for (int k = 0; k < seeds; k++) s.add(results[idx++]);
+      simS += s.seconds;
+      printf("{\"suite\":\"sim\",\"map\":\"%s\",\"case\":\"%s\",\"runs\":%u,\"minutes\":%.1f,"
+             "\"collisions_per_hour\":%.1f,\"avoid_per_min\":%.2f,\"area_m2_per_min\":%.3f,\"coverage_pct\":%.1f,"
+             "\"repeat_pct\":%.1f,\"fwd_cm_s\":%.1f,\"stops_per_min\":%.1f,\"avoid_entry_duty\":%.0f,"
+             "\"emergencies_per_min\":%.2f,\"contact_pct\":%.2f,\"dr_err_cm\":%.1f}\n",
+             w.name.c_str(), v.label.empty() ? "base" : v.label.c_str(), (unsigned)s.runs, minutes,
+             s.collisionsPerHour(), s.perMin(s.avoids), s.perMin(s.areaM2), s.coveragePct(),
+             s.avoids ? 100.0 * s.repeats / s.avoids : 0.0, s.fwdCm / s.seconds, s.perMin(s.stops),
+             s.avoids ? s.entryDutySum / s.avoids : 0.0, s.perMin(s.emergencies),
+             100.0 * s.contactS / s.seconds, s.drErrCm / s.runs);
+      fflush(stdout);
+    }
+  }
+
+  printf("{\"suite\":\"sim\",\"case\":\"throughput\",\"jobs\":%u,\"threads\":%u,\"sim_hours\":%.2f,"
+         "\"wall_s\":%.2f,\"realtime_x\":%.0f}\n",
+         (unsigned)jobs.size(), threads, simS / 3600.0, wallS, wallS > 0.0 ? simS / wallS : 0.0);
+  return 0;
+}
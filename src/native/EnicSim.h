@@ -0,0 +1,120 @@
+/**
+ * @file EnicSim.h
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Closed-loop virtual world: diff-drive plant, ray-cast sonar, map files, parallel sweeps
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ *
+ * Firmware (Rig) değiştirilmeden host saatinde koşar: gerçek poz host motor modelinin tekerlek
+ * sayımlarından, sonar gerçek pozdan koni içinde ışın atarak (gürültü, echo kaybı, yatık yüzeyden
+ * dönmeyen yankı). Temasta gövde engelden dışarı itilir ama tekerlek sayımı sürer.
+ * Harita dosyaları (sim/maps/ altında .map), birimler cm / derece:
+ *   room 400 300            # dış duvarlar: 0..400 x 0..300
+ *   box 120 80 160 120      # x0 y0 x1 y1
+ *   post 200 150 1.5        # cx cy r (masa / sandalye ayağı)
+ *   start 40 40 17          # x y yön
+ */
+#ifndef ENIC_SIM_H
+#define ENIC_SIM_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "EnicState.h"
+
+struct SimBox  { float x0, y0, x1, y1; };
+struct SimPost { float cx, cy, r; };
+
+struct SimWorld {
+  std::string name;
+  float widthCm = 0.0f, heightCm = 0.0f;
+  std::vector<SimBox> boxes;      // dış duvarlar dahil
+  std::vector<SimPost> posts;
+  float startX = 40.0f, startY = 40.0f, startDeg = 0.0f;
+
+  // En yakın yüzey: mesafe ve geliş açısının kosinüsü (1: dik); isabet yoksa false
+  bool rayCast(float x, float y, float a, float maxCm, float& dist, float& cosInc) const;
+  // Daireyi engellerden dışarı it (kenar boyunca kayma); temas varsa true
+  bool resolve(float& x, float& y, float r) const;
+  bool inside(float x, float y) const;
+
+  // Metin haritası; hata varsa err = "satır: neden"
+  bool parse(const std::string& text, std::string& err);
+  bool load(const char* path, std::string& err);
+};
+
+// HC-SR04 modeli. Varsayılanlar gerçekçi; avoid_sim kıyas için ideal() kullanır.
+struct SimSonar {
+  float maxCm = 300.0f;        // ötesi zaman aşımı
+  float noiseCm = 0.5f;        // sigma = noiseCm + noisePct% x mesafe
+  float noisePct = 1.0f;
+  float dropout = 0.02f;       // ping başına echo kaybı olasılığı
+  float specularDeg = 65.0f;   // normale bu açıdan yatık yüzey yankı vermez (90: kapalı)
+  float beamHalf = 0.26f;      // koni yarı açısı (rad), 5 ışın
+
+  static SimSonar ideal() {
+    SimSonar s;
+    s.noiseCm = s.noisePct = s.dropout = 0.0f;
+    s.specularDeg = 90.0f;
+    return s;
+  }
+};
+
+struct SimConfig {
+  bool planner = true;         // false: rastgele kaçış
+  bool governor = true;        // false: sabit AUTO hızı
+  NavTuning nav;
+  SimSonar sonar;
+  double seconds = 300.0;
+  uint32_t seed = 1000;
+  uint64_t startMs = 0;        // host saatinin başlangıcı: sarma öncesinden başlatıp rollover denenir
+};
+
+// Ham toplamlar: koşular add() ile birleşir, oranlar en sonda
+struct SimMetrics {
+  uint32_t runs = 0;
+  double seconds = 0.0;
+  uint32_t avoids = 0;
+  uint32_t repeats = 0;        // kaçış bittikten sonra 2 s içinde yine engel
+  uint32_t collisions = 0;     // temas olayı (0.5 s temassız kalınca biter)
+  uint32_t stops = 0;          // hareketten tam duruşa
+  uint32_t emergencies = 0;    // governor acil durdurması
+  uint32_t schedMissed = 0;    // scheduler'da kaçırılan vade
+  uint32_t schedFired = 0;
+  double contactS = 0.0;
+  double fwdCm = 0.0;
+  double entryDutySum = 0.0;   // kaçışa girişteki ortalama duty, toplam
+  double areaM2 = 0.0;         // gövdenin süpürdüğü tekil alan
+  double freeAreaM2 = 0.0;     // haritadaki boş alan
+  double drErrCm = 0.0;        // koşu sonunda dead-reckoning hatası, toplam
+
+  void add(const SimMetrics& o);
+
+  double perMin(double v) const { return seconds > 0.0 ? v * 60.0 / seconds : 0.0; }
+  double collisionsPerHour() const { return seconds > 0.0 ? collisions * 3600.0 / seconds : 0.0; }
+  double coveragePct() const { return freeAreaM2 > 0.0 ? 100.0 * areaM2 / freeAreaM2 : 0.0; }
+};
+
+// Tek koşu, çağıran iş parçacığında (HostBoard'u sıfırlar)
+SimMetrics simRun(const SimWorld& world, const SimConfig& cfg);
+
+struct SimJob {
+  const SimWorld* world;
+  SimConfig cfg;
+};
+
+// İşleri 'threads' iş parçacığına dağıt (0: tüm çekirdekler); sonuç jobs sırasıyla
+std::vector<SimMetrics> simRunAll(const std::vector<SimJob>& jobs, unsigned threads);
+
+// Taranabilir parametre adları (nav, sonar, planner/governor): "auto_obs_enter" vb.
+bool simSetParam(SimConfig& cfg, const char* name, float value);
+
+// Yerleşik parkur (sim/maps/course.map ile aynı): bench çalışma dizininden bağımsız
+extern const char* const SIM_COURSE_MAP;
+
+// program sim [seçenekler] [harita ...]
+int simMain(int argc, char** argv);
+
+#endif
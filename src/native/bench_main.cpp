@@ -0,0 +1,1615 @@
+/**
+ * @file bench_main.cpp
+ * @authors Sertac ALAN & Kaan GUNER
+ * @brief Host microbenchmark suite for render and control paths (native env)
+ * @version 1.0
+ * @date 2026-02-10
+ * @copyright Copyright (c) 2026
+ *
+ * Çıktı: satır başına bir JSON kaydı (JSON Lines), ör.
+ *   {"suite":"face_draw","case":"NORMAL","iters":20000,"ns_per_op":812.4,"bytes":0}
+ * Kullanım: .pio/build/native/program [suite ...] > bench.jsonl
+ *           .pio/build/native/program serve <tty> [saniye]   (tools/enic_link.py bench)
+ *           .pio/build/native/program sim [seçenekler] [harita ...]   (EnicSim.cpp)
+ */
+#include <Arduino.h>
+#include <EnicHost.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "EnicMotor.h"
+#include "EnicFace.h"
+#include "EnicSense.h"
+#include "EnicState.h"
+#include "EnicRangeFilter.h"
+#include "EnicCommand.h"
+#include "EnicProtocol.h"
+#include "EnicSerialLink.h"
+#include "EnicQueue.h"
+#include "EnicTasks.h"
+#include "EnicRecorder.h"
+#include "EnicScheduler.h"
+#include "EnicPower.h"
+#include "EnicParams.h"
+#include "EnicTime.h"
+
+#include "EnicRig.h"
+#include "EnicSim.h"
+
+static const char* const FACE_NAMES[FACE_COUNT] = {
+  "NORMAL", "BLINK", "DEAD", "TONGUE", "LISTEN", "SPEAK", "SHOCK", "SNEAKY", "CRY", "FEAR"
+};
+
+static std::vector<std::string> selected;
+
+static bool wants(const char* suite) {
+  if (selected.empty()) return true;
+  for (const std::string& s : selected) if (s == suite) return true;
+  return false;
+}
+
+// Doğruluk kontrolleri: ölçüm satırı yine basılır, hata stderr'e ve çıkış kodu 1
+static int failures = 0;
+
+static bool expect(bool ok, const char* suite, const char* what) {
+  if (!ok) { fprintf(stderr, "FAIL %s: %s\n", suite, what); failures++; }
+  return ok;
+}
+
+static double wallNs() {
+  return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Derleyicinin ölçülen işi atmaması için
+static volatile uint32_t sink;
+
+// ---------------- Render ----------------
+static void benchFaceDraw() {
+  EnicFace face;
+  face.begin();
+  face.setFrameRate(0);   // çizim maliyeti: compositor slotu yok
+
+  const int iters = 20000;
+  for (int t = 0; t < FACE_COUNT; t++) {
+    face.draw(NORMAL);
+    face.render();
+    face.resetFlushStats();
+    face.draw((FaceType)t);
+    face.render();
+    uint32_t bytes = face.getFlushStats().lastBytes; // NORMAL -> t geçişi
+
+    double t0 = wallNs();
+    for (int i = 0; i < iters; i++) { face.draw((FaceType)t); face.render(); }
+    double ns = (wallNs() - t0) / iters;
+
+    printf("{\"suite\":\"face_draw\",\"case\":\"%s\",\"iters\":%d,\"ns_per_op\":%.1f,\"bytes_from_normal\":%lu}\n",
+           FACE_NAMES[t], iters, ns, (unsigned long)bytes);
+  }
+}
+
+// ---------------- Face atlas ----------------
+// Atlas öncesi EnicFace::draw(): GFX primitifleriyle aynı sıra (referans)
+static void drawFacePrimitives(Adafruit_SSD1306& display, FaceType type) {
+  display.clearDisplay();
+
+  int lx = 40, rx = 88, y = 25, r = 8;
+  int mx = 64, my = 50;
+
+  // ---- EYES ----
+  if (type == DEAD) {
+    display.drawLine(lx-6,y-6,lx+6,y+6,1); display.drawLine(lx+6,y-6,lx-6,y+6,1);
+    display.drawLine(rx-6,y-6,rx+6,y+6,1); display.drawLine(rx+6,y-6,rx-6,y+6,1);
+  }
+  else if (type == BLINK) {
+    display.fillRect(lx-8,y,16,2,1);
+    display.fillRect(rx-8,y,16,2,1);
+  }
+  else if (type == SHOCK) {
+    display.drawCircle(lx,y,r+3,1); display.drawCircle(rx,y,r+3,1);
+    display.fillCircle(lx,y,2,1);   display.fillCircle(rx,y,2,1);
+  }
+  else if (type == TONGUE) {
+    display.fillCircle(lx,y,r,1);
+    display.fillCircle(lx+2,y-2,2,0);
+    display.fillRect(rx-8,y,16,3,1);
+  }
+  else if (type == SNEAKY) {
+    display.fillCircle(lx,y,r,1); display.fillCircle(rx,y,r,1);
+    display.fillRect(lx-10,y-10,20,8,0);
+    display.fillRect(rx-10,y-10,20,8,0);
+  }
+  else if (type == LISTEN) {
+    display.fillCircle(lx,y,r,1); display.fillCircle(rx,y,r,1);
+    display.fillCircle(lx+2,y-1,3,0); display.fillCircle(rx+2,y-1,3,0);
+    display.drawLine(lx-10,y-12,lx+6,y-10,1);
+    display.drawLine(rx-6,y-10,rx+10,y-12,1);
+  }
+  else if (type == SPEAK) {
+    display.fillCircle(lx,y,r,1); display.fillCircle(rx,y,r,1);
+    display.fillCircle(lx+2,y-2,2,0); display.fillCircle(rx-2,y-2,2,0);
+  }
+  else if (type == FEAR) {
+    display.drawCircle(lx,y,r+4,1); display.drawCircle(rx,y,r+4,1);
+    display.fillCircle(lx,y,2,1);   display.fillCircle(rx,y,2,1);
+    display.drawLine(lx-10,y-14,lx+2,y-10,1);
+    display.drawLine(rx-2,y-10,rx+10,y-14,1);
+  }
+  else if (type == CRY) {
+    display.fillCircle(lx,y,r,1); display.fillCircle(rx,y,r,1);
+    display.fillCircle(lx+2,y+2,2,0); display.fillCircle(rx-2,y+2,2,0);
+    display.drawLine(lx+6,y+6,lx+6,y+16,1);
+    display.drawLine(rx-6,y+6,rx-6,y+16,1);
+  }
+  else {
+    // NORMAL
+    display.fillCircle(lx,y,r,1); display.fillCircle(rx,y,r,1);
+    display.fillCircle(lx+2,y-2,2,0); display.fillCircle(rx-2,y-2,2,0);
+  }
+
+  // ---- MOUTH ----
+  if (type == DEAD) {
+    display.drawLine(mx-10,my+5,mx+10,my-5,1);
+  }
+  else if (type == TONGUE) {
+    display.fillCircle(mx,my-2,8,1);
+    display.fillRect(mx-10,my-12,20,10,0);
+    display.fillCircle(mx+2,my+5,4,1);
+    display.drawLine(mx+2,my+3,mx+2,my+7,0);
+  }
+  else if (type == SHOCK || type == SPEAK) {
+    display.fillCircle(mx,my+2,6,1);
+  }
+  else if (type == LISTEN) {
+    display.fillRect(mx-8,my+2,16,2,1);
+  }
+  else if (type == FEAR) {
+    display.drawCircle(mx,my+3,5,1);
+  }
+  else if (type == CRY) {
+    display.drawLine(mx-10,my+6,mx+10,my+6,1);
+    display.drawLine(mx-10,my+6,mx-6,my+2,1);
+    display.drawLine(mx+10,my+6,mx+6,my+2,1);
+  }
+  else if (type == SNEAKY) {
+    display.fillRect(mx-10,my,20,2,1);
+  }
+  else {
+    // normal kapalı ağız
+    display.fillCircle(mx,my-2,8,1);
+    display.fillRect(mx-10,my-12,20,10,0);
+  }
+}
+
+// Piksel kimliği: her yüz için blitFace() == primitif çizim (host GFX), bayt bayt
+static void benchAtlas() {
+  Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT);
+  display.begin();
+  static uint8_t fb[EnicDisplayLink::FRAME_BYTES];
+
+  for (int t = 0; t < FACE_COUNT; t++) {
+    drawFacePrimitives(display, (FaceType)t);
+    memset(fb, 0, sizeof(fb));
+    blitFace(fb, (FaceType)t);
+
+    const uint8_t* ref = display.getBuffer();
+    int diffBytes = 0, first = -1;
+    uint32_t pixels = 0;
+    for (int i = 0; i < EnicDisplayLink::FRAME_BYTES; i++) {
+      pixels += (uint32_t)__builtin_popcount(ref[i]);
+      if (ref[i] != fb[i]) { diffBytes++; if (first < 0) first = i; }
+    }
+    bool identical = memcmp(ref, fb, sizeof(fb)) == 0;
+    printf("{\"suite\":\"atlas\",\"case\":\"%s\",\"identical\":%s,\"diff_bytes\":%d,\"first_diff_x\":%d,"
+           "\"first_diff_page\":%d,\"pixels\":%lu}\n",
+           FACE_NAMES[t], identical ? "true" : "false", diffBytes, first < 0 ? -1 : first % SCREEN_WIDTH,
+           first < 0 ? -1 : first / SCREEN_WIDTH, (unsigned long)pixels);
+    char what[64];
+    snprintf(what, sizeof(what), "blitFace(%s) differs from the primitive drawing", FACE_NAMES[t]);
+    expect(identical, "atlas", what);
+  }
+}
+
+static void benchBombScene() {
+  EnicFace face;
+  face.begin();
+  face.setFrameRate(0);   // çizim maliyeti: compositor slotu yok
+
+  // SHOW_BOMB ile aynı faz sınırları (ms)
+  static const unsigned long phaseStart[4] = {0, 5000, 7000, 12000};
+  static const unsigned long phaseLen[4]   = {5000, 2000, 5000, 18000};
+  const int framesPerPhase = 4000;
+
+  for (uint8_t ph = 0; ph < 4; ph++) {
+    face.resetFlushStats();
+    double t0 = wallNs();
+    for (int i = 0; i < framesPerPhase; i++) {
+      unsigned long p = (phaseLen[ph] * (unsigned long)i) / framesPerPhase;
+      uint8_t progress = (uint8_t)((p * 255UL) / phaseLen[ph]);
+      face.drawBombScene(ph, progress, phaseStart[ph] + p);
+      face.render();
+    }
+    double ns = (wallNs() - t0) / framesPerPhase;
+    const EnicDisplayLink::FlushStats st = face.getFlushStats();
+
+    printf("{\"suite\":\"bomb_scene\",\"case\":\"phase%u\",\"iters\":%d,\"ns_per_frame\":%.1f,\"bytes_per_frame\":%.1f}\n",
+           (unsigned)ph, framesPerPhase, ns, (double)st.bytesSent / framesPerPhase);
+  }
+}
+
+// ---------------- Control ----------------
+static void benchFsmUpdate() {
+  struct Case { const char* name; const char* cmd; float obstacleCm; };
+  static const Case cases[] = {
+    {"IDLE",   "dur",    -1.0f},
+    {"AUTO",   "otonom", -1.0f},
+    {"AVOID",  "otonom", 15.0f},  // sürekli engel -> AUTO/AVOIDING döngüsü
+    {"MANUAL", "ileri",  -1.0f},
+    {"DANCE",  "dans",   -1.0f},
+    {"BOMB",   "bomb",   -1.0f},
+  };
+
+  const int iters = 20000;          // 2 ms adımla 40 s sanal süre
+  for (const Case& c : cases) {
+    hostReset();
+    float cm = c.obstacleCm;
+    hostBoard().sonarRangeCm = [cm]() { return cm; };
+
+    Rig rig;
+    rig.brain.handleCommand(c.cmd);
+
+    double t0 = wallNs();
+    for (int i = 0; i < iters; i++) {
+      hostAdvanceUs(2000);
+      rig.step();
+    }
+    double ns = (wallNs() - t0) / iters;
+
+    const EnicFace::FrameStats fs = rig.face.getFrameStats();
+    printf("{\"suite\":\"fsm_update\",\"case\":\"%s\",\"iters\":%d,\"ns_per_op\":%.1f,\"oled_flushes\":%lu,"
+           "\"frames_requested\":%lu,\"frames_merged\":%lu,\"frames_presented\":%lu}\n",
+           c.name, iters, ns, (unsigned long)rig.face.getFlushStats().flushes,
+           (unsigned long)fs.requested, (unsigned long)fs.merged, (unsigned long)fs.presented);
+  }
+  hostBoard().sonarRangeCm = nullptr;
+}
+
+static void benchHandleCommand() {
+  hostReset();
+  Rig rig;
+
+  static const char* const cmds[] = {
+    "dur", "otonom", "konus", "ileri", "geri", "sol", "sag", "dinle",
+    "sasir", "kork", "agla", "dil", "dans", "  OTONOM ", "bilinmeyen",
+    "ileri 150 800", "sag 120", "ping 40", "ileri x"
+  };
+  const int n = (int)(sizeof(cmds) / sizeof(cmds[0]));
+  const int iters = 200000;
+
+  double t0 = wallNs();
+  for (int i = 0; i < iters; i++) rig.brain.handleCommand(cmds[i % n]);
+  double ns = (wallNs() - t0) / iters;
+
+  printf("{\"suite\":\"handle_command\",\"case\":\"mixed\",\"iters\":%d,\"ns_per_op\":%.1f,\"cmds_per_s\":%.0f}\n",
+         iters, ns, 1e9 / ns);
+
+  // Serial yolu uçtan uca: bayt akışı -> satır okuyucu -> ayrıştırıcı
+  std::string stream;
+  for (int i = 0; i < n; i++) { stream += cmds[i]; stream += "\r\n"; }
+  EnicLineReader reader;
+  const int rounds = 20000;
+  t0 = wallNs();
+  for (int r = 0; r < rounds; r++) {
+    for (char ch : stream) if (reader.feed(ch)) rig.brain.handleCommand(reader.line());
+  }
+  ns = (wallNs() - t0) / ((double)rounds * n);
+
+  printf("{\"suite\":\"handle_command\",\"case\":\"line_reader\",\"iters\":%d,\"ns_per_op\":%.1f,\"cmds_per_s\":%.0f}\n",
+         rounds * n, ns, 1e9 / ns);
+}
+
+// ---------------- Params ----------------
+// Komut maliyeti (metin / JSON set, get, dump) ve JSON havuzu doluluğu; hatalı set'in hiçbir şeyi
+// değiştirmemesi; NVS: set patlaması tek yazmada birleşir, yeniden başlatmada (hostReset'siz yeni Rig)
+// değerler tek okumayla gelir, eski düzen / bozuk blob varsayılana düşer.
+static std::string paramReply(Rig& rig, const char* cmd) {
+  FILE* f = tmpfile();
+  hostBoard().serialFd = fileno(f);
+  rig.brain.handleCommand(cmd);
+  hostBoard().serialFd = -1;
+  std::string out;
+  char buf[1024];
+  size_t n;
+  rewind(f);
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) out.append(buf, n);
+  fclose(f);
+  while (!out.empty() && (out.back() == '\n' || out.back() == '\r')) out.pop_back();
+  return out;
+}
+
+static bool replyOk(const std::string& r) { return r.find("\"ok\":true") != std::string::npos; }
+
+static void benchParams() {
+  hostReset();
+  hostBoard().sonarRangeCm = []() { return 80.0f; };
+  {
+    Rig rig;
+    static const struct { const char* name; const char* cmd; int iters; } cmds[] = {
+      { "set_text",  "set nav.auto_obs_enter 22.5",                              50000 },
+      { "set_json",  "set {\"gov.cruise\":170,\"nav.auto_obs_exit\":31}",        50000 },
+      { "get_one",   "get nav.auto_obs_enter",                                   50000 },
+      { "get_group", "get gov",                                                  20000 },
+      { "dump",      "dump",                                                     2000 },
+    };
+    for (const auto& c : cmds) {
+      std::string reply = paramReply(rig, c.cmd);
+      FILE* sink = fopen("/dev/null", "w");
+      hostBoard().serialFd = fileno(sink);
+      double t0 = wallNs();
+      for (int i = 0; i < c.iters; i++) rig.brain.handleCommand(c.cmd);
+      double ns = (wallNs() - t0) / c.iters;
+      hostBoard().serialFd = -1;
+      fclose(sink);
+      size_t nl = reply.find('\n');
+      printf("{\"suite\":\"params\",\"case\":\"%s\",\"iters\":%d,\"ns_per_op\":%.1f,\"reply_bytes\":%u,\"reply\":%s}\n",
+             c.name, c.iters, ns, (unsigned)reply.size(), nl == std::string::npos ? reply.c_str() : "\"(multi-line)\"");
+    }
+
+    // Hatalı girişler: hiçbiri uygulanmaz (JSON'da yarım set yok); sınır dışı kırpılır
+    int16_t cruise = rig.brain.getGovernor().get(GOV_CRUISE);
+    bool unknown  = !replyOk(paramReply(rig, "set nope 1"));
+    bool partial  = !replyOk(paramReply(rig, "set {\"gov.cruise\":90,\"nope\":1}")) &&
+                    rig.brain.getGovernor().get(GOV_CRUISE) == cruise;
+    bool badJson  = !replyOk(paramReply(rig, "set {\"gov.cruise\":"));
+    bool notNum   = !replyOk(paramReply(rig, "set gov.cruise fast"));
+    bool clamped  = replyOk(paramReply(rig, "set gov.cruise 9999")) && rig.brain.getGovernor().get(GOV_CRUISE) == 255;
+    bool nested   = !replyOk(paramReply(rig, "set {\"gov.cruise\":{\"a\":1}}"));
+    // gov kısayolu: sınır dışı numara ve tek argüman hiçbir şeyi değiştirmez
+    cruise = rig.brain.getGovernor().get(GOV_CRUISE);
+    bool govIndex = paramReply(rig, "gov 99 5").rfind("gov: bad index", 0) == 0;
+    bool govUsage = paramReply(rig, "gov 1").rfind("gov: usage", 0) == 0;
+    bool govKept  = rig.brain.getGovernor().get(GOV_CRUISE) == cruise;
+    bool govTune  = paramReply(rig, "gov 1 200").empty() && rig.brain.getGovernor().get(GOV_CRUISE) == 200 &&
+                    rig.params.get().gov[GOV_CRUISE] == 200;
+    expect(govIndex && govUsage && govKept, "params", "gov shortcut with a bad index or one argument changed state");
+    expect(govTune, "params", "gov <no> <value> did not go through the parameter store");
+    const EnicParams::ParamStats& st = rig.params.getStats();
+    printf("{\"suite\":\"params\",\"case\":\"reject\",\"unknown\":%s,\"atomic_json\":%s,\"bad_json\":%s,\"not_number\":%s,"
+           "\"nested\":%s,\"clamped\":%s,\"rejected\":%lu,\"json_pool\":%u,\"config_bytes\":%u,\"params\":%d}\n",
+           unknown ? "true" : "false", partial ? "true" : "false", badJson ? "true" : "false", notNum ? "true" : "false",
+           nested ? "true" : "false", clamped ? "true" : "false", (unsigned long)st.rejected,
+           (unsigned)ENIC_PARAM_JSON_POOL, (unsigned)sizeof(EnicConfig), PARAM_COUNT);
+  }
+
+  // Kalıcılık: UART'tan 1 ms'de bir set (kısayollar dahil), sonra 3 s sakin
+  hostReset();
+  hostBoard().sonarRangeCm = []() { return 80.0f; };
+  bool serialEcho = hostBoard().serialEcho;
+  hostBoard().serialEcho = false;
+  uint32_t saves = 0, setsSent = 0;
+  {
+    Rig rig;
+    for (int i = 0; i < 40; i++) {
+      char line[48];
+      snprintf(line, sizeof(line), "gov 1 %d\n", 150 + i);
+      hostSerialFeed(line);
+      setsSent++;
+      for (int k = 0; k < 10; k++) { hostAdvanceUs(1000); rig.step(); }
+    }
+    hostSerialFeed("set {\"nav.auto_obs_enter\":24,\"speed.manual\":210}\n");
+    hostSerialFeed("ping 60\n");
+    setsSent += 2;
+    for (int k = 0; k < 3000; k++) { hostAdvanceUs(1000); rig.step(); }
+    saves = rig.params.getStats().saves;
+  }
+
+  static const char* const LOAD[] = { "defaults", "nvs", "stale", "corrupt" };
+  bool restored, binPing;
+  EnicParams::LoadResult reboot;
+  {
+    Rig rig;   // yeniden başlatma: HostBoard::nvs korunur
+    reboot = rig.params.getLoadResult();
+    restored = rig.brain.getNavTuning().autoObsEnter == 24.0f && rig.brain.getGovernor().get(GOV_CRUISE) == 189 &&
+               rig.params.get().manualSpeed == 210 && rig.params.get().pingMs == 60;
+
+    // Binary OP_PING de depodan geçer: 5 ms -> 30 ms tabanı, NVS'e yazılır
+    uint8_t body[4] = { OP_PING, 2 }, wire[PROTO_MAX_WIRE + 2];
+    putU16(body + 2, 5);
+    hostBoard().serialIn.append((const char*)wire, protoBuildFrame(MSG_CMD, 1, body, sizeof(body), wire));
+    for (int k = 0; k < 1500; k++) { hostAdvanceUs(1000); rig.step(); }
+    binPing = rig.params.get().pingMs == 30;
+  }
+  {
+    Rig rig;
+    binPing = binPing && rig.params.get().pingMs == 30;
+  }
+  printf("{\"suite\":\"params\",\"case\":\"persist\",\"sets\":%lu,\"nvs_writes\":%lu,\"reboot\":\"%s\",\"restored\":%s,"
+         "\"binary_ping\":%s,\"blob_bytes\":%u}\n",
+         (unsigned long)setsSent, (unsigned long)saves, LOAD[reboot], restored ? "true" : "false",
+         binPing ? "true" : "false", (unsigned)hostBoard().nvs["enic/cfg"].size());
+
+  // Bozuk blob (değer baytı) ve eski düzen (başlık): ikisi de varsayılanlara
+  std::string good = hostBoard().nvs["enic/cfg"];
+  EnicParams::LoadResult corrupt, stale;
+  bool corruptDefaults, staleDefaults;
+  hostBoard().nvs["enic/cfg"][12] ^= 0x5A;
+  {
+    Rig rig;
+    corrupt = rig.params.getLoadResult();
+    corruptDefaults = rig.brain.getNavTuning().autoObsEnter == NavTuning().autoObsEnter;
+  }
+  hostBoard().nvs["enic/cfg"] = good;
+  hostBoard().nvs["enic/cfg"][0] ^= 0x01;
+  {
+    Rig rig;
+    stale = rig.params.getLoadResult();
+    staleDefaults = rig.params.get().manualSpeed == EnicConfig().manualSpeed;
+  }
+  printf("{\"suite\":\"params\",\"case\":\"bad_blob\",\"corrupt\":\"%s\",\"corrupt_defaults\":%s,\"stale\":\"%s\","
+         "\"stale_defaults\":%s}\n",
+         LOAD[corrupt], corruptDefaults ? "true" : "false", LOAD[stale], staleDefaults ? "true" : "false");
+
+  hostBoard().serialEcho = serialEcho;
+  hostBoard().sonarRangeCm = nullptr;
+}
+
+// ---------------- Range filter ----------------
+// Sentetik izler: 40 ms ping, ±2 cm gürültü, isteğe bağlı echo kaybı / aykırı değer
+struct TraceCfg { const char* name; float from, to; float rateCmS; int dropEvery; int spikeEvery; };
+
+static float traceTruth(const TraceCfg& c, float tS) {
+  if (c.rateCmS == 0.0f) return tS < 1.0f ? c.from : c.to;      // basamak t=1 s
+  float d = c.from - c.rateCmS * tS;
+  return d < c.to ? c.to : d;
+}
+
+// Önceki EnicSense: 2 okumanın ortalaması + EMA(0.45), 999 dahil
+struct LegacyEma {
+  float v = 999.0f; bool init = false;
+  float push(float d) { if (!init) { v = d; init = true; } else v = 0.45f * d + 0.55f * v; return v; }
+};
+
+static void benchRangeFilter() {
+  // Örnek başına maliyet
+  {
+    EnicRangeFilter f;
+    const int iters = 2000000;
+    uint32_t rng = 1;
+    double t0 = wallNs();
+    for (int i = 0; i < iters; i++) {
+      rng = rng * 1103515245UL + 12345UL;
+      float z = 100.0f + (float)((rng >> 16) % 5) - 2.0f;
+      f.push(z, (rng & 0x3F) == 0, (unsigned long)i * 40UL);
+      sink = (uint32_t)f.get().distCm;
+    }
+    double ns = (wallNs() - t0) / iters;
+    printf("{\"suite\":\"range_filter\",\"case\":\"cost\",\"iters\":%d,\"ns_per_sample\":%.1f}\n", iters, ns);
+  }
+
+  static const TraceCfg traces[] = {
+    {"step_150_60",       150.0f, 60.0f,  0.0f,  0, 0},
+    {"step_drop_spike",   150.0f, 60.0f,  0.0f,  7, 11},
+    {"approach_50cms",    200.0f, 20.0f, 50.0f,  0, 0},
+    {"approach_drop",     200.0f, 20.0f, 50.0f,  9, 13},
+  };
+
+  for (const TraceCfg& c : traces) {
+    EnicRangeFilter f;
+    LegacyEma ema;
+    uint32_t rng = 7;
+
+    float latF = -1.0f, latE = -1.0f;      // basamakta %10 bandına giriş süresi (ms)
+    double errF = 0, errE = 0, velErr = 0; int nErr = 0;
+    const float stepT = 1.0f;
+
+    for (int i = 0; i < 150; i++) {        // 6 s
+      unsigned long tMs = (unsigned long)i * 40UL;
+      float tS = tMs * 0.001f;
+      float truth = traceTruth(c, tS);
+
+      rng = rng * 1103515245UL + 12345UL;
+      float z = truth + (float)((rng >> 16) % 5) - 2.0f;
+      bool drop  = c.dropEvery  && (i % c.dropEvery)  == c.dropEvery - 1;
+      bool spike = c.spikeEvery && (i % c.spikeEvery) == c.spikeEvery - 1;
+      if (spike) z += 90.0f;
+      float meas = drop ? 999.0f : z;
+
+      f.push(meas, drop, tMs);
+      float ef = f.get().valid ? f.get().distCm : 999.0f;
+      float ee = ema.push(meas);
+
+      if (c.rateCmS == 0.0f) {
+        float band = 0.1f * c.to;
+        if (tS >= stepT) {
+          float dt = (tS - stepT) * 1000.0f;
+          if (latF < 0 && fabsf(ef - c.to) <= band) latF = dt;
+          if (latE < 0 && fabsf(ee - c.to) <= band) latE = dt;
+          if (latF >= 0 && fabsf(ef - c.to) > band) latF = -1.0f; // tekrar çıktıysa say
+          if (latE >= 0 && fabsf(ee - c.to) > band) latE = -1.0f;
+        }
+      } else if (tS > 0.5f && truth > c.to) {
+        errF += fabsf(ef - truth);
+        errE += fabsf(ee - truth);
+        velErr += fabsf(f.get().closingCmS - c.rateCmS);
+        nErr++;
+      }
+    }
+
+    if (c.rateCmS == 0.0f) {
+      printf("{\"suite\":\"range_filter\",\"case\":\"%s\",\"settle_ms\":%.0f,\"legacy_ema_settle_ms\":%.0f}\n",
+             c.name, latF, latE);
+    } else {
+      printf("{\"suite\":\"range_filter\",\"case\":\"%s\",\"mean_abs_err_cm\":%.2f,\"legacy_ema_mean_abs_err_cm\":%.2f,\"closing_speed_mae_cms\":%.2f}\n",
+             c.name, nErr ? errF / nErr : 0.0, nErr ? errE / nErr : 0.0, nErr ? velErr / nErr : 0.0);
+    }
+  }
+}
+
+// ---------------- Binary protocol ----------------
+static size_t buildDriveFrame(uint8_t seq, int records, uint8_t* wire) {
+  uint8_t body[PROTO_MAX_PAYLOAD];
+  size_t n = 0;
+  for (int i = 0; i < records; i++) {
+    body[n++] = OP_DRIVE; body[n++] = 6;
+    putU16(body + n, (uint16_t)(int16_t)150); putU16(body + n + 2, (uint16_t)(int16_t)-150); putU16(body + n + 4, 800);
+    n += 6;
+  }
+  return protoBuildFrame(MSG_CMD, seq, body, n, wire);
+}
+
+static void benchProtocol() {
+  // Kodek: tek sürüş kaydı çerçevesi kur + çöz
+  {
+    uint8_t wire[PROTO_MAX_WIRE + 2], payload[PROTO_MAX_PAYLOAD];
+    const int iters = 1000000;
+    double t0 = wallNs();
+    for (int i = 0; i < iters; i++) {
+      size_t n = buildDriveFrame((uint8_t)i, 1, wire);
+      sink = (uint32_t)protoParseFrame(wire + 1, n - 2, payload, sizeof(payload));
+    }
+    double ns = (wallNs() - t0) / iters;
+    printf("{\"suite\":\"protocol\",\"case\":\"codec_roundtrip\",\"iters\":%d,\"ns_per_op\":%.1f}\n", iters, ns);
+  }
+
+  // Serial girişinden FSM'e: metin satırı vs binary çerçeve (1 ve 8 kayıt)
+  struct Case { const char* name; int records; };
+  static const Case cases[] = { {"text_line", 0}, {"binary_1", 1}, {"binary_batch8", 8} };
+
+  for (const Case& c : cases) {
+    hostReset();
+    Rig rig;
+    EnicSerialLink& link = rig.link;
+
+    // Çerçeve başına: io poll() (doğrula + ACK + cmdQ) -> kontrol drainCommands() (FSM)
+    std::vector<std::string> chunks;
+    const int frames = 256;
+    size_t wireBytes = 0;
+    for (int i = 0; i < frames; i++) {
+      if (c.records == 0) { chunks.push_back("ileri 150 800\n"); wireBytes += chunks.back().size(); continue; }
+      uint8_t wire[PROTO_MAX_WIRE + 2];
+      size_t n = buildDriveFrame((uint8_t)i, c.records, wire);
+      chunks.push_back(std::string((const char*)wire, n));   // binary çerçeveler 0x00 içerir: c_str kullanma
+      wireBytes += n;
+    }
+    int cmdsPerChunk = frames * (c.records ? c.records : 1);
+
+    const int rounds = 200;
+    double t0 = wallNs();
+    for (int r = 0; r < rounds; r++) {
+      for (const std::string& f : chunks) {
+        hostBoard().serialIn.append(f);
+        link.poll();
+        link.drainCommands();
+      }
+    }
+    double ns = (wallNs() - t0) / ((double)rounds * cmdsPerChunk);
+
+    const EnicSerialLink::LinkStats& st = link.getStats();
+    printf("{\"suite\":\"protocol\",\"case\":\"%s\",\"cmds\":%d,\"ns_per_cmd\":%.1f,\"wire_bytes_per_cmd\":%.1f,\"rx_errors\":%lu}\n",
+           c.name, rounds * cmdsPerChunk, ns, (double)wireBytes / cmdsPerChunk, (unsigned long)st.rxErrors);
+  }
+}
+
+// ---------------- Sound ----------------
+static void benchSound() {
+  // play + nota sınırı maliyeti
+  {
+    hostReset();
+    EnicSound snd;
+    snd.begin(BUZZER_PIN, BUZZER_CHANNEL);
+    const int iters = 200000;
+    double t0 = wallNs();
+    for (int i = 0; i < iters; i++) {
+      snd.play((uint8_t)(1 + i % 5));
+      hostAdvanceUs(20000);
+      snd.poll();
+    }
+    double ns = (wallNs() - t0) / iters;
+    printf("{\"suite\":\"sound\",\"case\":\"cost\",\"iters\":%d,\"ns_per_op\":%.1f,\"notes\":%lu}\n",
+           iters, ns, (unsigned long)snd.getStats().notes);
+  }
+
+  // FSM senaryoları: eski playEffect her istekte çalanı keserdi
+  struct Case { const char* name; const char* cmd; };
+  static const Case cases[] = { {"DANCE", "dans"}, {"BOMB", "bomb"}, {"AVOID", "otonom"} };
+
+  for (const Case& c : cases) {
+    hostReset();
+    hostBoard().sonarRangeCm = (c.cmd[0] == 'o') ? []() { return 15.0f; } : std::function<float()>();
+    Rig rig;
+    rig.sense.getSound().resetStats();
+    rig.brain.handleCommand(c.cmd);
+
+    for (int i = 0; i < 15000; i++) { hostAdvanceUs(2000); rig.step(); }   // 30 s
+
+    const EnicSound::SoundStats& st = rig.sense.getSound().getStats();
+    printf("{\"suite\":\"sound\",\"case\":\"%s\",\"requested\":%lu,\"started\":%lu,\"preempted\":%lu,"
+           "\"merged\":%lu,\"queued\":%lu,\"dropped\":%lu,\"notes\":%lu}\n",
+           c.name, (unsigned long)st.requested, (unsigned long)st.started, (unsigned long)st.preempted,
+           (unsigned long)st.merged, (unsigned long)st.queued, (unsigned long)st.dropped, (unsigned long)st.notes);
+  }
+  hostBoard().sonarRangeCm = nullptr;
+}
+
+// ---------------- Motor ramp ----------------
+// 0 -> 200 duty; loop periyodu (CPU yükü) değişirken hedefe varış süresi.
+// legacy: eski EnicMotor (loop başına rampStep = 14)
+static void benchMotorRamp() {
+  static const uint32_t loopUs[] = {2000, 10000, 30000, 70000};
+
+  for (uint32_t period : loopUs) {
+    hostReset();
+    EnicMotor m;
+    m.begin();
+    m.drive(200, 200);
+
+    uint32_t reachMs = 0, t = 0;
+    float peakAcc = 0;
+    while (t < 2000000UL) {
+      hostAdvanceUs(period);
+      t += period;
+      m.update();
+      MotorProfile p = m.getProfile();
+      if (fabsf(p.accLeft) > peakAcc) peakAcc = fabsf(p.accLeft);
+      if (p.velLeft >= 200.0f) { reachMs = t / 1000; break; }
+    }
+
+    int legacy = 0; uint32_t legacyMs = 0;
+    for (uint32_t lt = period; lt <= 2000000UL; lt += period) {
+      legacy += 14;
+      if (legacy >= 200) { legacyMs = lt / 1000; break; }
+    }
+
+    printf("{\"suite\":\"motor_ramp\",\"case\":\"loop_%luus\",\"reach_ms\":%lu,\"peak_acc_duty_s\":%.0f,\"legacy_reach_ms\":%lu}\n",
+           (unsigned long)period, (unsigned long)reachMs, peakAcc, (unsigned long)legacyMs);
+  }
+
+  // Dönüşte senkron: (200,200) -> (-180,180), iki teker aynı anda hedefte mi
+  {
+    hostReset();
+    EnicMotor m;
+    m.begin();
+    m.drive(200, 200);
+    for (int i = 0; i < 500; i++) { hostAdvanceUs(2000); m.update(); }
+    m.drive(-180, 180);
+    uint32_t doneL = 0, doneR = 0;
+    for (uint32_t t = 2; t <= 2000 && !(doneL && doneR); t += 2) {
+      hostAdvanceUs(2000); m.update();
+      MotorProfile p = m.getProfile();
+      if (!doneL && p.velLeft == p.targetLeft) doneL = t;
+      if (!doneR && p.velRight == p.targetRight) doneR = t;
+    }
+    printf("{\"suite\":\"motor_ramp\",\"case\":\"spin_sync\",\"left_done_ms\":%lu,\"right_done_ms\":%lu}\n",
+           (unsigned long)doneL, (unsigned long)doneR);
+  }
+}
+
+// ---------------- Wheel speed loop ----------------
+// Host tekerlek modeli: sağ motor %15 zayıf, batarya 1.0 / 0.8. Açık vs kapalı çevrim.
+struct WheelRun { float ssL, ssR, riseMs, overshootPct, asymPct; int32_t cL, cR; };
+
+static WheelRun runWheels(bool closed, float supply, int l, int r, uint32_t ms) {
+  hostReset();
+  hostMotorPlantEnable(0, M1_IN1_CH, M1_IN2_CH);
+  hostMotorPlantEnable(1, M2_IN3_CH, M2_IN4_CH);
+  hostBoard().wheel[1].cpsPerDuty *= 0.85f;
+  for (HostBoard::MotorPlant& p : hostBoard().wheel) p.supply = supply;
+
+  EnicMotor m;
+  m.begin();
+  m.setClosedLoop(closed);
+  m.drive(l, r);
+
+  WheelRun w = {};
+  float target = (float)abs(l), peak = 0;
+  double c0L = hostBoard().wheel[0].counts, c0R = hostBoard().wheel[1].counts;
+  for (uint32_t t = 1; t <= ms; t++) {
+    hostAdvanceUs(1000);
+    m.update();
+    float v = fabsf(m.getProfile().measLeft);
+    if (v > peak) peak = v;
+    if (w.riseMs == 0 && v >= 0.9f * target) w.riseMs = (float)t;
+  }
+  MotorProfile p = m.getProfile();
+  w.ssL = p.measLeft;
+  w.ssR = p.measRight;
+  w.overshootPct = target > 0 ? 100.0f * (peak - target) / target : 0;
+  if (w.overshootPct < 0) w.overshootPct = 0;
+  w.cL = (int32_t)(hostBoard().wheel[0].counts - c0L);
+  w.cR = (int32_t)(hostBoard().wheel[1].counts - c0R);
+  float sum = fabsf((float)w.cL) + fabsf((float)w.cR);
+  w.asymPct = sum > 0 ? 200.0f * (fabsf((float)w.cL) - fabsf((float)w.cR)) / sum : 0;
+  return w;
+}
+
+static void benchWheelSpeed() {
+  static const float supplies[] = {1.0f, 0.8f};
+  for (int closed = 0; closed < 2; closed++) {
+    for (float sup : supplies) {
+      WheelRun w = runWheels(closed, sup, 130, 130, 1500);
+      printf("{\"suite\":\"wheel_speed\",\"case\":\"straight_130_%s_supply%.1f\",\"ss_left\":%.1f,\"ss_right\":%.1f,"
+             "\"rise_ms\":%.0f,\"overshoot_pct\":%.1f,\"path_asym_pct\":%.1f}\n",
+             closed ? "closed" : "open", sup, w.ssL, w.ssR, w.riseMs, w.overshootPct, w.asymPct);
+    }
+  }
+  // 400 ms yerinde dönüş: dönüş açısı ~ tekerlek sayımlarının ortalaması
+  for (int closed = 0; closed < 2; closed++) {
+    for (float sup : supplies) {
+      WheelRun w = runWheels(closed, sup, -180, 180, 400);
+      printf("{\"suite\":\"wheel_speed\",\"case\":\"spin_400ms_%s_supply%.1f\",\"counts_left\":%ld,\"counts_right\":%ld}\n",
+             closed ? "closed" : "open", sup, (long)w.cL, (long)w.cR);
+    }
+  }
+}
+
+// ---------------- Avoidance simulation ----------------
+// Yerleşik parkurda kapalı çevrim (EnicSim): ideal sonar, böylece sadece kaçış mantığı kıyaslanır.
+// "random" = eski rastgele kaçış, "planner" = ızgara + etrafa bakış, "_gov" = hız governor'ı
+// açık (yoksa eski sabit AUTO hızı); aynı tohumlar. Gerçekçi sonar ve harita taraması: program sim
+static void benchAvoidSim() {
+  SimWorld world;
+  std::string err;
+  world.name = "course";
+  if (!world.parse(SIM_COURSE_MAP, err)) { fprintf(stderr, "avoid_sim: %s\n", err.c_str()); return; }
+  const int runs = 10;
+  const double seconds = 180.0;
+
+  struct Case { const char* name; bool planner, governor; };
+  static const Case cases[] = {
+    { "random",      false, false },
+    { "planner",     true,  false },
+    { "planner_gov", true,  true  },
+  };
+
+  std::vector<SimJob> jobs;
+  for (const Case& c : cases) {
+    for (int k = 0; k < runs; k++) {
+      SimJob j = { &world, SimConfig() };
+      j.cfg.planner = c.planner;
+      j.cfg.governor = c.governor;
+      j.cfg.sonar = SimSonar::ideal();
+      j.cfg.seconds = seconds;
+      j.cfg.seed = 1000u + (uint32_t)k;
+      jobs.push_back(j);
+    }
+  }
+
+  // Tek iş parçacığı ile tüm çekirdekler aynı sonucu vermeli (HostBoard thread_local)
+  double t0 = wallNs();
+  std::vector<SimMetrics> serial = simRunAll(jobs, 1);
+  double t1 = wallNs();
+  std::vector<SimMetrics> parallel = simRunAll(jobs, 0);
+  double t2 = wallNs();
+
+  size_t idx = 0;
+  bool same = true;
+  for (const Case& c : cases) {
+    SimMetrics s;
+    for (int k = 0; k < runs; k++, idx++) {
+      s.add(serial[idx]);
+      same = same && serial[idx].collisions == parallel[idx].collisions && serial[idx].avoids == parallel[idx].avoids
+                  && serial[idx].fwdCm == parallel[idx].fwdCm;
+    }
+    printf("{\"suite\":\"avoid_sim\",\"case\":\"%s\",\"runs\":%d,\"seconds\":%.0f,\"avoid_per_min\":%.1f,\"repeat_pct\":%.1f,"
+           "\"fwd_cm_s\":%.1f,\"stops_per_min\":%.1f,\"avoid_entry_duty\":%.0f,\"emergencies\":%.1f,"
+           "\"bumps\":%.1f,\"collisions_per_hour\":%.1f,\"contact_pct\":%.1f,\"area_m2_per_min\":%.3f,"
+           "\"coverage_pct\":%.1f,\"dr_err_cm\":%.1f}\n",
+           c.name, runs, seconds, s.perMin(s.avoids), s.avoids ? 100.0 * s.repeats / s.avoids : 0.0,
+           s.fwdCm / s.seconds, s.perMin(s.stops), s.avoids ? s.entryDutySum / s.avoids : 0.0,
+           (double)s.emergencies / runs, (double)s.collisions / runs, s.collisionsPerHour(),
+           100.0 * s.contactS / s.seconds, s.perMin(s.areaM2), s.coveragePct(), s.drErrCm / runs);
+  }
+
+  double simS = runs * seconds * (sizeof(cases) / sizeof(cases[0]));
+  printf("{\"suite\":\"avoid_sim\",\"case\":\"throughput\",\"threads\":%u,\"realtime_x_1thread\":%.0f,"
+         "\"realtime_x_all\":%.0f,\"deterministic\":%s}\n",
+         std::max(1u, std::thread::hardware_concurrency()), simS / ((t1 - t0) * 1e-9), simS / ((t2 - t1) * 1e-9),
+         same ? "true" : "false");
+}
+
+// ---------------- Scheduler ----------------
+// 1) Döngü maliyeti: N zamanlayıcıyı her tick'te yoklamak vs timer wheel (vadesi gelen kadar iş)
+// 2) Sarma: millis() 2^32'yi geçerken periyodik faz, tek seferlik vade ve 2^24 ms ötesi bekleme
+// 3) Kapalı döngü sim'i sarmadan hemen önce başlat: sonuçlar t=0 ile birebir aynı olmalı
+struct SchedProbe {
+  EnicScheduler* s;
+  uint32_t runs = 0;
+  uint32_t lastAt = 0;
+  int32_t maxErr = 0;        // gerçekleşen - beklenen tick (ms)
+  uint32_t expectAt = 0;
+  uint32_t step = 0;         // periyodik: sonraki beklenen için
+};
+
+static void schedProbeFire(void* ctx) {
+  SchedProbe* p = (SchedProbe*)ctx;
+  int32_t err = (int32_t)(p->s->now() - p->expectAt);
+  if (abs(err) > abs(p->maxErr)) p->maxErr = err;
+  p->lastAt = p->s->now();
+  p->expectAt += p->step;
+  p->runs++;
+}
+
+static void benchScheduler() {
+  static const uint8_t counts[] = { 1, 4, 16 };
+  const uint32_t ms = 600000;   // 10 dk, 1 ms'lik döngü
+
+  for (uint8_t n : counts) {
+    EnicScheduler sched;
+    sched.begin(0);
+    uint32_t deadline[SCHED_MAX_TASKS], period[SCHED_MAX_TASKS];
+    for (uint8_t i = 0; i < n; i++) {
+      period[i] = 50u + 97u * i;   // 50 ms .. ~1.5 s, aralarında ortak kat az
+      deadline[i] = period[i];
+      sched.startEvery(sched.add("bench"), period[i], period[i]);
+    }
+
+    double t0 = wallNs();
+    for (uint32_t now = 1; now <= ms; now++) sched.advance(now);
+    double wheelNs = (wallNs() - t0) / ms;
+
+    uint32_t polled = 0;
+    t0 = wallNs();
+    for (uint32_t now = 1; now <= ms; now++) {
+      for (uint8_t i = 0; i < n; i++) {
+        if (timeReached(now, deadline[i])) { deadline[i] += period[i]; polled++; }
+      }
+      sink = polled;
+    }
+    double pollNs = (wallNs() - t0) / ms;
+
+    printf("{\"suite\":\"scheduler\",\"case\":\"loop_%u_timers\",\"loops\":%lu,\"wheel_ns_per_loop\":%.1f,"
+           "\"poll_ns_per_loop\":%.1f,\"fired\":%lu,\"polled\":%lu,\"busy_ticks\":%lu}\n",
+           (unsigned)n, (unsigned long)ms, wheelNs, pollNs, (unsigned long)sched.getWheelStats().fired,
+           (unsigned long)polled, (unsigned long)sched.getWheelStats().ticks);
+  }
+
+  // Seyrek çağrı: 16 görev, döngü 20 ms'de bir uyanır (light sleep benzeri); ara tick'ler atlanır
+  {
+    EnicScheduler sched;
+    sched.begin(0);
+    for (uint8_t i = 0; i < SCHED_MAX_TASKS; i++) sched.startEvery(sched.add("bench"), 50u + 97u * i, 50u + 97u * i);
+    const uint32_t loops = 30000;
+    double t0 = wallNs();
+    for (uint32_t k = 1; k <= loops; k++) sched.advance(k * 20u);
+    double ns = (wallNs() - t0) / loops;
+    const EnicScheduler::WheelStats& ws = sched.getWheelStats();
+    printf("{\"suite\":\"scheduler\",\"case\":\"sparse_20ms_16_timers\",\"loops\":%lu,\"ns_per_advance\":%.1f,"
+           "\"ticks_per_advance\":%.2f,\"fired\":%lu,\"missed\":%lu}\n",
+           (unsigned long)loops, ns, (double)ws.ticks / loops, (unsigned long)ws.fired,
+           (unsigned long)sched.getMissedTotal());
+  }
+
+  // Sarma: 2^32 ms'den 5 s önce başla, 20 s koş (1 ms adım)
+  {
+    const uint32_t start = 0xFFFFFFFFu - 4999u;
+    EnicScheduler sched;
+    sched.begin(start);
+    SchedProbe per, once, far;
+    per.s = once.s = far.s = &sched;
+    per.step = 7;  per.expectAt = start + 7;
+    once.expectAt = start + 6000;                   // sarmadan ~1 s sonra
+    far.expectAt = start + 5 * 3600000u;            // 5 saat: tekerlek açıklığından (2^24 ms) uzun
+
+    EnicScheduler::Id idPer = sched.add("per_7ms", schedProbeFire, &per);
+    EnicScheduler::Id idOnce = sched.add("once", schedProbeFire, &once);
+    EnicScheduler::Id idFar = sched.add("far_5h", schedProbeFire, &far);
+    sched.startEvery(idPer, 7, 7);
+    sched.startOnce(idOnce, 6000);
+    sched.startOnce(idFar, 5 * 3600000u);
+
+    for (uint32_t t = 1; t <= 20000; t++) sched.advance(start + t);
+    uint32_t perRuns = per.runs, missed = sched.getMissedTotal();
+    sched.cancel(idPer);
+    // Uzak görev: seyrek adımlarla ilerle, vade tick'inde (gecikmesiz) çalışmalı
+    uint32_t now = start + 20000;
+    while (far.runs == 0 && timeUntil(now, far.expectAt) > -1000) { now += 999; sched.advance(now); }
+
+    bool ok = perRuns == 20000 / 7 && per.maxErr == 0 && once.runs == 1 && once.maxErr == 0 &&
+              far.runs == 1 && far.maxErr == 0 && missed == 0;
+    printf("{\"suite\":\"scheduler\",\"case\":\"millis_wrap\",\"start_ms\":%lu,\"periodic_runs\":%lu,\"periodic_max_err_ms\":%ld,"
+           "\"once_runs\":%lu,\"once_err_ms\":%ld,\"far_runs\":%lu,\"far_err_ms\":%ld,\"missed\":%lu,\"ok\":%s}\n",
+           (unsigned long)start, (unsigned long)perRuns, (long)per.maxErr, (unsigned long)once.runs, (long)once.maxErr,
+           (unsigned long)far.runs, (long)far.maxErr, (unsigned long)missed, ok ? "true" : "false");
+  }
+
+  // Gecikme: 100 ms'lik periyot, döngü 300 ms takılırsa 2 periyot kaçırılmış sayılır, faz korunur
+  {
+    EnicScheduler sched;
+    sched.begin(0);
+    SchedProbe per;
+    per.s = &sched;
+    EnicScheduler::Id id = sched.add("per_100ms", schedProbeFire, &per);
+    sched.startEvery(id, 100, 100);
+    sched.advance(50);
+    sched.advance(350);      // 100, 200, 300 vadeleri -> tek çalışma, 2 kaçırılmış
+    sched.advance(400);      // faz korunduysa 400'de
+    const EnicScheduler::TaskStats& ts = sched.getTaskStats(id);
+    printf("{\"suite\":\"scheduler\",\"case\":\"overrun\",\"runs\":%lu,\"missed\":%lu,\"max_late_ms\":%lu,\"last_at\":%lu,\"ok\":%s}\n",
+           (unsigned long)ts.runs, (unsigned long)ts.missed, (unsigned long)ts.maxLateMs, (unsigned long)per.lastAt,
+           ts.runs == 2 && ts.missed == 2 && ts.maxLateMs == 250 && per.lastAt == 400 ? "true" : "false");
+  }
+
+  // Firmware sarmayı görmemeli: aynı koşu t=0'da, millis() ve micros() sarmasından 60 s önce
+  {
+    SimWorld world;
+    std::string err;
+    world.name = "course";
+    if (!world.parse(SIM_COURSE_MAP, err)) { fprintf(stderr, "scheduler: %s\n", err.c_str()); return; }
+    struct Case { const char* name; uint64_t startMs; };
+    static const Case cases[] = {
+      { "t0",          0 },
+      { "millis_wrap", (1ULL << 32) - 60000 },
+      { "micros_wrap", (1ULL << 32) / 1000 - 60000 },
+    };
+    const int runs = 4;
+
+    std::vector<SimJob> jobs;
+    for (const Case& c : cases) {
+      for (int k = 0; k < runs; k++) {
+        SimJob j = { &world, SimConfig() };
+        j.cfg.sonar = SimSonar::ideal();
+        j.cfg.seconds = 180.0;
+        j.cfg.seed = 1000u + (uint32_t)k;
+        j.cfg.startMs = c.startMs;
+        jobs.push_back(j);
+      }
+    }
+    std::vector<SimMetrics> res = simRunAll(jobs, 0);
+
+    for (size_t ci = 0; ci < sizeof(cases) / sizeof(cases[0]); ci++) {
+      SimMetrics s;
+      bool same = true;
+      for (int k = 0; k < runs; k++) {
+        const SimMetrics& a = res[ci * runs + k];
+        const SimMetrics& b = res[k];
+        s.add(a);
+        same = same && a.collisions == b.collisions && a.avoids == b.avoids && a.fwdCm == b.fwdCm &&
+               a.areaM2 == b.areaM2 && a.schedFired == b.schedFired && a.schedMissed == b.schedMissed;
+      }
+      printf("{\"suite\":\"scheduler\",\"case\":\"sim_%s\",\"start_ms\":%llu,\"runs\":%d,\"collisions_per_hour\":%.1f,"
+             "\"avoid_per_min\":%.2f,\"area_m2_per_min\":%.3f,\"sched_fired\":%lu,\"sched_missed\":%lu,\"same_as_t0\":%s}\n",
+             cases[ci].name, (unsigned long long)cases[ci].startMs, runs, s.collisionsPerHour(), s.perMin(s.avoids),
+             s.perMin(s.areaM2), (unsigned long)s.schedFired, (unsigned long)s.schedMissed, same ? "true" : "false");
+    }
+  }
+}
+
+// ---------------- Power ----------------
+// Aynı senaryo güç yöneticisi kapalı (pwr 0: hep 240 MHz, sabit periyot) ve açık; komutlar UART'tan.
+// Host'ta task süresi sanal 0: görev oranı ve akım tahmini uyanış sayısından (POWER_WAKE_US).
+// Uyanma gecikmesi: IDLE'da gelen "ileri" komutundan tekerin dönmeye başlamasına (cihazda + light sleep çıkışı).
+static const uint32_t POWER_STEP_US = 250;
+
+static void powerRun(Rig& rig, uint32_t us) {
+  for (uint32_t t = 0; t < us; t += POWER_STEP_US) {
+    hostAdvanceUs(POWER_STEP_US);
+    rig.stepDue();
+  }
+}
+
+static void benchPower() {
+  struct Case { const char* name; const char* cmd; float cm; uint32_t faceEveryMs; };
+  static const Case cases[] = {
+    { "idle",       "dur",    80.0f,  0 },
+    { "idle_faces", "dur",    80.0f,  6000 },   // 6 s'de bir ifade: uzun override + ses
+    { "auto",       "otonom", 150.0f, 0 },
+  };
+  static const char* const faceCmds[] = { "konus\n", "agla\n", "dinle\n", "dil\n" };
+  const uint32_t seconds = 120;
+
+  for (const Case& c : cases) {
+    float offHours = 0.0f;
+    for (int on = 0; on <= 1; on++) {
+      hostReset();
+      float cm = c.cm;
+      hostBoard().sonarRangeCm = [cm]() { return cm; };
+      Rig rig;
+      rig.power.setEnabled(on != 0);
+      std::string cmd = std::string(c.cmd) + "\n";
+      hostSerialFeed(cmd.c_str());
+      rig.power.resetStats();
+      uint32_t pings0 = rig.sense.getSonar().getSampleCount();
+      uint32_t frames0 = rig.face.getFrameStats().presented;
+
+      for (uint32_t ms = 0; ms < seconds * 1000; ms += 100) {
+        if (c.faceEveryMs && ms % c.faceEveryMs == 0 && ms) hostSerialFeed(faceCmds[(ms / c.faceEveryMs) % 4]);
+        powerRun(rig, 100000);
+      }
+
+      EnicPower::Estimate e = rig.power.estimate();
+      if (!on) offHours = e.hours;
+      printf("{\"suite\":\"power\",\"case\":\"%s_%s\",\"seconds\":%lu,\"wakeups_per_s\":%.1f,\"idle_pct\":%.1f,"
+             "\"sleep_pct\":%.1f,\"duty_pct\":%.3f,\"est_ma\":%.1f,\"est_hours\":%.1f,\"runtime_x\":%.2f,"
+             "\"pings_per_s\":%.1f,\"frames\":%lu,\"overruns\":%lu}\n",
+             c.name, on ? "on" : "off", (unsigned long)seconds, e.wakeupsPerS, e.idlePct, e.sleepPct, e.dutyPct,
+             e.mA, e.hours, offHours > 0.0f ? e.hours / offHours : 1.0f,
+             (rig.sense.getSonar().getSampleCount() - pings0) / (double)seconds,
+             (unsigned long)(rig.face.getFrameStats().presented - frames0), (unsigned long)rig.tasks.getOverruns());
+    }
+  }
+
+  // Uyanma: IDLE'a düşmesini bekle, rastgele fazda komut, tekerde ilk duty'ye kadar
+  for (int on = 0; on <= 1; on++) {
+    hostReset();
+    hostBoard().sonarRangeCm = []() { return 80.0f; };
+    Rig rig;
+    rig.power.setEnabled(on != 0);
+    const int trials = 40;
+    uint32_t maxUs = 0, idleTrials = 0;
+    double sumUs = 0.0;
+    uint32_t lcg = 12345;
+    for (int k = 0; k < trials; k++) {
+      for (int w = 0; w < 400 && (on ? !rig.power.isIdle() : rig.brain.isBusy()); w++) powerRun(rig, 25000);
+      lcg = lcg * 1664525u + 1013904223u;
+      powerRun(rig, (lcg >> 8) % 200000);
+      if (rig.power.isIdle()) idleTrials++;
+      hostSerialFeed("ileri 200 300\n");
+      uint32_t us = 0;
+      while (rig.motor.getCurrentLeft() == 0 && us < 500000) { powerRun(rig, POWER_STEP_US); us += POWER_STEP_US; }
+      if (us > maxUs) maxUs = us;
+      sumUs += us;
+    }
+    printf("{\"suite\":\"power\",\"case\":\"wake_to_motor_%s\",\"trials\":%d,\"from_idle\":%lu,\"mean_ms\":%.2f,"
+           "\"max_ms\":%.2f,\"step_ms\":%.2f}\n",
+           on ? "on" : "off", trials, (unsigned long)idleTrials, sumUs / trials / 1000.0, maxUs / 1000.0,
+           POWER_STEP_US / 1000.0);
+  }
+  hostBoard().sonarRangeCm = nullptr;
+}
+
+// ---------------- Boot ----------------
+// Açılış: ilk kareye kadar panele giden flush / I2C byte (400 kHz süre tahmini), panel init'i
+// sürerken istenen ifade tek ilk kare mi; sonar ısınmalı / ısınmasız ilk doğru mesafe.
+// Süreler sanal saat; cihazdaki gerçek ölçüm açılıştaki {"boot":...} satırı (micros, reset'ten beri).
+static void benchBoot() {
+  hostReset();
+  {
+    Rig rig;
+    const EnicDisplayLink::FlushStats fl = rig.face.getFlushStats();
+    printf("{\"suite\":\"boot\",\"case\":\"first_frame\",\"flushes\":%lu,\"i2c_bytes\":%lu,\"i2c_ms_400khz\":%.1f}\n",
+           (unsigned long)fl.flushes, (unsigned long)fl.bytesSent, fl.bytesSent * 9 / 400.0);
+  }
+
+  // Kontrol tarafı io task'ı panel init'indeyken çizim istedi: NORMAL + istek değil, sadece istek
+  hostReset();
+  {
+    EnicFace face;
+    face.draw(SHOCK);
+    face.begin();
+    const EnicDisplayLink::FlushStats fl = face.getFlushStats();
+    printf("{\"suite\":\"boot\",\"case\":\"first_frame_pending\",\"flushes\":%lu,\"i2c_bytes\":%lu,\"frames\":%lu,"
+           "\"still_pending\":%s}\n",
+           (unsigned long)fl.flushes, (unsigned long)fl.bytesSent, (unsigned long)face.getFrameStats().presented,
+           face.drawPending() ? "true" : "false");
+  }
+
+  // 80 cm'de duvar: ilk doğru mesafe ve medyan penceresinin dolması (cihaz zamanlama kuralıyla)
+  for (int warm = 1; warm >= 0; warm--) {
+    hostReset();
+    hostBoard().sonarRangeCm = []() { return 80.0f; };
+    Rig rig;
+    if (!warm) rig.sense.begin(0);
+    uint32_t t0 = nowUs32(), okUs = 0, fullUs = 0;
+    while (!fullUs && nowUs32() - t0 < 2000000UL) {
+      powerRun(rig, POWER_STEP_US);
+      if (!okUs && fabsf(rig.sense.getDistance() - 80.0f) < 2.0f) okUs = nowUs32() - t0;
+      if (rig.sense.getSonar().getSampleCount() >= EnicRangeFilter::MEDIAN_N) fullUs = nowUs32() - t0;
+    }
+    powerRun(rig, 50000);   // io task'ı raporu bassın
+    const EnicBoot& b = rig.boot;
+    uint32_t setup = b.get(BOOT_SETUP);
+    printf("{\"suite\":\"boot\",\"case\":\"range_%s\",\"first_ok_ms\":%.2f,\"median_full_ms\":%.2f,"
+           "\"control_ready_ms\":%.2f,\"range_ready_ms\":%.2f,\"report\":%s}\n",
+           warm ? "warmup" : "no_warmup", okUs / 1000.0, fullUs / 1000.0,
+           (b.get(BOOT_CONTROL_READY) - setup) / 1000.0, (b.get(BOOT_RANGE_READY) - setup) / 1000.0,
+           b.complete() ? "true" : "false");
+  }
+  hostBoard().sonarRangeCm = nullptr;
+}
+
+// ---------------- Mem ----------------
+// Statik RAM (host boyutları: işaretçi 8 bayt, ESP32'ye özel yığın / tampon yok) ve heap tahsisleri.
+// Açılış raporundan (EnicMem::arm) sonra sense / kontrol / io adımlarında ve teşhis komutlarında 0
+// olmalı. Sayım -Wl,--wrap=malloc ile bağlandıysa ("linked"); log adımı host'un std::string
+// tabanlı LittleFS / NVS kopyasına yazdığı için ayrı sayılır (cihazdaki IDF sürücülerini temsil etmez).
+static void benchMem() {
+  hostReset();
+  bool serialEcho = hostBoard().serialEcho;
+  hostBoard().serialEcho = false;
+
+  // Framebuffer: Adafruit_SSD1306::begin() eskiden malloc ediyordu
+  uint64_t faceAllocs;
+  {
+    EnicFace face;
+    uint64_t a0 = hostHeapAllocs();
+    face.begin();
+    faceAllocs = hostHeapAllocs() - a0;
+  }
+
+  hostReset();
+  hostBoard().sonarRangeCm = []() { return 150.0f; };
+  {
+    Rig rig;
+    printf("{\"suite\":\"mem\",\"case\":\"static\",\"total\":%lu,\"face\":%u,\"sense\":%u,\"brain\":%u,"
+           "\"link\":%u,\"recorder\":%u,\"params\":%u,\"tasks\":%u,\"face_begin_allocs\":%lu}\n",
+           (unsigned long)EnicMem::staticBytes(), (unsigned)sizeof(rig.face), (unsigned)sizeof(rig.sense),
+           (unsigned)sizeof(rig.brain), (unsigned)sizeof(rig.link), (unsigned)sizeof(rig.recorder),
+           (unsigned)sizeof(rig.params), (unsigned)sizeof(rig.tasks), (unsigned long)faceAllocs);
+
+    // 30 s AUTO + ifadeler; her 1 ms'de tüm task adımları
+    hostSerialFeed("otonom\n");
+    uint64_t rtAllocs = 0, logAllocs = 0;
+    uint32_t steps = 0;
+    for (uint32_t ms = 0; ms < 30000; ms++) {
+      if (ms % 5000 == 2500) rig.brain.handleCommand("konus");
+      hostAdvanceUs(1000);
+      bool armed = EnicMem::isArmed();   // arm() kendi deneme tahsisini yapar; sonraki adımdan say
+      uint64_t a0 = hostHeapAllocs();
+      rig.tasks.senseStep();
+      rig.tasks.controlStep();
+      rig.tasks.ioStep();
+      uint64_t a1 = hostHeapAllocs();
+      rig.tasks.logStep();
+      if (armed) {
+        rtAllocs += a1 - a0;
+        logAllocs += hostHeapAllocs() - a1;
+        steps++;
+      }
+    }
+
+    static const char* const diag[] = {
+      "pwr", "sched", "gov", "queues", "oled", "log", "boot", "mem", "dump", "get", "get nav",
+      "set nav.auto_obs_enter 24", "set {\"speed.manual\":190,\"filter.alpha\":0.5}", "set defaults", "ping 60",
+    };
+    uint64_t a0 = hostHeapAllocs();
+    for (const char* c : diag) rig.brain.handleCommand(c);
+    uint64_t diagAllocs = hostHeapAllocs() - a0;
+
+    printf("{\"suite\":\"mem\",\"case\":\"steady\",\"linked\":%s,\"armed\":%s,\"steps\":%lu,\"rt_allocs\":%lu,"
+           "\"diag_cmds\":%u,\"diag_allocs\":%lu,\"log_allocs_host_fs\":%lu}\n",
+           EnicMem::guardLinked() ? "true" : "false", EnicMem::isArmed() ? "true" : "false", (unsigned long)steps,
+           (unsigned long)rtAllocs, (unsigned)(sizeof(diag) / sizeof(diag[0])), (unsigned long)diagAllocs,
+           (unsigned long)logAllocs);
+  }
+  hostBoard().serialEcho = serialEcho;
+  hostBoard().sonarRangeCm = nullptr;
+}
+
+// ---------------- Compositor ----------------
+// Kontrol tick'i başına birden çok çizim isteği (ifade komutu + durum geçişi + idle):
+// panele giden kare sayısı slot sayısını geçmemeli
+static void benchCompositor() {
+  static const uint16_t fpsList[] = { 0, 60, 30, 15 };
+  for (uint16_t fps : fpsList) {
+    hostReset();
+    Rig rig;
+    rig.face.setFrameRate(fps);
+    rig.face.resetFlushStats();
+
+    const int ticks = 1000;   // 2 ms adımla 2 s
+    for (int i = 0; i < ticks; i++) {
+      rig.brain.handleCommand((i & 1) ? "konus" : "ileri 120 4");
+      rig.face.draw((FaceType)(i % FACE_COUNT));
+      hostAdvanceUs(2000);
+      rig.step();
+    }
+    const EnicFace::FrameStats fs = rig.face.getFrameStats();
+    printf("{\"suite\":\"compositor\",\"case\":\"burst_%ufps\",\"ticks\":%d,\"requested\":%lu,\"merged\":%lu,"
+           "\"presented\":%lu,\"oled_flushes\":%lu}\n",
+           (unsigned)fps, ticks, (unsigned long)fs.requested, (unsigned long)fs.merged, (unsigned long)fs.presented,
+           (unsigned long)rig.face.getFlushStats().flushes);
+  }
+}
+
+// ---------------- Timeline ----------------
+// Gösteriler farklı kontrol periyotlarında: kare ızgarasına göre gecikme, atlanan kare.
+// Dans: motorlar vuruşla hareket eder, tam tur sonunda net yol tepe yolun %10'unu geçmemeli.
+// Açık çevrim (varsayılan donanım, ENIC_ENCODERS=0); kapalı çevrimde PI integrali hareketler arasında taşınır.
+static void benchTimeline() {
+  struct Case { const char* name; const char* cmd; unsigned long ms; };
+  static const Case cases[] = { {"BOMB", "bomb", 30000}, {"DANCE", "dans", 8000} };
+  static const uint32_t periodsUs[] = { 2000, 5000, 13000, 40000 };
+
+  for (const Case& c : cases) {
+    for (uint32_t periodUs : periodsUs) {
+      hostReset();
+      Rig rig;
+#if ENIC_ENCODERS
+      rig.motor.setClosedLoop(false);
+#endif
+      rig.brain.handleCommand(c.cmd);
+      int64_t c0L = hostBoard().wheel[0].counts, c0R = hostBoard().wheel[1].counts;
+      int32_t peakL = 0, netL = 0, netR = 0;
+      const EnicTimeline::TimelineStats& st = rig.brain.getShow().getStats();
+
+      // Net yol son tam turun sonunda (yarım kalan tur sayılmaz)
+      unsigned long steps = c.ms * 1000UL / periodUs;
+      uint32_t loops = 0;
+      for (unsigned long i = 0; i < steps; i++) {
+        hostAdvanceUs(periodUs);
+        rig.step();
+        int32_t dL = (int32_t)(hostBoard().wheel[0].counts - c0L);
+        if (abs(dL) > abs(peakL)) peakL = dL;
+        if (st.loops != loops) {
+          loops = st.loops;
+          netL = dL;
+          netR = (int32_t)(hostBoard().wheel[1].counts - c0R);
+        }
+      }
+      bool inPlace = abs(netL) * 10 <= abs(peakL) && abs(netR) * 10 <= abs(peakL);
+      printf("{\"suite\":\"timeline\",\"case\":\"%s_%luus\",\"keys\":%lu,\"frames\":%lu,\"skipped\":%lu,"
+             "\"max_late_ms\":%lu,\"loops\":%lu,\"state_after\":%d,\"wheel_peak_l\":%ld,\"wheel_net_l\":%ld,\"wheel_net_r\":%ld,"
+             "\"in_place\":%s}\n",
+             c.name, (unsigned long)periodUs, (unsigned long)st.keys, (unsigned long)st.frames,
+             (unsigned long)st.skipped, (unsigned long)st.maxLateMs, (unsigned long)st.loops,
+             (int)rig.brain.getState(), (long)peakL, (long)netL, (long)netR, inPlace ? "true" : "false");
+      expect(inPlace, "timeline", "net wheel travel over a whole loop exceeds 10% of peak");
+    }
+  }
+}
+
+// ---------------- Flight recorder ----------------
+// Serial çıkışını geçici dosyaya al, MSG_LOG çerçevelerini çöz
+struct LogCapture {
+  FILE* f = nullptr;
+  void begin() { f = tmpfile(); hostBoard().serialFd = fileno(f); }
+  void end()   { hostBoard().serialFd = -1; fclose(f); }
+
+  struct Result {
+    std::vector<LogRecord> records;
+    uint32_t frames = 0, errors = 0, wireBytes = 0, endRecords = 0, endDropped = 0;
+    bool ended = false;
+  };
+
+  Result decode() {
+    Result r;
+    std::string raw;
+    char buf[4096];
+    size_t n;
+    fflush(f);
+    rewind(f);
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) raw.append(buf, n);
+    r.wireBytes = (uint32_t)raw.size();
+
+    uint8_t payload[PROTO_MAX_PAYLOAD];
+    size_t start = std::string::npos;
+    for (size_t i = 0; i < raw.size(); i++) {
+      if (raw[i] != 0) continue;
+      if (start != std::string::npos && i > start + 1) {
+        size_t len = protoParseFrame((const uint8_t*)raw.data() + start + 1, i - start - 1, payload, sizeof(payload));
+        if (len == 0) { r.errors++; start = i; continue; }
+        r.frames++;
+        if (payload[0] == MSG_LOG) {
+          for (size_t o = PROTO_HEADER; o + sizeof(LogRecord) <= len; o += sizeof(LogRecord)) {
+            LogRecord rec;
+            memcpy(&rec, payload + o, sizeof(rec));
+            r.records.push_back(rec);
+          }
+        } else if (payload[0] == MSG_LOG_END) {
+          r.ended = true;
+          r.endRecords = (uint32_t)getU16(payload + 2) | ((uint32_t)getU16(payload + 4) << 16);
+          r.endDropped = (uint32_t)getU16(payload + 6) | ((uint32_t)getU16(payload + 8) << 16);
+        }
+        start = std::string::npos;   // ayraç çifti: sonraki 0x00 yeni çerçeve açar
+        continue;
+      }
+      start = i;
+    }
+    return r;
+  }
+};
+
+// Açılış kayıtlarıyla bölümlenmiş zaman sırası
+static bool logOrdered(const std::vector<LogRecord>& v, uint32_t& boots) {
+  boots = 0;
+  bool ok = true;
+  for (size_t i = 0; i < v.size(); i++) {
+    if (v[i].type == LOG_BOOT) { boots++; continue; }
+    if (i > 0 && v[i - 1].type != LOG_BOOT && v[i].tMs < v[i - 1].tMs) ok = false;
+  }
+  return ok;
+}
+
+static void benchRecorder() {
+  double storedNs = 0;
+
+  // 1) Kayıt maliyeti: kontrol tarafı push, log tarafı bloklara yazım (host bellek FS)
+  {
+    hostReset();
+    EnicRecorder rec;
+    rec.begin();
+    rec.mount();
+    const int iters = 200000;
+    double pushNs = 0;
+    double t0 = wallNs();
+    for (int i = 0; i < iters; i += 128) {
+      double p0 = wallNs();
+      for (int k = 0; k < 128; k++) rec.record(LOG_RANGE, 3, i + k, -12, 800);
+      pushNs += wallNs() - p0;
+      rec.drainStep();
+    }
+    double totalNs = wallNs() - t0;
+    storedNs = totalNs / iters;
+    printf("{\"suite\":\"recorder\",\"case\":\"cost\",\"iters\":%d,\"ns_per_record\":%.1f,\"ns_per_record_stored\":%.1f,"
+           "\"blocks\":%lu,\"dropped\":%lu}\n",
+           iters, pushNs / iters, totalNs / iters, (unsigned long)rec.getStats().blocks,
+           (unsigned long)rec.getRingStats().dropped);
+  }
+
+  // 2) Tam sensör hızında (ping 25 ms) kontrol turu maliyeti: kayıt açık / kapalı, sırayla
+  //    tekrarlanır ve en küçükler alınır (fark birkaç ns, tek çekirdekte gürültü büyük).
+  //    log_cpu_pct: kayıt/s x kayıt başına tam maliyet, kontrol task'ı bütçesinden bağımsız.
+  {
+    struct Case { const char* name; float cm; };
+    static const Case cases[] = { { "AUTO", -1.0f }, { "AVOID", 15.0f } };
+    const int ticks = 150000;  // 2 ms adımla 5 dk
+    for (const Case& c : cases) {
+      double ns[2] = { 1e18, 1e18 };
+      uint32_t records = 0, dropped = 0, blocks = 0, syncs = 0;
+      for (int rep = 0; rep < 5; rep++) {
+        for (int on = 0; on < 2; on++) {
+          hostReset();
+          float cm = c.cm;
+          hostBoard().sonarRangeCm = [cm]() { return cm; };
+          Rig rig;
+          if (!on) rig.brain.setRecorder(nullptr);
+          rig.brain.handleCommand("ping 25");
+          rig.brain.handleCommand("otonom");
+          double t0 = wallNs();
+          for (int i = 0; i < ticks; i++) {
+            hostAdvanceUs(2000);
+            rig.step();
+          }
+          ns[on] = std::min(ns[on], (wallNs() - t0) / ticks);
+          if (on) {
+            records = rig.recorder.getRingStats().pushed;
+            dropped = rig.recorder.getRingStats().dropped;
+            blocks = rig.recorder.getStats().blocks;
+            syncs = rig.recorder.getStats().syncs;
+          }
+        }
+      }
+      double secs = ticks * 0.002;
+      printf("{\"suite\":\"recorder\",\"case\":\"tick_%s\",\"ticks\":%d,\"ns_per_tick_off\":%.1f,\"ns_per_tick_on\":%.1f,"
+             "\"tick_overhead_pct\":%.1f,\"records_per_s\":%.1f,\"log_cpu_pct\":%.5f,\"flash_bytes_per_s\":%.0f,"
+             "\"dropped\":%lu}\n",
+             c.name, ticks, ns[0], ns[1], (ns[1] - ns[0]) / ns[0] * 100.0, records / secs,
+             records / secs * storedNs * 1e-9 * 100.0, (blocks + syncs) * (double)LOG_BLOCK_BYTES / secs,
+             (unsigned long)dropped);
+    }
+  }
+
+  // 3) Döküm: 60 s AVOID sonrası "log 1", kablodaki çerçeveleri çöz
+  {
+    hostReset();
+    hostBoard().sonarRangeCm = []() { return 15.0f; };
+    Rig rig;
+    rig.brain.handleCommand("otonom");
+    for (int i = 0; i < 30000; i++) { hostAdvanceUs(2000); rig.step(); }
+
+    LogCapture cap;
+    cap.begin();
+    rig.brain.handleCommand("log 1");
+    rig.step();
+    LogCapture::Result r = cap.decode();
+    cap.end();
+
+    uint32_t boots = 0;
+    bool ordered = logOrdered(r.records, boots);
+    uint32_t pushed = rig.recorder.getRingStats().pushed;
+    printf("{\"suite\":\"recorder\",\"case\":\"dump\",\"records\":%lu,\"pushed\":%lu,\"end_records\":%lu,\"frames\":%lu,"
+           "\"crc_errors\":%lu,\"wire_bytes\":%lu,\"dump_s_at_921600\":%.2f,\"ordered\":%s,\"boots\":%lu}\n",
+           (unsigned long)r.records.size(), (unsigned long)pushed, (unsigned long)r.endRecords,
+           (unsigned long)r.frames, (unsigned long)r.errors, (unsigned long)r.wireBytes,
+           r.wireBytes * 10.0 / ENIC_SERIAL_BAUD, ordered ? "true" : "false", (unsigned long)boots);
+  }
+
+  // 4) Sarma + yeniden başlatma: dosyayı bir turdan fazla doldur, FS'i koruyarak yeni Rig aç
+  //    (açılışta son blok bulunmalı), sonra dök: en eski kayıtlar gitmiş, iki açılış sırayla
+  {
+    hostReset();
+    hostBoard().sonarRangeCm = []() { return 15.0f; };
+    uint32_t firstRun = 0;
+    {
+      Rig rig;
+      rig.brain.handleCommand("ping 25");
+      rig.brain.handleCommand("otonom");
+      for (int i = 0; i < 450000; i++) { hostAdvanceUs(2000); rig.step(); }   // 15 dk
+      firstRun = rig.recorder.getRingStats().pushed;
+    }
+    Rig rig;   // hostBoard().files korunur
+    rig.brain.handleCommand("otonom");
+    for (int i = 0; i < 5000; i++) { hostAdvanceUs(2000); rig.step(); }
+
+    LogCapture cap;
+    cap.begin();
+    rig.brain.handleCommand("log 1");
+    rig.step();
+    LogCapture::Result r = cap.decode();
+    cap.end();
+
+    uint32_t boots = 0;
+    bool ordered = logOrdered(r.records, boots);
+    printf("{\"suite\":\"recorder\",\"case\":\"wrap_reboot\",\"first_run_records\":%lu,\"capacity_records\":%lu,"
+           "\"records\":%lu,\"boots\":%lu,\"ordered\":%s,\"oldest_ms\":%lu,\"newest_ms\":%lu,\"crc_errors\":%lu}\n",
+           (unsigned long)firstRun, (unsigned long)(ENIC_LOG_BLOCKS * LOG_RECS_PER_BLOCK),
+           (unsigned long)r.records.size(), (unsigned long)boots, ordered ? "true" : "false",
+           r.records.empty() ? 0UL : (unsigned long)r.records.front().tMs,
+           r.records.empty() ? 0UL : (unsigned long)r.records.back().tMs, (unsigned long)r.errors);
+  }
+  hostBoard().sonarRangeCm = nullptr;
+}
+
+// ---------------- Queue ----------------
+// EnicQueue iki gerçek thread ile: sıra/kayıp kontrolü ve push gecikmesi
+static void benchQueue() {
+  // 1) Stres: üretici doluysa tekrar dener, tüketici sırayı ve toplamı doğrular (tek çekirdekte de ilerlesin diye yield)
+  {
+    static EnicQueue<uint32_t, 64> q("bench.stress");
+    const uint32_t items = 5000000;
+    uint64_t sumIn = 0, sumOut = 0;
+    uint32_t orderErrors = 0, retries = 0;
+
+    double t0 = wallNs();
+    std::thread consumer([&]() {
+      uint32_t expect = 0, v;
+      while (expect < items) {
+        if (!q.pop(v)) { std::this_thread::yield(); continue; }
+        if (v != expect) orderErrors++;
+        sumOut += v;
+        expect = v + 1;
+      }
+    });
+    for (uint32_t i = 0; i < items; i++) {
+      while (!q.push(i)) { retries++; std::this_thread::yield(); }
+      sumIn += i;
+    }
+    consumer.join();
+    double ns = (wallNs() - t0) / items;
+
+    QueueStats st = q.getStats();
+    printf("{\"suite\":\"queue\",\"case\":\"spsc_stress\",\"items\":%lu,\"ns_per_item\":%.2f,\"order_errors\":%lu,"
+           "\"checksum_ok\":%s,\"full_retries\":%lu,\"high_water\":%lu}\n",
+           (unsigned long)items, ns, (unsigned long)orderErrors, sumIn == sumOut ? "true" : "false",
+           (unsigned long)retries, (unsigned long)st.highWater);
+  }
+
+  // 2) Kontrol render'ı beklemez: 1 kHz üretici, kare başına 70 ms süren tüketici (yavaş I2C)
+  {
+    static EnicQueue<DrawRequest, 16> q("bench.draw");
+    const int ticks = 1500;
+    std::vector<double> pushNs;
+    pushNs.reserve(ticks);
+    std::atomic<bool> done{false};
+    uint32_t rendered = 0;
+
+    std::thread render([&]() {
+      DrawRequest r;
+      while (!done.load() || !q.empty()) {
+        if (!q.pop(r)) { std::this_thread::sleep_for(std::chrono::microseconds(200)); continue; }
+        rendered++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(70));
+      }
+    });
+
+    double start = wallNs();
+    for (int i = 0; i < ticks; i++) {
+      DrawRequest r = { DrawRequest::FACE, (uint8_t)(i % FACE_COUNT), 0, 0 };
+      double t0 = wallNs();
+      q.push(r);
+      pushNs.push_back(wallNs() - t0);
+      std::this_thread::sleep_until(std::chrono::steady_clock::time_point(
+        std::chrono::nanoseconds((int64_t)(start + (i + 1) * 1e6))));
+    }
+    double controlMs = (wallNs() - start) / 1e6;
+    done.store(true);
+    render.join();
+
+    std::sort(pushNs.begin(), pushNs.end());
+    QueueStats st = q.getStats();
+    printf("{\"suite\":\"queue\",\"case\":\"control_vs_slow_render\",\"ticks\":%d,\"control_ms\":%.1f,"
+           "\"push_p50_ns\":%.0f,\"push_p99_ns\":%.0f,\"push_max_ns\":%.0f,\"rendered\":%lu,\"dropped\":%lu,\"high_water\":%lu}\n",
+           ticks, controlMs, pushNs[ticks / 2], pushNs[ticks * 99 / 100], pushNs.back(),
+           (unsigned long)rendered, (unsigned long)st.dropped, (unsigned long)st.highWater);
+  }
+}
+
+// Firmware döngüsünü gerçek zamanlı bir tty/pty üstünde çalıştır (host throughput/latency testi)
+static int runServe(const char* path, double seconds) {
+  int fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+  if (fd < 0) { perror(path); return 1; }
+  struct termios tio;
+  if (tcgetattr(fd, &tio) == 0) { cfmakeraw(&tio); tcsetattr(fd, TCSANOW, &tio); }
+
+  hostReset();
+  hostBoard().serialFd = fd;
+  hostBoard().sonarRangeCm = []() { return 80.0f; };
+
+  Rig rig;
+  const EnicSerialLink& link = rig.link;
+
+  double start = wallNs(), last = start;
+  while ((wallNs() - start) < seconds * 1e9) {
+    double t = wallNs();
+    hostAdvanceUs((uint64_t)((t - last) / 1000.0));
+    last = t;
+
+    rig.step();
+
+    struct pollfd p = { fd, POLLIN, 0 };
+    if (::poll(&p, 1, 1) > 0 && (p.revents & (POLLHUP | POLLERR))) break;
+  }
+
+  const EnicSerialLink::LinkStats& st = link.getStats();
+  fprintf(stderr, "serve: rx_frames=%lu rx_errors=%lu dup=%lu gaps=%lu records=%lu tx_frames=%lu\n",
+          (unsigned long)st.rxFrames, (unsigned long)st.rxErrors, (unsigned long)st.rxDuplicates,
+          (unsigned long)st.rxSeqGaps, (unsigned long)st.records, (unsigned long)st.txFrames);
+  hostBoard().serialFd = -1;
+  close(fd);
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  if (argc >= 3 && std::string(argv[1]) == "serve") {
+    return runServe(argv[2], argc >= 4 ? atof(argv[3]) : 30.0);
+  }
+  if (argc >= 2 && std::string(argv[1]) == "sim") {
+    hostBoard().serialEcho = false;
+    return simMain(argc - 2, argv + 2);
+  }
+
+  for (int i = 1; i < argc; i++) selected.push_back(argv[i]);
+
+  hostBoard().serialEcho = false;
+
+  if (wants("face_draw"))      benchFaceDraw();
+  if (wants("atlas"))          benchAtlas();
+  if (wants("bomb_scene"))     benchBombScene();
+  if (wants("fsm_update"))     benchFsmUpdate();
+  if (wants("handle_command")) benchHandleCommand();
+  if (wants("range_filter"))   benchRangeFilter();
+  if (wants("protocol"))       benchProtocol();
+  if (wants("sound"))          benchSound();
+  if (wants("motor_ramp"))     benchMotorRamp();
+  if (wants("wheel_speed"))    benchWheelSpeed();
+  if (wants("queue"))          benchQueue();
+  if (wants("timeline"))       benchTimeline();
+  if (wants("compositor"))     benchCompositor();
+  if (wants("avoid_sim"))      benchAvoidSim();
+  if (wants("recorder"))       benchRecorder();
+  if (wants("scheduler"))      benchScheduler();
+  if (wants("power"))          benchPower();
+  if (wants("params"))         benchParams();
+  if (wants("boot"))           benchBoot();
+  if (wants("mem"))            benchMem();
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,497 @@
+#!/usr/bin/env python3
+"""
+@file enic_link.py
+@authors Sertac ALAN & Kaan GUNER
+@brief Host-side reference codec for the ENIC binary UART protocol (include/EnicProtocol.h)
+@version 1.0
+@date 2026-02-10
+@copyright Copyright (c) 2026
+
+Kullanim:
+  enic_link.py monitor --port /dev/ttyUSB0            # telemetri + metin ciktisi
+  enic_link.py send --port /dev/ttyUSB0 drive 150 150 800
+  enic_link.py bench                                  # pty loopback (sadece host kodek)
+  enic_link.py bench --firmware .pio/build/native/program   # pty uzerinden native firmware
+  enic_link.py boot --port /dev/ttyUSB0 --runs 20     # RTS ile reset, acilis fazlari (p50/p95/max)
+
+Gercek port icin pyserial gerekir; bench sadece standart kutuphane kullanir.
+"""
+import argparse
+import json
+import os
+import select
+import struct
+import subprocess
+import sys
+import threading
+import time
+
+DELIM = 0x00
+
+MSG_CMD = 0x01
+MSG_ACK = 0x81
+MSG_TELEMETRY = 0x82
+MSG_LOG = 0x83        # ucus kaydi dokumu (tools/enic_log.py)
+MSG_LOG_END = 0x84
+
+ACK_OK, ACK_DUPLICATE, ACK_BAD_RECORD, ACK_BUSY = 0, 1, 2, 3
+
+OP_DRIVE = 0x01
+OP_FACE = 0x02
+OP_SOUND = 0x03
+OP_MODE = 0x04
+OP_PING = 0x05
+OP_TELEMETRY = 0x06
+
+MODES = {"stop": 0, "auto": 1, "dance": 2, "bomb": 3}
+FACES = ["NORMAL", "BLINK", "DEAD", "TONGUE", "LISTEN", "SPEAK", "SHOCK", "SNEAKY", "CRY", "FEAR"]
+STATES = ["IDLE", "MANUAL", "MANUAL_OBSTACLE", "AUTO", "AVOIDING", "DANCE", "BOMB"]
+
+TELEMETRY_FMT = "<IBBHhHhhhhHHHH"   # ProtoTelemetry, 28 bayt
+U16_NONE = 0xFFFF
+
+
+# ---------------- CRC-16/CCITT-FALSE ----------------
+def _crc_table():
+    t = []
+    for i in range(256):
+        c = i << 8
+        for _ in range(8):
+            c = ((c << 1) ^ 0x1021) if c & 0x8000 else (c << 1)
+        t.append(c & 0xFFFF)
+    return t
+
+
+_CRC = _crc_table()
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for b in data:
+        crc = ((crc << 8) & 0xFFFF) ^ _CRC[(crc >> 8) ^ b]
+    return crc
+
+
+# ---------------- COBS ----------------
+def cobs_encode(data):
+    out = bytearray([0])
+    code_at, code = 0, 1
+    for b in data:
+        if b == 0:
+            out[code_at] = code
+            code_at, code = len(out), 1
+            out.append(0)
+        else:
+            out.append(b)
+            code += 1
+            if code == 0xFF:
+                out[code_at] = code
+                code_at, code = len(out), 1
+                out.append(0)
+    out[code_at] = code
+    return bytes(out)
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        i += 1
+        if code == 0 or i + code - 1 > len(data):
+            raise ValueError("bad COBS")
+        out += data[i:i + code - 1]
+        i += code - 1
+        if code < 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+# ---------------- Frames ----------------
+def build_frame(msg_type, seq, body=b""):
+    raw = bytes([msg_type, seq & 0xFF]) + bytes(body)
+    raw += struct.pack("<H", crc16(raw))
+    return bytes([DELIM]) + cobs_encode(raw) + bytes([DELIM])
+
+
+def parse_frame(cobs_bytes):
+    """COBS govdesi (ayracsiz) -> (type, seq, body); CRC hatasinda ValueError."""
+    raw = cobs_decode(cobs_bytes)
+    if len(raw) < 4:
+        raise ValueError("short frame")
+    if struct.unpack("<H", raw[-2:])[0] != crc16(raw[:-2]):
+        raise ValueError("bad CRC")
+    return raw[0], raw[1], raw[2:-2]
+
+
+def rec(op, data):
+    return bytes([op, len(data)]) + data
+
+
+def rec_drive(left, right, ms=0):
+    return rec(OP_DRIVE, struct.pack("<hhH", left, right, ms))
+
+
+def rec_face(face, ms, sound=0):
+    if isinstance(face, str):
+        face = FACES.index(face.upper())
+    return rec(OP_FACE, struct.pack("<BHB", face, ms, sound))
+
+
+def rec_sound(effect):
+    return rec(OP_SOUND, bytes([effect]))
+
+
+def rec_mode(mode):
+    return rec(OP_MODE, bytes([MODES[mode] if isinstance(mode, str) else mode]))
+
+
+def rec_ping(ms):
+    return rec(OP_PING, struct.pack("<H", ms))
+
+
+def rec_telemetry(period_ms):
+    return rec(OP_TELEMETRY, struct.pack("<H", period_ms))
+
+
+def decode_telemetry(body):
+    f = struct.unpack(TELEMETRY_FMT, body[:struct.calcsize(TELEMETRY_FMT)])
+    keys = ["t_ms", "state", "flags", "dist_mm", "closing_mm_s", "ttc_ms",
+            "target_left", "target_right", "current_left", "current_right",
+            "loop_avg_us", "loop_max_us", "rx_frames", "rx_errors"]
+    d = dict(zip(keys, f))
+    d["state_name"] = STATES[d["state"]] if d["state"] < len(STATES) else str(d["state"])
+    d["dist_cm"] = None if d["dist_mm"] == U16_NONE else d["dist_mm"] / 10.0
+    d["ttc_s"] = None if d["ttc_ms"] == U16_NONE else d["ttc_ms"] / 1000.0
+    return d
+
+
+class Demux:
+    """Robot -> host akisi: metin satirlari ve binary cerceveler (firmware ile ayni kural)."""
+
+    def __init__(self):
+        self.in_frame = False
+        self.frame = bytearray()
+        self.text = bytearray()
+        self.errors = 0
+
+    def feed(self, data):
+        """(kind, value) listesi: ("text", str) veya ("frame", (type, seq, body))."""
+        out = []
+        for b in data:
+            if b == DELIM:
+                if not self.in_frame:
+                    self.in_frame = True
+                elif self.frame:
+                    try:
+                        out.append(("frame", parse_frame(bytes(self.frame))))
+                    except ValueError:
+                        self.errors += 1
+                    self.frame.clear()
+                    self.in_frame = False
+            elif self.in_frame:
+                self.frame.append(b)
+            elif b == 0x0A:
+                out.append(("text", self.text.decode("utf-8", "replace").rstrip("\r")))
+                self.text.clear()
+            else:
+                self.text.append(b)
+        return out
+
+
+# ---------------- Transport ----------------
+class FdPort:
+    def __init__(self, fd):
+        self.fd = fd
+
+    def write(self, data):
+        view = memoryview(data)
+        while view:
+            n = os.write(self.fd, view)
+            view = view[n:]
+
+    def read(self, timeout):
+        r, _, _ = select.select([self.fd], [], [], timeout)
+        if not r:
+            return b""
+        try:
+            return os.read(self.fd, 4096)
+        except OSError:
+            return b""
+
+
+class SerialPort:
+    def __init__(self, port, baud):
+        import serial  # pyserial
+        self.s = serial.Serial(port, baud, timeout=0)
+
+    def write(self, data):
+        self.s.write(data)
+
+    def read(self, timeout):
+        end = time.monotonic() + timeout
+        while True:
+            data = self.s.read(4096)
+            if data or time.monotonic() >= end:
+                return data
+            time.sleep(0.0005)
+
+    def reset(self):
+        """Otomatik reset devresi: RTS -> EN, DTR birakili (IO0 yuksek, normal acilis)."""
+        self.s.dtr = False
+        self.s.rts = True
+        time.sleep(0.1)
+        self.s.reset_input_buffer()
+        self.s.rts = False
+
+
+def open_pty_raw():
+    import pty
+    import tty
+    master, slave = pty.openpty()
+    tty.setraw(master)
+    tty.setraw(slave)
+    return master, slave
+
+
+# ---------------- Bench ----------------
+def _percentile(xs, p):
+    if not xs:
+        return 0.0
+    xs = sorted(xs)
+    return xs[min(len(xs) - 1, int(p / 100.0 * len(xs)))]
+
+
+def _loopback_responder(fd, stop):
+    """Firmware yoksa: pty'nin diger ucunda MSG_CMD cercevelerine ACK donen referans robot."""
+    port = FdPort(fd)
+    dmx = Demux()
+    while not stop.is_set():
+        data = port.read(0.05)
+        for kind, val in dmx.feed(data):
+            if kind == "frame" and val[0] == MSG_CMD:
+                body, n, applied = val[2], 0, 0
+                while n + 2 <= len(body):
+                    n += 2 + body[n + 1]
+                    applied += 1
+                port.write(build_frame(MSG_ACK, val[1], bytes([val[1], ACK_OK, applied])))
+
+
+def bench(args):
+    master, slave = open_pty_raw()
+    slave_path = os.ttyname(slave)
+    port = FdPort(master)
+    proc = None
+    stop = threading.Event()
+
+    if args.firmware:
+        os.close(slave)
+        proc = subprocess.Popen([args.firmware, "serve", slave_path, str(args.seconds + 5)],
+                                stdout=subprocess.DEVNULL)
+        time.sleep(0.3)
+        target = "firmware"
+    else:
+        threading.Thread(target=_loopback_responder, args=(slave, stop), daemon=True).start()
+        target = "loopback"
+
+    dmx = Demux()
+    telemetry = []
+
+    def wait_ack(seq, timeout=1.0):
+        end = time.monotonic() + timeout
+        while time.monotonic() < end:
+            for kind, val in dmx.feed(port.read(0.01)):
+                if kind != "frame":
+                    continue
+                if val[0] == MSG_ACK and val[2][0] == seq:
+                    return val[2]
+                if val[0] == MSG_TELEMETRY:
+                    telemetry.append((time.monotonic(), decode_telemetry(val[2])))
+        return None
+
+    results = []
+
+    # 1) Gecikme: tek kayitli cerceve, ACK'e kadar tur suresi
+    seq, rtts, lost = 0, [], 0
+    for _ in range(args.frames):
+        seq = (seq + 1) & 0xFF
+        t0 = time.perf_counter()
+        port.write(build_frame(MSG_CMD, seq, rec_drive(120, 120, 500)))
+        if wait_ack(seq) is None:
+            lost += 1
+        else:
+            rtts.append((time.perf_counter() - t0) * 1e6)
+    results.append({"suite": "link", "target": target, "case": "rtt_single",
+                    "frames": args.frames, "lost": lost,
+                    "rtt_p50_us": round(_percentile(rtts, 50), 1),
+                    "rtt_p99_us": round(_percentile(rtts, 99), 1)})
+
+    # 2) Throughput: pencereli gonderim, cerceve basina args.batch kayit
+    body = b"".join(rec_drive(100 + i, 100 - i, 300) for i in range(args.batch))
+    sent, acked, busy, window, inflight = 0, 0, 0, 8, []
+    t0 = time.perf_counter()
+    deadline = t0 + args.seconds
+    while time.perf_counter() < deadline:
+        while len(inflight) < window:
+            seq = (seq + 1) & 0xFF
+            port.write(build_frame(MSG_CMD, seq, body))
+            inflight.append(seq)
+            sent += 1
+        for kind, val in dmx.feed(port.read(0.01)):
+            if kind == "frame" and val[0] == MSG_ACK and val[2][0] in inflight:
+                if val[2][1] == ACK_BUSY:
+                    # komut kuyrugu dolu: ayni seq ile tekrar gonder
+                    port.write(build_frame(MSG_CMD, val[2][0], body))
+                    busy += 1
+                    continue
+                inflight.remove(val[2][0])
+                acked += 1
+    dt = time.perf_counter() - t0
+    results.append({"suite": "link", "target": target, "case": "throughput",
+                    "batch": args.batch, "frames_acked": acked,
+                    "frames_per_s": round(acked / dt, 1),
+                    "cmds_per_s": round(acked * args.batch / dt, 1),
+                    "busy_retries": busy,
+                    "decode_errors": dmx.errors})
+
+    # 3) Telemetri periyodu (sadece firmware)
+    if proc:
+        telemetry.clear()
+        seq = (seq + 1) & 0xFF
+        port.write(build_frame(MSG_CMD, seq, rec_telemetry(20)))
+        wait_ack(seq)
+        end = time.monotonic() + 1.0
+        while time.monotonic() < end:
+            for kind, val in dmx.feed(port.read(0.01)):
+                if kind == "frame" and val[0] == MSG_TELEMETRY:
+                    telemetry.append((time.monotonic(), decode_telemetry(val[2])))
+        gaps = [(b[0] - a[0]) * 1e3 for a, b in zip(telemetry, telemetry[1:])]
+        results.append({"suite": "link", "target": target, "case": "telemetry_20ms",
+                        "frames": len(telemetry),
+                        "period_p50_ms": round(_percentile(gaps, 50), 2),
+                        "period_p99_ms": round(_percentile(gaps, 99), 2),
+                        "last": telemetry[-1][1] if telemetry else None})
+
+    stop.set()
+    if proc:
+        os.close(master)
+        proc.wait(timeout=10)
+    for r in results:
+        print(json.dumps(r))
+
+
+# ---------------- CLI ----------------
+def monitor(args):
+    port = SerialPort(args.port, args.baud)
+    if args.telemetry:
+        port.write(build_frame(MSG_CMD, 1, rec_telemetry(args.telemetry)))
+    dmx = Demux()
+    while True:
+        for kind, val in dmx.feed(port.read(0.1)):
+            if kind == "text":
+                print(val)
+            elif val[0] == MSG_TELEMETRY:
+                print(json.dumps(decode_telemetry(val[2])))
+            elif val[0] == MSG_ACK:
+                print("ack seq=%d status=%d applied=%d" % (val[2][0], val[2][1], val[2][2]))
+
+
+def boot(args):
+    """Karti tekrar tekrar resetleyip {"boot":...} satirini toplar; faz basina yuzdelikler."""
+    port = SerialPort(args.port, args.baud)
+    keys = ("first_frame_ms", "control_ready_ms", "setup_to_control_ms")
+    phases = ("setup", "motors_safe", "serial", "core_ready", "first_frame", "control_ready",
+              "range_ready", "log_ready")
+    samples = {k: [] for k in keys + phases}
+    missed = 0
+    for _ in range(args.runs):
+        port.reset()
+        dmx = Demux()
+        report = None
+        end = time.monotonic() + args.timeout
+        while report is None and time.monotonic() < end:
+            for kind, val in dmx.feed(port.read(0.05)):
+                if kind == "text" and val.startswith('{"boot"'):
+                    try:
+                        report = json.loads(val)
+                    except ValueError:
+                        pass
+        if report is None:
+            missed += 1
+            continue
+        for k in keys:
+            samples[k].append(report[k])
+        for ph in phases:
+            t = report["boot"].get(ph + "_us")
+            if t is not None:
+                samples[ph].append(t / 1000.0)
+    for k, xs in samples.items():
+        if xs:
+            print(json.dumps({"boot": k, "runs": len(xs), "p50_ms": round(_percentile(xs, 50), 2),
+                              "p95_ms": round(_percentile(xs, 95), 2), "max_ms": round(max(xs), 2)}))
+    print(json.dumps({"boot": "summary", "runs": args.runs, "missed": missed}))
+
+
+def send(args):
+    a = args.args
+    if a[0] == "drive":
+        body = rec_drive(int(a[1]), int(a[2]), int(a[3]) if len(a) > 3 else 0)
+    elif a[0] == "face":
+        body = rec_face(a[1], int(a[2]) if len(a) > 2 else 1500, int(a[3]) if len(a) > 3 else 0)
+    elif a[0] == "sound":
+        body = rec_sound(int(a[1]))
+    elif a[0] == "mode":
+        body = rec_mode(a[1])
+    elif a[0] == "ping":
+        body = rec_ping(int(a[1]))
+    else:
+        sys.exit("unknown record: " + a[0])
+    port = SerialPort(args.port, args.baud)
+    port.write(build_frame(MSG_CMD, args.seq, body))
+    dmx = Demux()
+    end = time.monotonic() + 1.0
+    while time.monotonic() < end:
+        for kind, val in dmx.feed(port.read(0.05)):
+            if kind == "frame" and val[0] == MSG_ACK:
+                print("ack seq=%d status=%d applied=%d" % (val[2][0], val[2][1], val[2][2]))
+                return
+    sys.exit("no ack")
+
+
+def main():
+    ap = argparse.ArgumentParser(description="ENIC binary UART protocol tool")
+    sub = ap.add_subparsers(dest="cmd", required=True)
+
+    m = sub.add_parser("monitor")
+    m.add_argument("--port", required=True)
+    m.add_argument("--baud", type=int, default=921600)
+    m.add_argument("--telemetry", type=int, default=100, help="period ms (0: don't enable)")
+    m.set_defaults(fn=monitor)
+
+    s = sub.add_parser("send")
+    s.add_argument("--port", required=True)
+    s.add_argument("--baud", type=int, default=921600)
+    s.add_argument("--seq", type=int, default=1)
+    s.add_argument("args", nargs="+", help="drive L R [ms] | face NAME [ms] [sound] | sound N | mode stop|auto|dance|bomb | ping MS")
+    s.set_defaults(fn=send)
+
+    b = sub.add_parser("bench")
+    b.add_argument("--firmware", help="native build program (runs 'program serve <pty>')")
+    b.add_argument("--frames", type=int, default=500)
+    b.add_argument("--batch", type=int, default=4)
+    b.add_argument("--seconds", type=float, default=2.0)
+    b.set_defaults(fn=bench)
+
+    r = sub.add_parser("boot")
+    r.add_argument("--port", required=True)
+    r.add_argument("--baud", type=int, default=921600)
+    r.add_argument("--runs", type=int, default=20)
+    r.add_argument("--timeout", type=float, default=3.0, help="reset basina rapor bekleme (s)")
+    r.set_defaults(fn=boot)
+
+    args = ap.parse_args()
+    args.fn(args)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,239 @@
+#!/usr/bin/env python3
+"""
+@file enic_log.py
+@authors Sertac ALAN & Kaan GUNER
+@brief Host-side flight recorder tool: dump over serial, decode to CSV, per-state residency
+@version 1.0
+@date 2026-02-10
+@copyright Copyright (c) 2026
+
+Kayit duzeni include/EnicRecorder.h ile ayni olmali (LogRecord, 12 bayt, little-endian).
+
+Kullanim:
+  enic_log.py dump --port /dev/ttyUSB0 -o flight.bin     # "log 1" gonder, MSG_LOG cercevelerini topla
+  enic_log.py dump --firmware .pio/build/native/program --seconds 5 -o flight.bin   # pty + native firmware
+  enic_log.py csv flight.bin -o flight.csv
+  enic_log.py residency flight.bin                      # durum basina sure (JSON Lines)
+"""
+import argparse
+import csv
+import json
+import os
+import struct
+import subprocess
+import sys
+import time
+
+from enic_link import (Demux, FdPort, SerialPort, open_pty_raw, STATES,
+                       MSG_LOG, MSG_LOG_END)
+
+RECORD_FMT = "<IBBhhh"
+RECORD_LEN = struct.calcsize(RECORD_FMT)   # 12
+
+LOG_BOOT, LOG_STATE, LOG_CMD, LOG_RANGE, LOG_MOTOR, LOG_OVERRUN = range(6)
+TYPES = ["boot", "state", "cmd", "range", "motor", "overrun"]
+
+# CommandId sirasiyla (include/EnicCommand.h)
+COMMANDS = ["dur", "otonom", "gez", "dans", "bomb", "konus", "dinle", "sasir", "kork", "agla", "dil",
+            "ileri", "geri", "sol", "sag", "ping", "gov", "oled", "stats", "queues", "log", "sched", "pwr",
+            "get", "set", "dump", "boot", "mem"]
+OPS = {0x01: "OP_DRIVE", 0x02: "OP_FACE", 0x03: "OP_SOUND", 0x04: "OP_MODE", 0x05: "OP_PING"}
+
+# esp_reset_reason_t
+RESET_REASONS = ["unknown", "poweron", "ext", "sw", "panic", "int_wdt", "task_wdt", "wdt",
+                 "deepsleep", "brownout", "sdio"]
+
+
+def _name(table, i):
+    return table[i] if 0 <= i < len(table) else str(i)
+
+
+def parse_records(data):
+    """Ham kayit baytlari -> (t_ms, type, a, v0, v1, v2) listesi."""
+    n = len(data) // RECORD_LEN
+    return [struct.unpack_from(RECORD_FMT, data, i * RECORD_LEN) for i in range(n)]
+
+
+def describe(rec):
+    t, typ, a, v0, v1, v2 = rec
+    if typ == LOG_BOOT:
+        return "boot reset=%s format=%d" % (_name(RESET_REASONS, a), v0)
+    if typ == LOG_STATE:
+        return "%s -> %s" % (_name(STATES, v0), _name(STATES, a))
+    if typ == LOG_CMD:
+        if a & 0x80:
+            return "%s %d %d %d" % (OPS.get(a & 0x7F, "op%d" % (a & 0x7F)), v0, v1, v2)
+        return "%s %d %d %d" % (_name(COMMANDS, a), v0, v1, v2)
+    if typ == LOG_RANGE:
+        dist = "%.1f" % (v0 / 10.0) if a & 1 else "-"
+        raw = "%.1f" % (v2 / 10.0) if a & 2 else "no_echo"
+        return "dist_cm=%s closing_cm_s=%.1f raw_cm=%s" % (dist, v1 / 10.0, raw)
+    if typ == LOG_MOTOR:
+        return "target=%d,%d cap=%d%s" % (v0, v1, v2, " emergency" if a else "")
+    if typ == LOG_OVERRUN:
+        return "period_ms=%.1f step_ms=%.1f" % (v0 / 10.0, v1 / 10.0)
+    return ""
+
+
+def segments(records):
+    """Acilis kayitlarina gore bol; her parcada 32-bit ms sarmasi acilir."""
+    out, cur, base, last = [], None, 0, None
+    for r in records:
+        if r[1] == LOG_BOOT or cur is None:
+            cur, base, last = [], 0, None
+            out.append(cur)
+        t = r[0] + base
+        if last is not None and t < last - 0x80000000:
+            base += 1 << 32
+            t += 1 << 32
+        last = t
+        cur.append((t,) + tuple(r[1:]))
+    return out
+
+
+def residency(records):
+    """Durum basina toplam / ortalama / en uzun sure. Acilista durum IDLE."""
+    acc = {}
+    total = 0
+    overruns = 0
+    for seg in segments(records):
+        if not seg:
+            continue
+        state, since = 0, seg[0][0]
+        for r in seg:
+            if r[1] == LOG_OVERRUN:
+                overruns += 1
+            if r[1] != LOG_STATE:
+                continue
+            d = acc.setdefault(state, [0, 0, 0])
+            dt = r[0] - since
+            d[0] += dt
+            d[1] += 1
+            d[2] = max(d[2], dt)
+            state, since = r[2], r[0]
+        d = acc.setdefault(state, [0, 0, 0])
+        dt = seg[-1][0] - since
+        d[0] += dt
+        d[1] += 1
+        d[2] = max(d[2], dt)
+        total += seg[-1][0] - seg[0][0]
+
+    rows = []
+    for st in sorted(acc):
+        ms, n, longest = acc[st]
+        rows.append({"state": _name(STATES, st), "seconds": round(ms / 1000.0, 3),
+                     "pct": round(100.0 * ms / total, 1) if total else 0.0,
+                     "visits": n, "mean_s": round(ms / 1000.0 / n, 3), "max_s": round(longest / 1000.0, 3)})
+    summary = {"boots": sum(1 for r in records if r[1] == LOG_BOOT), "records": len(records),
+               "seconds": round(total / 1000.0, 3), "overruns": overruns}
+    return rows, summary
+
+
+# ---------------- Dump ----------------
+def collect(port, timeout):
+    """'log 1' gonder, MSG_LOG_END'e kadar kayitlari topla."""
+    port.write(b"log 1\n")
+    dmx = Demux()
+    data = bytearray()
+    end = None
+    last_seq = None
+    gaps = 0
+    deadline = time.monotonic() + timeout
+    while end is None and time.monotonic() < deadline:
+        for kind, val in dmx.feed(port.read(0.05)):
+            if kind != "frame":
+                continue
+            typ, seq, body = val
+            if typ == MSG_LOG:
+                if last_seq is not None and seq != (last_seq + 1) & 0xFF:
+                    gaps += 1
+                last_seq = seq
+                data += body
+            elif typ == MSG_LOG_END:
+                end = struct.unpack("<II", body[:8])
+    if end is None:
+        sys.exit("no MSG_LOG_END (timeout)")
+    n = len(data) // RECORD_LEN
+    if n != end[0] or gaps or dmx.errors:
+        print("warning: %d records, robot sent %d, seq gaps=%d, decode errors=%d"
+              % (n, end[0], gaps, dmx.errors), file=sys.stderr)
+    return bytes(data), end[1]
+
+
+def dump(args):
+    proc = None
+    if args.firmware:
+        master, slave = open_pty_raw()
+        slave_path = os.ttyname(slave)
+        os.close(slave)
+        proc = subprocess.Popen([args.firmware, "serve", slave_path, str(args.seconds + 10)],
+                                stdout=subprocess.DEVNULL)
+        time.sleep(0.3)
+        port = FdPort(master)
+        port.write(b"otonom\n")
+        time.sleep(args.seconds)
+    else:
+        port = SerialPort(args.port, args.baud)
+
+    data, dropped = collect(port, args.timeout)
+    with open(args.output, "wb") as f:
+        f.write(data)
+    print(json.dumps({"records": len(data) // RECORD_LEN, "bytes": len(data),
+                      "ring_dropped": dropped, "output": args.output}))
+
+    if proc:
+        os.close(master)
+        proc.wait(timeout=15)
+
+
+def to_csv(args):
+    with open(args.log, "rb") as f:
+        records = parse_records(f.read())
+    out = open(args.output, "w", newline="") if args.output else sys.stdout
+    w = csv.writer(out)
+    w.writerow(["t_ms", "boot", "type", "a", "v0", "v1", "v2", "text"])
+    for boot, seg in enumerate(segments(records)):
+        for r in seg:
+            w.writerow([r[0], boot, _name(TYPES, r[1]), r[2], r[3], r[4], r[5], describe(r)])
+    if args.output:
+        out.close()
+
+
+def show_residency(args):
+    with open(args.log, "rb") as f:
+        records = parse_records(f.read())
+    rows, summary = residency(records)
+    for r in rows:
+        print(json.dumps(r))
+    print(json.dumps(summary))
+
+
+def main():
+    ap = argparse.ArgumentParser(description="ENIC flight recorder tool")
+    sub = ap.add_subparsers(dest="cmd", required=True)
+
+    d = sub.add_parser("dump")
+    src = d.add_mutually_exclusive_group(required=True)
+    src.add_argument("--port")
+    src.add_argument("--firmware", help="native build program (runs 'program serve <pty>', 'otonom' first)")
+    d.add_argument("--baud", type=int, default=921600)
+    d.add_argument("--seconds", type=float, default=5.0, help="--firmware: AUTO run time before the dump")
+    d.add_argument("--timeout", type=float, default=30.0)
+    d.add_argument("-o", "--output", default="flight.bin")
+    d.set_defaults(fn=dump)
+
+    c = sub.add_parser("csv")
+    c.add_argument("log")
+    c.add_argument("-o", "--output")
+    c.set_defaults(fn=to_csv)
+
+    r = sub.add_parser("residency")
+    r.add_argument("log")
+    r.set_defaults(fn=show_residency)
+
+    args = ap.parse_args()
+    args.fn(args)
+
+
+if __name__ == "__main__":
+    main()